@@ -0,0 +1,270 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+// Automatic function instrumentation.  Code built with -finstrument-functions
+// and linked with librdkperf-autoinstr.so gets a PerfRecord for every function.
+//
+// Nodes are keyed by function address, symbol names are only looked up when a
+// report is printed (see PerfSymbols).  The allow/deny filters are matched
+// against the demangled symbol name once per function, the first time its
+// address is seen.  Each thread caches the functions it has seen, so the
+// lock is only taken for a function new to the thread and by the PerfRecord
+// of a call that is recorded.
+//
+//   RDKPERF_AUTOINSTR_ALLOW   comma separated symbol prefixes to instrument
+//   RDKPERF_AUTOINSTR_DENY    comma separated symbol prefixes to skip
+//   RDKPERF_AUTOINSTR_SAMPLE  record one in N calls of each function
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <cxxabi.h>
+#include <pthread.h>
+
+#include <new>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "rdk_perf_logging.h"
+#include "rdk_perf_scopedlock.h"
+#include "rdk_perf_process.h"
+#include "rdk_perf_record.h"
+#include "rdk_perf_symbols.h"
+
+#define NO_INSTRUMENT __attribute__((no_instrument_function))
+
+#define AUTOINSTR_MAX_DEPTH     128
+#define AUTOINSTR_CACHE_SIZE    256     // Power of 2
+#define AUTOINSTR_ALLOW_ENV     "RDKPERF_AUTOINSTR_ALLOW"
+#define AUTOINSTR_DENY_ENV      "RDKPERF_AUTOINSTR_DENY"
+#define AUTOINSTR_SAMPLE_ENV    "RDKPERF_AUTOINSTR_SAMPLE"
+
+typedef struct _AutoFunction
+{
+    std::string     name;
+    bool            bEnabled;
+    std::atomic<uint32_t> nCalls;       // Only counted when sampling
+} AutoFunction;
+
+typedef struct _AutoFrame
+{
+    PerfRecord*     pRecord;
+    alignas(PerfRecord) char storage[sizeof(PerfRecord)];
+} AutoFrame;
+
+typedef struct _AutoCached
+{
+    void*           pAddress;
+    AutoFunction*   pFunction;
+} AutoCached;
+
+// Per thread, freed with the thread
+typedef struct _AutoThread
+{
+    AutoFrame       frames[AUTOINSTR_MAX_DEPTH];
+    AutoCached      cache[AUTOINSTR_CACHE_SIZE];
+} AutoThread;
+
+typedef struct _AutoConfig
+{
+    std::vector<std::string>                allow;
+    std::vector<std::string>                deny;
+    uint32_t                                nSample;
+    std::unordered_map<void*, AutoFunction> functions;     // Entries are never erased
+} AutoConfig;
+
+static __thread bool        t_bInHook   = false;
+static __thread uint32_t    t_nDepth    = 0;
+static __thread AutoThread* t_pThread   = NULL;
+
+static std::atomic<AutoConfig*> s_pConfig(NULL);
+static pthread_key_t        s_threadKey;
+
+extern "C" {
+void __cyg_profile_func_enter(void* pFunction, void* pCaller) NO_INSTRUMENT;
+void __cyg_profile_func_exit(void* pFunction, void* pCaller) NO_INSTRUMENT;
+}
+
+static void SplitList(const char* szList, std::vector<std::string>& list) NO_INSTRUMENT;
+static void SplitList(const char* szList, std::vector<std::string>& list)
+{
+    if(szList == NULL) return;
+
+    std::string value(szList);
+    size_t nStart = 0;
+    while(nStart <= value.size()) {
+        size_t nEnd = value.find(',', nStart);
+        if(nEnd == std::string::npos) nEnd = value.size();
+        if(nEnd > nStart) {
+            list.push_back(value.substr(nStart, nEnd - nStart));
+        }
+        nStart = nEnd + 1;
+    }
+}
+
+static void FreeThread(void* pThread) NO_INSTRUMENT;
+static void FreeThread(void* pThread)
+{
+    free(pThread);
+}
+
+static AutoConfig* GetConfig() NO_INSTRUMENT;
+static AutoConfig* GetConfig()
+{
+    AutoConfig* pConfig = s_pConfig.load(std::memory_order_acquire);
+    if(pConfig != NULL) {
+        return pConfig;
+    }
+
+    SCOPED_LOCK();
+    pConfig = s_pConfig.load(std::memory_order_relaxed);
+    if(pConfig == NULL) {
+        pConfig = new AutoConfig();
+        SplitList(getenv(AUTOINSTR_ALLOW_ENV), pConfig->allow);
+        SplitList(getenv(AUTOINSTR_DENY_ENV), pConfig->deny);
+        const char* szSample = getenv(AUTOINSTR_SAMPLE_ENV);
+        pConfig->nSample = (szSample != NULL) ? (uint32_t)atoi(szSample) : 1;
+        if(pConfig->nSample == 0) pConfig->nSample = 1;
+        pthread_key_create(&s_threadKey, FreeThread);
+
+        LOG(eWarning, "Automatic instrumentation enabled, %d allow, %d deny filters, sampling 1 in %u\n",
+            (int)pConfig->allow.size(), (int)pConfig->deny.size(), pConfig->nSample);
+        s_pConfig.store(pConfig, std::memory_order_release);
+    }
+    return pConfig;
+}
+
+static bool MatchesPrefix(const std::vector<std::string>& list, const char* szSymbol) NO_INSTRUMENT;
+static bool MatchesPrefix(const std::vector<std::string>& list, const char* szSymbol)
+{
+    for(auto it = list.begin(); it != list.end(); it++) {
+        if(strncmp(szSymbol, it->c_str(), it->size()) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool IsFunctionEnabled(AutoConfig* pConfig, void* pFunction) NO_INSTRUMENT;
+static bool IsFunctionEnabled(AutoConfig* pConfig, void* pFunction)
+{
+    if(pConfig->allow.empty() && pConfig->deny.empty()) {
+        // No filter, no need to look at the symbol
+        return true;
+    }
+
+    Dl_info info;
+    memset(&info, 0, sizeof(info));
+    if(dladdr(pFunction, &info) == 0 || info.dli_sname == NULL) {
+        // Unknown symbols are only instrumented when there is no allow list
+        return pConfig->allow.empty();
+    }
+
+    int     status = 0;
+    char*   szDemangled = abi::__cxa_demangle(info.dli_sname, NULL, NULL, &status);
+    const char* szSymbol = (status == 0 && szDemangled != NULL) ? szDemangled : info.dli_sname;
+
+    bool bEnabled = !MatchesPrefix(pConfig->deny, szSymbol);
+    if(bEnabled && !pConfig->allow.empty()) {
+        bEnabled = MatchesPrefix(pConfig->allow, szSymbol);
+    }
+    free(szDemangled);
+
+    return bEnabled;
+}
+
+static AutoFunction* GetFunction(AutoConfig* pConfig, AutoThread* pThread, void* pFunction) NO_INSTRUMENT;
+static AutoFunction* GetFunction(AutoConfig* pConfig, AutoThread* pThread, void* pFunction)
+{
+    AutoCached& cached = pThread->cache[((uintptr_t)pFunction >> 4) & (AUTOINSTR_CACHE_SIZE - 1)];
+    if(cached.pAddress == pFunction) {
+        return cached.pFunction;
+    }
+
+    SCOPED_LOCK();
+    auto it = pConfig->functions.find(pFunction);
+    if(it == pConfig->functions.end()) {
+        AutoFunction& function = pConfig->functions[pFunction];
+        function.name       = PerfSymbols::AddressName(pFunction);
+        function.bEnabled   = IsFunctionEnabled(pConfig, pFunction);
+        function.nCalls.store(0, std::memory_order_relaxed);
+        it = pConfig->functions.find(pFunction);
+    }
+
+    cached.pAddress     = pFunction;
+    cached.pFunction    = &it->second;
+    return cached.pFunction;
+}
+
+void __cyg_profile_func_enter(void* pFunction, void* pCaller)
+{
+    if(t_bInHook) {
+        // Instrumented code called from inside the library itself
+        return;
+    }
+    t_bInHook = true;
+
+    uint32_t nDepth = t_nDepth++;
+    if(nDepth < AUTOINSTR_MAX_DEPTH && !RDKPerf_MapClosed()) {
+        AutoConfig* pConfig = GetConfig();
+        if(t_pThread == NULL) {
+            t_pThread = (AutoThread*)calloc(1, sizeof(AutoThread));
+            pthread_setspecific(s_threadKey, t_pThread);
+        }
+
+        if(t_pThread != NULL) {
+            AutoFrame*      pFrame      = &t_pThread->frames[nDepth];
+            AutoFunction*   pFunction_  = GetFunction(pConfig, t_pThread, pFunction);
+
+            pFrame->pRecord = NULL;
+            if(pFunction_->bEnabled &&
+               (pConfig->nSample == 1 || (pFunction_->nCalls.fetch_add(1, std::memory_order_relaxed) % pConfig->nSample) == 0)) {
+                // Takes the lock itself
+                pFrame->pRecord = new (pFrame->storage) PerfRecord(pFunction_->name);
+            }
+        }
+    }
+
+    t_bInHook = false;
+}
+
+void __cyg_profile_func_exit(void* pFunction, void* pCaller)
+{
+    if(t_bInHook || t_nDepth == 0) {
+        return;
+    }
+    t_bInHook = true;
+
+    uint32_t nDepth = --t_nDepth;
+    if(nDepth < AUTOINSTR_MAX_DEPTH && t_pThread != NULL) {
+        AutoFrame* pFrame = &t_pThread->frames[nDepth];
+        if(pFrame->pRecord != NULL) {
+            pFrame->pRecord->~PerfRecord();
+            pFrame->pRecord = NULL;
+        }
+    }
+
+    t_bInHook = false;
+}
@@ -0,0 +1,83 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "rdk_perf_control.h"
+
+static void Usage(const char* szProgram)
+{
+    fprintf(stderr, "Usage: %s status\n", szProgram);
+    fprintf(stderr, "       %s enable | disable\n", szProgram);
+    fprintf(stderr, "       %s enable-name <name> | disable-name <name>\n", szProgram);
+    fprintf(stderr, "       %s clear\n", szProgram);
+    fprintf(stderr, "A name ending in '*' matches every scope that starts with it\n");
+    exit(-1);
+}
+
+static void Status()
+{
+    printf("Instrumentation %s (%s control block)\n",
+           PerfControl::IsGloballyEnabled() ? "enabled" : "disabled",
+           PerfControl::IsShared() ? "shared" : "private");
+
+    std::vector<std::string> names = PerfControl::GetDisabledNames();
+    for(auto it = names.begin(); it != names.end(); it++) {
+        printf("  disabled: %s\n", it->c_str());
+    }
+}
+
+// Changes the control block shared by all processes using rdkperf, the
+// change is seen by the next scope each process opens
+int main(int argc, char *argv[])
+{
+    if(argc < 2) {
+        Usage(argv[0]);
+    }
+
+    const char* szCommand = argv[1];
+    if(strcmp(szCommand, "status") == 0) {
+        Status();
+    }
+    else if(strcmp(szCommand, "enable") == 0 || strcmp(szCommand, "disable") == 0) {
+        PerfControl::SetEnabled(strcmp(szCommand, "enable") == 0);
+        Status();
+    }
+    else if(strcmp(szCommand, "enable-name") == 0 || strcmp(szCommand, "disable-name") == 0) {
+        if(argc < 3) {
+            Usage(argv[0]);
+        }
+        if(!PerfControl::SetNameEnabled(argv[2], strcmp(szCommand, "enable-name") == 0)) {
+            return -1;
+        }
+        Status();
+    }
+    else if(strcmp(szCommand, "clear") == 0) {
+        PerfControl::ClearNames();
+        Status();
+    }
+    else {
+        Usage(argv[0]);
+    }
+
+    return 0;
+}
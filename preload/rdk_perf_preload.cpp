@@ -0,0 +1,255 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+// LD_PRELOAD interposer for blocking libc calls.  When the calling thread has
+// an open RDKPerf scope the call is timed and, if it took at least
+// RDKPERF_PRELOAD_MIN_US microseconds, recorded as a leaf node below that scope.
+//
+// With RDKPERF_PRELOAD_ALLOC=1 every malloc, calloc, realloc and free (and so
+// operator new/delete, which call them) is also counted against the innermost
+// open scope of the calling thread.
+//
+//   LD_PRELOAD=librdkperf-preload.so RDKPERF_PRELOAD_MIN_US=50 <app>
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <poll.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <malloc.h>
+#include <sys/ioctl.h>
+#include <sys/time.h>
+
+#include "rdk_perf_logging.h"
+#include "rdk_perf_record.h"
+
+#define PRELOAD_MIN_US_ENV      "RDKPERF_PRELOAD_MIN_US"
+#define PRELOAD_DEFAULT_MIN_US  10
+#define PRELOAD_ALLOC_ENV       "RDKPERF_PRELOAD_ALLOC"
+
+// Resolve the next definition of a symbol, once
+#define REAL_FUNCTION(ret, name, args) \
+    typedef ret (*RealFunction) args; \
+    static RealFunction s_real = NULL; \
+    if(s_real == NULL) s_real = (RealFunction)dlsym(RTLD_NEXT, name);
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t nmemb, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void  __libc_free(void* ptr);
+}
+
+static uint64_t         s_nMinUS        = PRELOAD_DEFAULT_MIN_US;
+static bool             s_bAlloc        = false;
+static __thread bool    t_bInHook       = false;
+
+static void __attribute__((constructor)) PreloadModuleInit();
+
+// This function is assigned to execute as a library init
+//  using __attribute__((constructor))
+static void PreloadModuleInit()
+{
+    const char* szMinUS = getenv(PRELOAD_MIN_US_ENV);
+    if(szMinUS != NULL) {
+        s_nMinUS = strtoull(szMinUS, NULL, 10);
+    }
+    const char* szAlloc = getenv(PRELOAD_ALLOC_ENV);
+    s_bAlloc = (szAlloc != NULL && atoi(szAlloc) != 0);
+    LOG(eWarning, "RDK Perf preload interposer active, minimum duration %llu us, allocation accounting %s\n",
+        s_nMinUS, s_bAlloc ? "on" : "off");
+}
+
+// Only time calls made inside an instrumented scope, and never the calls the
+// library makes itself: taking its lock, allocating nodes while holding it,
+// writing ftrace markers, or recording a leaf from one of these hooks
+static inline bool IsTracing()
+{
+    return !t_bInHook && !PerfRecord::IsInternal() && PerfRecord::Current() != NULL;
+}
+
+static inline uint64_t Now()
+{
+    struct timeval timeStamp;
+    gettimeofday(&timeStamp, NULL);
+    return ((uint64_t)timeStamp.tv_sec * 1000000) + timeStamp.tv_usec;
+}
+
+static void Record(const char* szName, uint64_t nStartTime)
+{
+    uint64_t nElapsed = Now() - nStartTime;
+    if(nElapsed >= s_nMinUS) {
+        t_bInHook = true;
+        PerfRecord::RecordLeaf(szName, nStartTime, nElapsed);
+        t_bInHook = false;
+    }
+}
+
+extern "C" {
+
+ssize_t read(int fd, void* buf, size_t count)
+{
+    REAL_FUNCTION(ssize_t, "read", (int, void*, size_t));
+    if(!IsTracing()) return s_real(fd, buf, count);
+
+    uint64_t nStartTime = Now();
+    ssize_t retVal = s_real(fd, buf, count);
+    Record("read", nStartTime);
+    return retVal;
+}
+
+ssize_t write(int fd, const void* buf, size_t count)
+{
+    REAL_FUNCTION(ssize_t, "write", (int, const void*, size_t));
+    if(!IsTracing()) return s_real(fd, buf, count);
+
+    uint64_t nStartTime = Now();
+    ssize_t retVal = s_real(fd, buf, count);
+    Record("write", nStartTime);
+    return retVal;
+}
+
+int poll(struct pollfd* fds, nfds_t nfds, int timeout)
+{
+    REAL_FUNCTION(int, "poll", (struct pollfd*, nfds_t, int));
+    if(!IsTracing()) return s_real(fds, nfds, timeout);
+
+    uint64_t nStartTime = Now();
+    int retVal = s_real(fds, nfds, timeout);
+    Record("poll", nStartTime);
+    return retVal;
+}
+
+int ioctl(int fd, unsigned long request, ...)
+{
+    REAL_FUNCTION(int, "ioctl", (int, unsigned long, void*));
+
+    va_list args;
+    va_start(args, request);
+    void* argp = va_arg(args, void*);
+    va_end(args);
+
+    if(!IsTracing()) return s_real(fd, request, argp);
+
+    uint64_t nStartTime = Now();
+    int retVal = s_real(fd, request, argp);
+    Record("ioctl", nStartTime);
+    return retVal;
+}
+
+int usleep(useconds_t usec)
+{
+    REAL_FUNCTION(int, "usleep", (useconds_t));
+    if(!IsTracing()) return s_real(usec);
+
+    uint64_t nStartTime = Now();
+    int retVal = s_real(usec);
+    Record("usleep", nStartTime);
+    return retVal;
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    REAL_FUNCTION(int, "pthread_mutex_lock", (pthread_mutex_t*));
+    if(!IsTracing()) return s_real(mutex);
+
+    uint64_t nStartTime = Now();
+    int retVal = s_real(mutex);
+    Record("pthread_mutex_lock", nStartTime);
+    return retVal;
+}
+
+int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex)
+{
+    // dlsym() returns the oldest version of pthread_cond_wait on some
+    // architectures, ask for the current one explicitly
+    static int (*s_real)(pthread_cond_t*, pthread_mutex_t*) = NULL;
+    if(s_real == NULL) {
+        s_real = (int (*)(pthread_cond_t*, pthread_mutex_t*))dlvsym(RTLD_NEXT, "pthread_cond_wait", "GLIBC_2.3.2");
+        if(s_real == NULL) {
+            s_real = (int (*)(pthread_cond_t*, pthread_mutex_t*))dlsym(RTLD_NEXT, "pthread_cond_wait");
+        }
+    }
+    if(!IsTracing()) return s_real(cond, mutex);
+
+    uint64_t nStartTime = Now();
+    int retVal = s_real(cond, mutex);
+    Record("pthread_cond_wait", nStartTime);
+    return retVal;
+}
+
+// The allocator functions use the glibc internal entry points, dlsym() itself allocates
+void* malloc(size_t size)
+{
+    if(!IsTracing()) return __libc_malloc(size);
+
+    uint64_t nStartTime = Now();
+    void* retVal = __libc_malloc(size);
+    Record("malloc", nStartTime);
+    if(s_bAlloc && retVal != NULL) PerfRecord::NoteAlloc(malloc_usable_size(retVal));
+    return retVal;
+}
+
+void* calloc(size_t nmemb, size_t size)
+{
+    if(!IsTracing()) return __libc_calloc(nmemb, size);
+
+    uint64_t nStartTime = Now();
+    void* retVal = __libc_calloc(nmemb, size);
+    Record("calloc", nStartTime);
+    if(s_bAlloc && retVal != NULL) PerfRecord::NoteAlloc(malloc_usable_size(retVal));
+    return retVal;
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    if(!IsTracing()) return __libc_realloc(ptr, size);
+
+    size_t nOldSize = (s_bAlloc && ptr != NULL) ? malloc_usable_size(ptr) : 0;
+    uint64_t nStartTime = Now();
+    void* retVal = __libc_realloc(ptr, size);
+    Record("realloc", nStartTime);
+    if(s_bAlloc) {
+        // Counted as a free of the old block and an allocation of the new one
+        if(ptr != NULL) PerfRecord::NoteFree(nOldSize);
+        if(retVal != NULL) PerfRecord::NoteAlloc(malloc_usable_size(retVal));
+    }
+    return retVal;
+}
+
+void free(void* ptr)
+{
+    if(!IsTracing()) {
+        __libc_free(ptr);
+        return;
+    }
+
+    if(s_bAlloc && ptr != NULL) PerfRecord::NoteFree(malloc_usable_size(ptr));
+    uint64_t nStartTime = Now();
+    __libc_free(ptr);
+    Record("free", nStartTime);
+}
+
+} // extern "C"
@@ -20,6 +20,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <dlfcn.h>
+#include <errno.h>
 
 #include <string>
 #include <map>
@@ -29,20 +30,36 @@
 #include <ratio>
 #include <chrono>
 #include <condition_variable>
+#include <atomic>
 
 #include "rdk_perf_logging.h"
 #include "rdk_perf_scopedlock.h"
 #include "rdk_perf_msgqueue.h"
 #include "rdk_perf_process.h"
+#include "rdk_perf_async.h"
+#include "rdk_perf_node.h"
+#include "rdk_perf_cadence.h"
+#include "rdk_perf_lock.h"
+#include "rdk_perf_ftrace.h"
+#include "rdk_perf_control.h"
+#include "rdk_perf_config.h"
+#include "rdk_perf_eventlog.h"
+#include "rdk_perf_breach.h"
 #include "rdk_perf_tree.h"  // Needs to come after rdk_perf_process because of forward declaration of PerfTree
 #include "rdk_perf.h"
 
 #include <unistd.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
 
 #define REPORTING_INITIAL_COUNT 5000
 #define REPORTING_INTERVAL_COUNT 20000
 #define TIMER_INTERVAL_SECONDS 10
-#define MAX_DELAY 600
+#define REPORT_SIGNAL_ENV "RDKPERF_REPORT_SIGNAL"
 
 
 #ifdef PERF_REMOTE
@@ -52,133 +69,281 @@ static PerfMsgQueue* s_pQueue = NULL;
 static void __attribute__((constructor)) PerfModuleInit();
 static void __attribute__((destructor)) PerfModuleTerminate();
 
+// SIGUSR2 with RDKPERF_REPORT_SIGNAL=1 wakes the report thread through its
+// eventfd.  The handler is installed at load for the whole process, so it
+// does not matter which thread gets the signal or when the library was
+// loaded.
+static std::atomic<int>     s_nReportFd(-1);
+static std::atomic<pid_t>   s_nReportPid(0);    // The eventfd belongs to this process
+static std::atomic<int>     s_nSignalSender(0); // Of a report not taken yet, -1 when unknown
+
+static void PerfReportSignal(int nSignal, siginfo_t* pInfo, void* pContext)
+{
+    // Only async signal safe calls
+    int nErrno = errno;
+    int fd     = s_nReportFd.load();
+    if(fd >= 0 && s_nReportPid.load() == getpid()) {
+        s_nSignalSender.store((pInfo != NULL && pInfo->si_pid != 0) ? (int)pInfo->si_pid : -1);
+        uint64_t nValue = 1;
+        if(write(fd, &nValue, sizeof(nValue)) != sizeof(nValue)) {
+            // Already woken up
+        }
+    }
+    errno = nErrno;
+}
+
+// Report thread.  Reports on the schedule from the configuration file and
+// on demand, from RDKPerfReportNow(), SIGUSR2 (RDKPERF_REPORT_SIGNAL=1) or
+// touching the report_trigger file.  Runs at the lowest priority so that
+// reporting does not compete with the instrumented threads.
 class TimerCallback {
 public:
-    enum SignalResult {
-        WAITING     = 0,
-        TIMEOUT     = 1,
-        EXIT_LOOP   = 2
-    };
-
     TimerCallback (void* pContext) 
     : m_Context(pContext)
-    , m_bContinue(false)
-    , m_nDelay(0)
-    , m_nCount(0)
-    , m_current_state(WAITING)
+    , m_bContinue(true)
+    , m_bReportNow(false)
+    , m_nConfigGeneration(0)
+    , m_triggerFd(-1)
+    , m_nNextSnapshot(0)
     {
+        memset(&m_history, 0, sizeof(m_history));
+        m_wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        PerfReportScheduler::Default(&m_schedule);
         LOG(eWarning, "Timer Created\n");
     };
     
     ~TimerCallback() {
+        if(m_wakeFd >= 0) close(m_wakeFd);
+        if(m_triggerFd >= 0) close(m_triggerFd);
         LOG(eWarning, "Timer destroyed\n");
     }; 
 
-    void Signal (TimerCallback::SignalResult value)
+    void Wake()
+    {
+        uint64_t nValue = 1;
+        if(write(m_wakeFd, &nValue, sizeof(nValue)) != sizeof(nValue)) {
+            LOG(eError, "Could not wake the report thread\n");
+        }
+    }
+
+    void ReportNow()
     {
-        std::unique_lock<std::mutex> lck(m_mtx);
-        m_current_state = value;
-        m_cv.notify_one();
-        lck.unlock();
+        m_bReportNow = true;
+        Wake();
     }
 
-    SignalResult Wait(unsigned int time_in_seconds)
+    int GetWakeFd() { return m_wakeFd; };
+
+    // Returns true when a report was requested before the timeout
+    bool Wait(int nTimeoutMS)
     {
-        TimerCallback::SignalResult result;
-        std::chrono::milliseconds ms(time_in_seconds * 1000);
+        struct pollfd   fds[2];
+        nfds_t          nFds = 0;
 
-        std::unique_lock<std::mutex> lck(m_mtx);
+        fds[nFds].fd = m_wakeFd;    fds[nFds++].events = POLLIN;
+        if(m_triggerFd >= 0) {
+            fds[nFds].fd = m_triggerFd; fds[nFds++].events = POLLIN;
+        }
+        if(poll(fds, nFds, nTimeoutMS) <= 0) {
+            return false;
+        }
 
-        if(m_current_state == WAITING) {
-            if(m_cv.wait_for(lck, ms) == std::cv_status::timeout) {
-                result = TIMEOUT;
+        bool bRequested = false;
+        for(nfds_t nIdx = 0; nIdx < nFds; nIdx++) {
+            if((fds[nIdx].revents & POLLIN) == 0) continue;
+
+            if(fds[nIdx].fd == m_wakeFd) {
+                uint64_t nValue;
+                if(read(m_wakeFd, &nValue, sizeof(nValue)) > 0) {
+                    if(m_bReportNow.exchange(false)) {
+                        bRequested = true;
+                    }
+                    int nSender = s_nSignalSender.exchange(0);
+                    if(nSender != 0) {
+                        LOG(eWarning, "Report requested by signal from pid %d\n", nSender);
+                        bRequested = true;
+                    }
+                }
             }
             else {
-                result = m_current_state;
+                alignas(struct inotify_event) char buffer[1024];
+                ssize_t nSize;
+                while((nSize = read(m_triggerFd, buffer, sizeof(buffer))) > 0) {
+                    for(char* ptr = buffer; ptr < buffer + nSize; ) {
+                        struct inotify_event* pEvent = (struct inotify_event*)ptr;
+                        if(pEvent->len > 0 && m_triggerName == pEvent->name) {
+                            bRequested = true;
+                        }
+                        ptr += sizeof(struct inotify_event) + pEvent->len;
+                    }
+                }
+                if(bRequested) {
+                    LOG(eWarning, "Report requested by %s\n", m_schedule.szTrigger);
+                }
             }
         }
-        else {
-            // State change before the lock was called
-            result = m_current_state;
-        }
-        m_current_state = WAITING;
-
-        lck.unlock();
-
-        return result;
+        return bRequested;
     }
 
     void StopTask() {
         LOG(eWarning, "Stoping Timer Task\n");
         m_bContinue = false;
-        Signal(EXIT_LOOP);
+        Wake();
         return;
     };
 
-    bool Loop() {
-        bool bTimerContinue = true;
- 
-        LOG(eTrace, "Timer Callback! m_nCount = %d m_nDelay = %d\n", m_nCount, m_nDelay);
+    // Picks up a changed configuration file
+    void UpdateSchedule(time_t nNow)
+    {
+        if(m_nConfigGeneration == PerfConfig::Generation()) {
+            return;
+        }
+        m_nConfigGeneration = PerfConfig::Generation();
+
+        ReportSchedule schedule;
+        PerfConfig::GetReportSchedule(&schedule);
+        if(memcmp(&schedule, &m_scheduler.GetSchedule(), sizeof(ReportSchedule)) == 0 && m_scheduler.NextReport() != 0) {
+            return;
+        }
+        if(strcmp(schedule.szTrigger, m_schedule.szTrigger) != 0) {
+            WatchTrigger(schedule.szTrigger);
+        }
+        m_schedule = schedule;
+        m_scheduler.SetSchedule(schedule, nNow);
+    }
+
+    void WatchTrigger(const char* szTrigger)
+    {
+        if(m_triggerFd >= 0) {
+            close(m_triggerFd);
+            m_triggerFd = -1;
+        }
+        if(szTrigger[0] == '\0') {
+            return;
+        }
+
+        // The directory is watched so the file may be created, touched or replaced
+        std::string path(szTrigger);
+        size_t      nSlash = path.rfind('/');
+        std::string dir = (nSlash == std::string::npos) ? "." : (nSlash == 0 ? "/" : path.substr(0, nSlash));
+        m_triggerName = (nSlash == std::string::npos) ? path : path.substr(nSlash + 1);
+
+        m_triggerFd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+        if(m_triggerFd < 0 || inotify_add_watch(m_triggerFd, dir.c_str(), IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_TO) < 0) {
+            LOG(eError, "Could not watch report trigger %s (%s)\n", szTrigger, strerror(errno));
+            if(m_triggerFd >= 0) close(m_triggerFd);
+            m_triggerFd = -1;
+        }
+    }
+
+    // The interval history has its own cadence, independent of the reports
+    void TakeSnapshot(time_t nNow)
+    {
+        PerfConfig::GetHistory(&m_history);
+        if(m_history.nResolution == 0 || nNow < m_nNextSnapshot) {
+            return;
+        }
+        RDKPerf_SnapshotProcess(getpid(), nNow, m_history);
+        m_nNextSnapshot = nNow + m_history.nResolution;
+    }
+
+    void Report(bool bRequested)
+    {
+        struct timespec cpuStart, cpuEnd;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuStart);
 
         // Validate that threads in process are still active
         if(RDKPerf_FindProcess(getpid()) != NULL) {
-            // Found a process in the list
-            if(m_nCount > m_nDelay) {
-                RDKPerf_ReportProcess(getpid());
-                m_nCount = 0;
-                if(m_nDelay < MAX_DELAY) {
-                    m_nDelay+=5;
-                }
-                LOG(eWarning, "Next performance log in %d seconds\n", m_nDelay * TIMER_INTERVAL_SECONDS);
-            }
-            m_nCount++;
+            RDKPerf_ReportProcess(getpid());
         }
         else {
             LOG(eTrace, "Could not find Process ID %X from map of size %d for reporting\n", (uint32_t)getpid(), RDKPerf_GetMapSize());
         }
 
-        return bTimerContinue;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuEnd);
+        uint64_t nCPUUS = ((uint64_t)(cpuEnd.tv_sec - cpuStart.tv_sec) * 1000000) + (cpuEnd.tv_nsec - cpuStart.tv_nsec) / 1000;
+
+        time_t nNow = time(NULL);
+        if(bRequested && nNow < m_scheduler.NextReport()) {
+            // Extra report, the schedule stays as it is
+            return;
+        }
+        m_scheduler.Reported(nNow, nCPUUS);
+        LOG(eWarning, "Next performance log in %d seconds\n", (int)(m_scheduler.NextReport() - nNow));
     }
 
     void Task() {
-        m_bContinue = true;
+        // m_bContinue is set by the constructor, StopTask() may already have cleared it
         LOG(eWarning, "Task Started\n");
+        pthread_setname_np(pthread_self(), "rdkperf_report");
+        if(setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), 19) != 0) {
+            LOG(eWarning, "Could not lower the report thread priority (%s)\n", strerror(errno));
+        }
+
         while(m_bContinue == true) {
-            if(!Loop()) {
-                LOG(eWarning, "Timer loop signaled for Exit..\n");
-                m_bContinue = false;
+            time_t nNow = time(NULL);
+            UpdateSchedule(nNow);
+            TakeSnapshot(nNow);
+
+            // Wake up at least every TIMER_INTERVAL_SECONDS for configuration changes
+            time_t nWait = m_scheduler.NextReport() - nNow;
+            if(m_history.nResolution != 0 && m_nNextSnapshot - nNow < nWait) nWait = m_nNextSnapshot - nNow;
+            if(nWait < 0) nWait = 0;
+            if(nWait > TIMER_INTERVAL_SECONDS) nWait = TIMER_INTERVAL_SECONDS;
+            LOG(eTrace, "Task sleeping %d seconds\n", (int)nWait);
+
+            bool bRequested = Wait((int)nWait * 1000);
+            // Threshold breaches wake the thread too, and windows end on the way
+            PerfBreachQueue::Report();
+            if(!m_bContinue) {
+                LOG(eWarning, "Exit task loop has been signaled\n");
                 break;
             }
-            LOG(eTrace, "Task sleeping %d seconds\n", TIMER_INTERVAL_SECONDS);
-            SignalResult result = Wait(TIMER_INTERVAL_SECONDS);
-            if(result == EXIT_LOOP) {
-                LOG(eWarning, "Exit task loop has been signaled\n");
+            if(bRequested || time(NULL) >= m_scheduler.NextReport()) {
+                Report(bRequested);
             }
         }
         LOG(eWarning, "Task Completed\n");
         return;
     };
 private:
-    void*       m_Context;
-    bool        m_bContinue; 
-    uint32_t    m_nDelay;
-    uint32_t    m_nCount;
-    // Timeout, signaling
-    TimerCallback::SignalResult m_current_state;
-    std::mutex   m_mtx;
-    std::condition_variable m_cv;
+    void*               m_Context;
+    std::atomic<bool>   m_bContinue; 
+    std::atomic<bool>   m_bReportNow;
+    uint32_t            m_nConfigGeneration;
+    ReportSchedule      m_schedule;
+    PerfReportScheduler m_scheduler;
+    int                 m_wakeFd;
+    int                 m_triggerFd;
+    std::string         m_triggerName;
+    HistoryConfig       m_history;
+    time_t              m_nNextSnapshot;
 };
 
 static std::thread*     s_thread = NULL;
 static TimerCallback*   s_timer = NULL;
+static pid_t            s_timerPid = 0;
 
-// This function is assigned to execute as a library init
-//  using __attribute__((constructor))
-static void PerfModuleInit()
+// Breach hook, called by the thread that exceeded a threshold
+static void PerfBreachWake()
+{
+    if(s_timer != NULL && s_timerPid == getpid()) {
+        s_timer->Wake();
+    }
+}
+
+// Start hook, called under the lock when the process opens its first scope.
+// Processes that link the library but never record pay for nothing else.
+static void PerfModuleStart()
 {
-    // Test to see if message queue service is running
     char cmd[80] = { 0 };
-    char strProcessName[PROCESS_NAMELEN];
+    char strProcessName[PROCESS_NAMELEN] = { 0 };
+
+    if(s_timer != NULL && s_timerPid == getpid()) {
+        LOG(eWarning, "Timer already exists %X\n", s_thread->get_id());
+        return;
+    }
+    // A timer created before fork() has no thread in this process, it is left alone
 
     sprintf(cmd, "/proc/%d/cmdline", getpid());
     FILE* fp = fopen(cmd,"r");
@@ -191,17 +356,44 @@ static void PerfModuleInit()
     }
 
     LOG(eWarning, "RDK performance process initialize %X named %s\n", getpid(), strProcessName);       
-    
-    RDKPerf_InitializeMap();
-    s_timer = new TimerCallback(NULL);
 
-    if(s_thread == NULL) {
-        s_thread = new std::thread(&TimerCallback::Task, s_timer);
-        LOG(eWarning, "Created new timer (%X) with the context %p\n", s_thread->get_id(), NULL);
-    }
-    else {
-        LOG(eWarning, "Timer already exists %X\n"), s_thread->get_id();
+    // Before the timer, it reads the report schedule
+    PerfConfig::LoadFromEnv();
+    PerfEventLog::RecordFromEnv();
+
+    s_timer     = new TimerCallback(NULL);
+    s_timerPid  = getpid();
+    s_nReportPid = s_timerPid;
+    s_nReportFd  = s_timer->GetWakeFd();
+
+    s_thread = new std::thread(&TimerCallback::Task, s_timer);
+    PerfBreachQueue::SetWakeHook(PerfBreachWake);
+    LOG(eWarning, "Created new timer (%X) with the context %p\n", s_thread->get_id(), NULL);
+}
+
+// This function is assigned to execute as a library init
+//  using __attribute__((constructor))
+static void PerfModuleInit()
+{
+    const char* szSignal = getenv(REPORT_SIGNAL_ENV);
+    if(szSignal != NULL && atoi(szSignal) != 0) {
+        // A handler the process installed itself is left alone
+        struct sigaction action;
+        if(sigaction(SIGUSR2, NULL, &action) != 0 || (action.sa_flags & SA_SIGINFO) != 0 ||
+           (action.sa_handler != SIG_DFL && action.sa_handler != SIG_IGN)) {
+            LOG(eError, "SIGUSR2 already has a handler, %s is ignored\n", REPORT_SIGNAL_ENV);
+        }
+        else {
+            memset(&action, 0, sizeof(action));
+            action.sa_sigaction = PerfReportSignal;
+            action.sa_flags     = SA_SIGINFO | SA_RESTART;
+            sigemptyset(&action.sa_mask);
+            sigaction(SIGUSR2, &action, NULL);
+        }
     }
+
+    // Everything else waits for the first scope
+    RDKPerf_SetStartHook(PerfModuleStart);
     LOG(eTrace, "Exit init code\n");
 }
   
@@ -209,13 +401,18 @@ static void PerfModuleInit()
 // using __attribute__((destructor))
 static void PerfModuleTerminate()
 {
-    if(s_timer != NULL) {
+    RDKPerf_SetStartHook(NULL);
+    PerfBreachQueue::SetWakeHook(NULL);
+
+    bool bStarted = s_timer != NULL && s_timerPid == getpid();
+    if(bStarted) {
+        s_nReportFd = -1;
         s_timer->StopTask();
     }
 
     pid_t pID = getpid();
 
-    LOG(eWarning, "RDK Performance process terminate %X\n", pID);
+    LOG(eTrace, "RDK Performance process terminate %X\n", pID);
 
 #if 0 // No need to print report on process exit
     // Print report
@@ -226,19 +423,16 @@ static void PerfModuleTerminate()
     RDKPerf_RemoveProcess(pID);
 
     // Wait for timer thread cleanup
-    if(s_thread != NULL && s_thread->joinable()) {
+    if(bStarted && s_thread->joinable()) {
         LOG(eWarning, "Cleaning up timer thread\n");
         s_thread->join();
 
         delete s_thread;
-        if(s_timer != NULL) delete s_timer;
+        delete s_timer;
 
         s_thread = NULL;
         s_timer = NULL;
     }
-    else {
-        LOG(eError, "Thread does not exist\n"); 
-    }
 
 #ifdef PERF_REMOTE
     if(s_pQueue != NULL) {
@@ -246,24 +440,28 @@ static void PerfModuleTerminate()
     }
 #endif // PERF_REMOTE
 
-    RDKPerf_DeleteMap();
+    if(RDKPerf_MapExists()) {
+        RDKPerf_DeleteMap();
+    }
 }
 
 #ifdef NO_PERF
 //-------------------------------------------
 RDKPerfEmpty::RDKPerfEmpty(const char* szName) 
 {
-    printf("RDKPerfEmpty --> %s\n", szName);fflush(stdout);
     return;
 }
 RDKPerfEmpty::RDKPerfEmpty(const char* szName, uint32_t nThresholdInUS)
 {
-    printf("RDKPerfEmpty(t) --> %s\n", szName);fflush(stdout);
     return;
 }
 void RDKPerfEmpty::SetThreshhold(uint32_t nThresholdInUS)
 {
 }
+PerfMetric* RDKPerfEmpty::GetMetric(const char* szName, MetricType type)
+{
+    return PerfMetric::Discard();
+}
 RDKPerfEmpty::~RDKPerfEmpty()
 {
     return;
@@ -287,6 +485,15 @@ void RDKPerfInProc::SetThreshhold(uint32_t nThresholdInUS)
     m_record.SetThreshold((int32_t)nThresholdInUS); 
 }
 
+PerfMetric* RDKPerfInProc::GetMetric(const char* szName, MetricType type)
+{
+    PerfNode* pNode = m_record.GetNodeInTree();
+    if(pNode == NULL) {
+        return PerfMetric::Discard();
+    }
+    return pNode->GetMetric(szName, type);
+}
+
 RDKPerfInProc::~RDKPerfInProc()
 {
     return;
@@ -298,7 +505,16 @@ RDKPerfRemote::RDKPerfRemote(const char* szName)
 , m_nThresholdInUS(0)
 , m_EndTime(0)
 {
+    PerfControl::Attach();
+    if(!PerfControl::IsEnabled(szName)) {
+        // Disabled, nothing is sent for this scope
+        m_szName = NULL;
+        return;
+    }
     m_StartTime = PerfRecord::TimeStamp();
+    if(PerfFTrace::IsEnabled()) {
+        PerfFTrace::Begin(m_szName);
+    }
 
     // Send enter event
 #ifdef PERF_REMOTE
@@ -316,7 +532,16 @@ RDKPerfRemote::RDKPerfRemote(const char* szName, uint32_t nThresholdInUS)
 : m_szName(szName)
 , m_nThresholdInUS(nThresholdInUS)
 {
+    PerfControl::Attach();
+    if(!PerfControl::IsEnabled(szName)) {
+        // Disabled, nothing is sent for this scope
+        m_szName = NULL;
+        return;
+    }
     m_StartTime = PerfRecord::TimeStamp();
+    if(PerfFTrace::IsEnabled()) {
+        PerfFTrace::Begin(m_szName);
+    }
  
      // Send enter event
 #ifdef PERF_REMOTE
@@ -333,6 +558,9 @@ RDKPerfRemote::RDKPerfRemote(const char* szName, uint32_t nThresholdInUS)
 
 void RDKPerfRemote::SetThreshhold(uint32_t nThresholdInUS)
 {
+    if(m_szName == NULL) {
+        return;
+    }
     // Send threshhold event
     m_nThresholdInUS = nThresholdInUS;
 #ifdef PERF_REMOTE
@@ -342,9 +570,21 @@ void RDKPerfRemote::SetThreshhold(uint32_t nThresholdInUS)
 #endif // PERF_REMOTE    
 }
 
+PerfMetric* RDKPerfRemote::GetMetric(const char* szName, MetricType type)
+{
+    // Metrics are not forwarded to perfservice
+    return PerfMetric::Discard();
+}
+
 RDKPerfRemote::~RDKPerfRemote()
 {
+    if(m_szName == NULL) {
+        return;
+    }
     m_EndTime = PerfRecord::TimeStamp();
+    if(PerfFTrace::IsEnabled()) {
+        PerfFTrace::End();
+    }
 
     // Send close event
 #ifdef PERF_REMOTE
@@ -358,6 +598,172 @@ RDKPerfRemote::~RDKPerfRemote()
     return;
 }
 
+//-------------------------------------------
+RDKPerfCadence::RDKPerfCadence(const char* szName, uint32_t nExpectedPeriodUS)
+: m_pCadence(NULL)
+{
+    // Cadence is only tracked in process
+#if !defined(NO_PERF) && !defined(PERF_REMOTE)
+    m_pCadence = new PerfCadence(szName, nExpectedPeriodUS);
+#endif
+    return;
+}
+
+RDKPerfCadence::~RDKPerfCadence()
+{
+    if(m_pCadence != NULL) {
+        delete m_pCadence;
+    }
+    return;
+}
+
+void RDKPerfCadence::Tick()
+{
+    if(m_pCadence != NULL) {
+        m_pCadence->Tick();
+    }
+}
+
+//-------------------------------------------
+RDKPerfMutex::RDKPerfMutex(const char* szName)
+: m_pLock(NULL)
+, m_nAcquired(0)
+{
+    pthread_mutex_init(&m_mutex, NULL);
+    // Lock statistics are only kept in process
+#if !defined(NO_PERF) && !defined(PERF_REMOTE)
+    m_pLock = PerfLock::GetLock(szName, eLockMutex);
+#endif
+    return;
+}
+
+RDKPerfMutex::~RDKPerfMutex()
+{
+    if(m_pLock != NULL) {
+        PerfLock::ReleaseLock(m_pLock);
+    }
+    pthread_mutex_destroy(&m_mutex);
+    return;
+}
+
+void RDKPerfMutex::lock()
+{
+    if(m_pLock == NULL) {
+        pthread_mutex_lock(&m_mutex);
+        return;
+    }
+
+    // Uncontended acquisitions only cost the try lock and two clock reads
+    bool bContended = false;
+    uint64_t nStart = PerfLock::TimeStamp();
+    if(pthread_mutex_trylock(&m_mutex) != 0) {
+        bContended = true;
+        pthread_mutex_lock(&m_mutex);
+    }
+    m_nAcquired = PerfLock::TimeStamp();
+    m_pLock->NoteAcquire(m_nAcquired - nStart, bContended);
+}
+
+bool RDKPerfMutex::try_lock()
+{
+    if(pthread_mutex_trylock(&m_mutex) != 0) {
+        return false;
+    }
+    if(m_pLock != NULL) {
+        m_nAcquired = PerfLock::TimeStamp();
+        m_pLock->NoteAcquire(0, false);
+    }
+    return true;
+}
+
+void RDKPerfMutex::unlock()
+{
+    if(m_pLock != NULL) {
+        m_pLock->NoteRelease(PerfLock::TimeStamp() - m_nAcquired);
+    }
+    pthread_mutex_unlock(&m_mutex);
+}
+
+//-------------------------------------------
+RDKPerfCondVar::RDKPerfCondVar(const char* szName)
+: m_pLock(NULL)
+{
+    // Timeouts use the monotonic clock
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&m_cond, &attr);
+    pthread_condattr_destroy(&attr);
+#if !defined(NO_PERF) && !defined(PERF_REMOTE)
+    m_pLock = PerfLock::GetLock(szName, eLockCondVar);
+#endif
+    return;
+}
+
+RDKPerfCondVar::~RDKPerfCondVar()
+{
+    if(m_pLock != NULL) {
+        PerfLock::ReleaseLock(m_pLock);
+    }
+    pthread_cond_destroy(&m_cond);
+    return;
+}
+
+void RDKPerfCondVar::notify_one()
+{
+    pthread_cond_signal(&m_cond);
+}
+
+void RDKPerfCondVar::notify_all()
+{
+    pthread_cond_broadcast(&m_cond);
+}
+
+void RDKPerfCondVar::wait(std::unique_lock<RDKPerfMutex>& lock)
+{
+    Wait(*lock.mutex());
+}
+
+void RDKPerfCondVar::Wait(RDKPerfMutex& mutex)
+{
+    if(m_pLock == NULL) {
+        pthread_cond_wait(&m_cond, &mutex.m_mutex);
+        return;
+    }
+
+    // The mutex is not held while waiting
+    uint64_t nStart = PerfLock::TimeStamp();
+    if(mutex.m_pLock != NULL) {
+        mutex.m_pLock->NoteRelease(nStart - mutex.m_nAcquired);
+    }
+    pthread_cond_wait(&m_cond, &mutex.m_mutex);
+    mutex.m_nAcquired = PerfLock::TimeStamp();
+    m_pLock->NoteWait(mutex.m_nAcquired - nStart, false);
+}
+
+bool RDKPerfCondVar::WaitFor(RDKPerfMutex& mutex, uint32_t nTimeoutUS)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec  += nTimeoutUS / 1000000;
+    deadline.tv_nsec += (nTimeoutUS % 1000000) * 1000;
+    if(deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    uint64_t nStart = PerfLock::TimeStamp();
+    if(m_pLock != NULL && mutex.m_pLock != NULL) {
+        mutex.m_pLock->NoteRelease(nStart - mutex.m_nAcquired);
+    }
+    bool bTimedOut = (pthread_cond_timedwait(&m_cond, &mutex.m_mutex, &deadline) == ETIMEDOUT);
+    if(m_pLock != NULL) {
+        mutex.m_nAcquired = PerfLock::TimeStamp();
+        m_pLock->NoteWait(mutex.m_nAcquired - nStart, bTimedOut);
+    }
+    return !bTimedOut;
+}
+
 //-------------------------------------------
 extern "C" {
 
@@ -403,7 +809,7 @@ void RDKPerf_ReportThread(pthread_t tID)
     // Find thread in process map
     pProcess = RDKPerf_FindProcess(getpid());
 
-    PerfTree* pTree = pProcess->GetTree(tID);
+    PerfTree* pTree = (pProcess != NULL) ? pProcess->FindTree(tID) : NULL;
     if(pTree != NULL) {
         LOG(eWarning, "Printing tree report for Task ID %X\n", (uint32_t)tID);
         pTree->ReportData();
@@ -482,5 +888,234 @@ void RDKPerfSetThreshold(RDKPerfHandle hPerf, uint32_t nThresholdInUS)
     return;
 }
 
+void RDKPerfAsyncBegin(const char* szName, uint64_t nID)
+{
+#ifndef NO_PERF
+    uint64_t nTimeStamp = PerfRecord::TimeStamp();
+#ifdef PERF_REMOTE
+    if(s_pQueue == NULL) s_pQueue = PerfMsgQueue::GetQueue(RDK_PERF_MSG_QUEUE_NAME, false);
+    if(s_pQueue != NULL) {
+        s_pQueue->SendAsyncMessage(eAsyncBegin, szName, nID, nTimeStamp);
+    }
+#else // PERF_REMOTE
+    PerfAsyncSpans::Local()->Begin(szName, nID, pthread_self(), nTimeStamp);
+#endif // PERF_REMOTE
+#endif // NO_PERF
+    return;
+}
+
+void RDKPerfAsyncEnd(uint64_t nID)
+{
+#ifndef NO_PERF
+    uint64_t nTimeStamp = PerfRecord::TimeStamp();
+#ifdef PERF_REMOTE
+    if(s_pQueue == NULL) s_pQueue = PerfMsgQueue::GetQueue(RDK_PERF_MSG_QUEUE_NAME, false);
+    if(s_pQueue != NULL) {
+        s_pQueue->SendAsyncMessage(eAsyncEnd, NULL, nID, nTimeStamp);
+    }
+#else // PERF_REMOTE
+    PerfAsyncSpans::Local()->End(nID, nTimeStamp);
+#endif // PERF_REMOTE
+#endif // NO_PERF
+    return;
+}
+
+int RDKPerfGetWindowStats(const char* szName, uint32_t nSeconds, RDKPerfWindowStats* pStats)
+{
+    if(szName == NULL || pStats == NULL) return -1;
+    memset(pStats, 0, sizeof(RDKPerfWindowStats));
+#if defined(NO_PERF) || defined(PERF_REMOTE)
+    return -1;
+#else
+    WindowStats window;
+    SCOPED_LOCK();
+
+    // Scopes with this name keep windows from now on, -1 until one ran
+    PerfConfig::RequestWindow(szName);
+    PerfProcess* pProcess = RDKPerf_FindProcess(getpid());
+    if(pProcess == NULL || !pProcess->GetWindow(szName, nSeconds, &window)) {
+        return -1;
+    }
+    pStats->nSeconds    = window.nSeconds;
+    pStats->nCount      = window.nCount;
+    pStats->nTotalUS    = window.nTime;
+    pStats->nMaxUS      = window.nMax;
+    pStats->nP50US      = window.nP50;
+    pStats->nP90US      = window.nP90;
+    pStats->nP99US      = window.nP99;
+    return 0;
+#endif
+}
+
+int RDKPerfGetHistory(const char* szName, uint32_t nSeconds, RDKPerfHistorySample* pSamples, int nMaxSamples)
+{
+    if(szName == NULL || pSamples == NULL || nMaxSamples < 0) return -1;
+#if defined(NO_PERF) || defined(PERF_REMOTE)
+    return -1;
+#else
+    std::vector<HistorySample> samples;
+    SCOPED_LOCK();
+
+    PerfProcess* pProcess = RDKPerf_FindProcess(getpid());
+    if(pProcess == NULL || pProcess->GetHistory() == NULL ||
+       !pProcess->GetHistory()->Get(szName, nSeconds, &samples)) {
+        return -1;
+    }
+    size_t nFirst = samples.size() > (size_t)nMaxSamples ? samples.size() - nMaxSamples : 0;
+    for(size_t nIdx = nFirst; nIdx < samples.size(); nIdx++) {
+        RDKPerfHistorySample* pSample = &pSamples[nIdx - nFirst];
+        pSample->nEnd       = (int64_t)samples[nIdx].nEnd;
+        pSample->nSeconds   = samples[nIdx].nSeconds;
+        pSample->nCount     = samples[nIdx].nCount;
+        pSample->nTotalUS   = samples[nIdx].nTime;
+        pSample->nMaxUS     = samples[nIdx].nMax;
+        pSample->nP99US     = samples[nIdx].nP99;
+    }
+    return (int)(samples.size() - nFirst);
+#endif
+}
+
+RDKPerfMetricHandle RDKPerfGetMetric(const char* szName, RDKPerfMetricType type)
+{
+#if defined(NO_PERF) || defined(PERF_REMOTE)
+    return (RDKPerfMetricHandle)PerfMetric::Discard();
+#else
+    return (RDKPerfMetricHandle)PerfMetric::GetGlobal(szName, (MetricType)type);
+#endif
+}
+
+RDKPerfMetricHandle RDKPerfGetScopeMetric(RDKPerfHandle hPerf, const char* szName, RDKPerfMetricType type)
+{
+    if(hPerf != NULL) {
+        return (RDKPerfMetricHandle)((RDKPerf*)hPerf)->GetMetric(szName, (MetricType)type);
+    }
+#if defined(NO_PERF) || defined(PERF_REMOTE)
+    return (RDKPerfMetricHandle)PerfMetric::Discard();
+#else
+    // The record may be stopped on another thread
+    SCOPED_LOCK();
+    PerfRecord* pRecord = PerfRecord::Current();
+    if(pRecord == NULL || pRecord->GetNodeInTree() == NULL) {
+        return (RDKPerfMetricHandle)PerfMetric::Discard();
+    }
+    return (RDKPerfMetricHandle)pRecord->GetNodeInTree()->GetMetric(szName, (MetricType)type);
+#endif
+}
+
+void RDKPerfMetricAdd(RDKPerfMetricHandle hMetric, int64_t nValue)
+{
+    if(hMetric != NULL) ((PerfMetric*)hMetric)->Add(nValue);
+}
+
+void RDKPerfMetricSet(RDKPerfMetricHandle hMetric, int64_t nValue)
+{
+    if(hMetric != NULL) ((PerfMetric*)hMetric)->Set(nValue);
+}
+
+void RDKPerfMetricRecord(RDKPerfMetricHandle hMetric, uint64_t nValue)
+{
+    if(hMetric != NULL) ((PerfMetric*)hMetric)->Record(nValue);
+}
+RDKPerfCadenceHandle RDKPerfCadenceCreate(const char* szName, uint32_t nExpectedPeriodUS)
+{
+    return (RDKPerfCadenceHandle)new RDKPerfCadence(szName, nExpectedPeriodUS);
+}
+
+void RDKPerfCadenceTick(RDKPerfCadenceHandle hCadence)
+{
+    if(hCadence != NULL) ((RDKPerfCadence*)hCadence)->Tick();
+}
+
+void RDKPerfCadenceDestroy(RDKPerfCadenceHandle hCadence)
+{
+    if(hCadence != NULL) delete (RDKPerfCadence*)hCadence;
+}
+
+void RDKPerfSetFTrace(int bEnable)
+{
+#ifndef NO_PERF
+    PerfFTrace::Enable(bEnable != 0);
+#endif
+}
+
+void RDKPerfReportNow()
+{
+    if(s_timer != NULL && s_timerPid == getpid()) {
+        s_timer->ReportNow();
+    }
+}
+
+void RDKPerfSetEnabled(int bEnable)
+{
+#ifndef NO_PERF
+    PerfControl::SetEnabled(bEnable != 0);
+#endif
+}
+
+int RDKPerfSetNameEnabled(const char* szName, int bEnable)
+{
+#ifndef NO_PERF
+    return PerfControl::SetNameEnabled(szName, bEnable != 0) ? 0 : -1;
+#else
+    return 0;
+#endif
+}
+
+RDKPerfMutexHandle RDKPerfMutexCreate(const char* szName)
+{
+    return (RDKPerfMutexHandle)new RDKPerfMutex(szName);
+}
+
+void RDKPerfMutexLock(RDKPerfMutexHandle hMutex)
+{
+    if(hMutex != NULL) ((RDKPerfMutex*)hMutex)->lock();
+}
+
+int RDKPerfMutexTryLock(RDKPerfMutexHandle hMutex)
+{
+    if(hMutex == NULL) return EINVAL;
+    return ((RDKPerfMutex*)hMutex)->try_lock() ? 0 : EBUSY;
+}
+
+void RDKPerfMutexUnlock(RDKPerfMutexHandle hMutex)
+{
+    if(hMutex != NULL) ((RDKPerfMutex*)hMutex)->unlock();
+}
+
+void RDKPerfMutexDestroy(RDKPerfMutexHandle hMutex)
+{
+    if(hMutex != NULL) delete (RDKPerfMutex*)hMutex;
+}
+
+RDKPerfCondVarHandle RDKPerfCondVarCreate(const char* szName)
+{
+    return (RDKPerfCondVarHandle)new RDKPerfCondVar(szName);
+}
+
+void RDKPerfCondVarWait(RDKPerfCondVarHandle hCond, RDKPerfMutexHandle hMutex)
+{
+    if(hCond != NULL && hMutex != NULL) ((RDKPerfCondVar*)hCond)->Wait(*(RDKPerfMutex*)hMutex);
+}
+
+int RDKPerfCondVarTimedWait(RDKPerfCondVarHandle hCond, RDKPerfMutexHandle hMutex, uint32_t nTimeoutUS)
+{
+    if(hCond == NULL || hMutex == NULL) return EINVAL;
+    return ((RDKPerfCondVar*)hCond)->WaitFor(*(RDKPerfMutex*)hMutex, nTimeoutUS) ? 0 : ETIMEDOUT;
+}
+
+void RDKPerfCondVarSignal(RDKPerfCondVarHandle hCond)
+{
+    if(hCond != NULL) ((RDKPerfCondVar*)hCond)->notify_one();
+}
+
+void RDKPerfCondVarBroadcast(RDKPerfCondVarHandle hCond)
+{
+    if(hCond != NULL) ((RDKPerfCondVar*)hCond)->notify_all();
+}
+
+void RDKPerfCondVarDestroy(RDKPerfCondVarHandle hCond)
+{
+    if(hCond != NULL) delete (RDKPerfCondVar*)hCond;
+}
 
 } // extern "C" 
@@ -31,8 +31,10 @@
 #include <list>
 #include <map>
 #include <stack>
+#include <mutex>
 
 #include "rdk_perf_record.h"
+#include "rdk_perf_metrics.h"
 //#include "rdk_perf_node.h"
 
 #define FUNC_METRICS_START(depth)                                   \
@@ -65,6 +67,7 @@ public:
     ~RDKPerfEmpty();
 
     void SetThreshhold(uint32_t nThresholdInUS);
+    PerfMetric* GetMetric(const char* szName, MetricType type);
 
 private:
 };
@@ -78,6 +81,7 @@ public:
     ~RDKPerfInProc();
 
     void SetThreshhold(uint32_t nThresholdInUS);
+    PerfMetric* GetMetric(const char* szName, MetricType type);
 
 private:
     PerfRecord        m_record;
@@ -91,6 +95,7 @@ public:
     ~RDKPerfRemote();
 
     void SetThreshhold(uint32_t nThresholdInUS);
+    PerfMetric* GetMetric(const char* szName, MetricType type);
 
 private:
     const char* m_szName;
@@ -100,6 +105,71 @@ private:
 };
 
 
+// Tracks the time between successive Tick() calls of a periodic event
+// (video frames, audio periods, vsync) against the expected period
+class PerfCadence;
+class RDKPerfCadence
+{
+public:
+    RDKPerfCadence(const char* szName, uint32_t nExpectedPeriodUS);
+    ~RDKPerfCadence();
+
+    void Tick();
+
+private:
+    PerfCadence*    m_pCadence;
+};
+
+// Drop in replacements for std::mutex and std::condition_variable that
+// record wait time, hold time and contention per lock name.  Locks with the
+// same name are reported together.
+class PerfLock;
+class RDKPerfMutex
+{
+public:
+    RDKPerfMutex(const char* szName);
+    ~RDKPerfMutex();
+
+    // Lockable, works with std::lock_guard and std::unique_lock
+    void lock();
+    bool try_lock();
+    void unlock();
+
+    pthread_mutex_t* native_handle() { return &m_mutex; };
+
+private:
+    friend class RDKPerfCondVar;
+
+    pthread_mutex_t m_mutex;
+    PerfLock*       m_pLock;
+    uint64_t        m_nAcquired;    // Written by the owner only
+};
+
+class RDKPerfCondVar
+{
+public:
+    RDKPerfCondVar(const char* szName);
+    ~RDKPerfCondVar();
+
+    void notify_one();
+    void notify_all();
+    void wait(std::unique_lock<RDKPerfMutex>& lock);
+    template<class Predicate>
+    void wait(std::unique_lock<RDKPerfMutex>& lock, Predicate pred)
+    {
+        while(!pred()) {
+            wait(lock);
+        }
+    };
+    // Returns false on timeout
+    bool WaitFor(RDKPerfMutex& mutex, uint32_t nTimeoutUS);
+    void Wait(RDKPerfMutex& mutex);
+
+private:
+    pthread_cond_t  m_cond;
+    PerfLock*       m_pLock;
+};
+
 #ifdef NO_PERF
     #define RDKPerf RDKPerfEmpty
 #else
@@ -126,6 +196,94 @@ RDKPerfHandle RDKPerfStart(const char* szName);
 void RDKPerfStop(RDKPerfHandle hPerf);
 void RDKPerfSetThreshold(RDKPerfHandle hPerf, uint32_t nThresholdInUS);
 
+// Metrics attached to a scope (hPerf, or the innermost open scope of the
+// calling thread when hPerf is NULL) or to the process (RDKPerfGetMetric).
+// Handles stay valid while the scope's node exists; updates are lock free.
+typedef void* RDKPerfMetricHandle;
+typedef enum _RDKPerfMetricType
+{
+    RDKPerfCounter      = 0,
+    RDKPerfGauge        = 1,
+    RDKPerfDistribution = 2
+} RDKPerfMetricType;
+RDKPerfMetricHandle RDKPerfGetMetric(const char* szName, RDKPerfMetricType type);
+RDKPerfMetricHandle RDKPerfGetScopeMetric(RDKPerfHandle hPerf, const char* szName, RDKPerfMetricType type);
+void RDKPerfMetricAdd(RDKPerfMetricHandle hMetric, int64_t nValue);
+void RDKPerfMetricSet(RDKPerfMetricHandle hMetric, int64_t nValue);
+void RDKPerfMetricRecord(RDKPerfMetricHandle hMetric, uint64_t nValue);
+
+typedef void* RDKPerfCadenceHandle;
+RDKPerfCadenceHandle RDKPerfCadenceCreate(const char* szName, uint32_t nExpectedPeriodUS);
+void RDKPerfCadenceTick(RDKPerfCadenceHandle hCadence);
+void RDKPerfCadenceDestroy(RDKPerfCadenceHandle hCadence);
+
+// Write scope begin and end records to the ftrace trace_marker, same as
+// RDKPERF_FTRACE=1 in the environment
+void RDKPerfSetFTrace(int bEnable);
+
+// Ask the report thread for a report of this process without waiting for it
+void RDKPerfReportNow();
+
+// Turn scopes on and off at runtime, for every process using the shared
+// control block (see perfctl).  A name ending in '*' matches every scope
+// starting with the prefix.  Returns 0 on success.
+void RDKPerfSetEnabled(int bEnable);
+int RDKPerfSetNameEnabled(const char* szName, int bEnable);
+
+// Instrumented mutex and condition variable, see RDKPerfMutex.  TryLock and
+// TimedWait return 0 on success like their pthread counterparts.
+typedef void* RDKPerfMutexHandle;
+typedef void* RDKPerfCondVarHandle;
+RDKPerfMutexHandle RDKPerfMutexCreate(const char* szName);
+void RDKPerfMutexLock(RDKPerfMutexHandle hMutex);
+int RDKPerfMutexTryLock(RDKPerfMutexHandle hMutex);
+void RDKPerfMutexUnlock(RDKPerfMutexHandle hMutex);
+void RDKPerfMutexDestroy(RDKPerfMutexHandle hMutex);
+RDKPerfCondVarHandle RDKPerfCondVarCreate(const char* szName);
+void RDKPerfCondVarWait(RDKPerfCondVarHandle hCond, RDKPerfMutexHandle hMutex);
+int RDKPerfCondVarTimedWait(RDKPerfCondVarHandle hCond, RDKPerfMutexHandle hMutex, uint32_t nTimeoutUS);
+void RDKPerfCondVarSignal(RDKPerfCondVarHandle hCond);
+void RDKPerfCondVarBroadcast(RDKPerfCondVarHandle hCond);
+void RDKPerfCondVarDestroy(RDKPerfCondVarHandle hCond);
+
+// Spans that may begin and end on different threads.  The ID must be unique
+// among the spans open at the same time, e.g. a buffer pointer or sequence number.
+void RDKPerfAsyncBegin(const char* szName, uint64_t nID);
+void RDKPerfAsyncEnd(uint64_t nID);
+
+// Rolling window of the last nSeconds complete seconds (1 to 10, or up to 60
+// in steps of 10) of every scope named szName in the calling process.
+// Reading a window resets nothing.  Windows are only kept for names that
+// were asked for, so the first call for a name returns -1 and starts them.
+// Returns 0 when the scope has run since, -1 otherwise and for remote
+// instrumentation.
+typedef struct _RDKPerfWindowStats
+{
+    uint32_t    nSeconds;       // Length of the window
+    uint64_t    nCount;
+    uint64_t    nTotalUS;
+    uint64_t    nMaxUS;
+    uint64_t    nP50US;         // Percentiles within a factor of two
+    uint64_t    nP90US;
+    uint64_t    nP99US;
+} RDKPerfWindowStats;
+int RDKPerfGetWindowStats(const char* szName, uint32_t nSeconds, RDKPerfWindowStats* pStats);
+
+// Interval history of the scopes named szName, kept with "history" in the
+// configuration file.  Fills at most nMaxSamples of the snapshots of the
+// last nSeconds, the newest last, and returns how many.  Returns -1 when
+// the scope has no history.
+typedef struct _RDKPerfHistorySample
+{
+    int64_t     nEnd;           // End of the interval, seconds since the epoch
+    uint32_t    nSeconds;       // Length of the interval
+    uint64_t    nCount;
+    uint64_t    nTotalUS;
+    uint64_t    nMaxUS;         // Max and p99 of the rolling window at the end
+    uint64_t    nP99US;
+} RDKPerfHistorySample;
+int RDKPerfGetHistory(const char* szName, uint32_t nSeconds, RDKPerfHistorySample* pSamples, int nMaxSamples);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
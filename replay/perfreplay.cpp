@@ -0,0 +1,74 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include <set>
+
+#include "rdk_perf_logging.h"
+#include "rdk_perf_eventlog.h"
+#include "rdk_perf_process.h"
+#include "rdk_perf_record.h"
+#include "rdk_perf_config.h"
+
+// Replays a file recorded with RDKPERF_EVENT_LOG into the aggregation
+// engine and prints the resulting process reports.  The optional repeat
+// count replays the same stream several times to benchmark the engine.
+int main(int argc, char *argv[])
+{
+    if(argc < 2) {
+        fprintf(stderr, "Usage: %s <event log> [repeat count]\n", argv[0]);
+        exit(-1);
+    }
+
+    uint32_t nRepeat = (argc > 2) ? (uint32_t)atoi(argv[2]) : 1;
+    if(nRepeat == 0) nRepeat = 1;
+
+    RDKPerf_InitializeMap();
+    PerfConfig::LoadFromEnv();
+
+    std::set<pid_t> processes;
+    uint64_t        nEvents = 0;
+    uint64_t        nStartTime = PerfRecord::TimeStamp();
+
+    for(uint32_t nIdx = 0; nIdx < nRepeat; nIdx++) {
+        nEvents += PerfEventLog::Replay(argv[1], &processes);
+    }
+
+    uint64_t nElapsed = PerfRecord::TimeStamp() - nStartTime;
+    LOG(eWarning, "Replayed %llu events from %s in %0.3lf ms (%0.0lf events/s)\n",
+        nEvents, argv[1], (double)nElapsed / 1000.0,
+        nElapsed == 0 ? 0.0 : ((double)nEvents * 1000000.0) / (double)nElapsed);
+
+    for(auto it = processes.begin(); it != processes.end(); it++) {
+        PerfProcess* pProcess = RDKPerf_FindProcess(*it);
+        if(pProcess != NULL) {
+            pProcess->ReportData();
+        }
+        RDKPerf_RemoveProcess(*it);
+    }
+
+    RDKPerf_DeleteMap();
+
+    return 0;
+}
@@ -25,12 +25,18 @@
 #include <sys/time.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <signal.h>
+#include <time.h>
 
 #include "rdk_perf_logging.h"
 #include "rdk_perf_msgqueue.h"
 #include "rdk_perf_process.h"
 #include "rdk_perf_tree.h"
 #include "rdk_perf_node.h"
+#include "rdk_perf_eventlog.h"
+#include "rdk_perf_async.h"
+#include "rdk_perf_system.h"
+#include "rdk_perf_config.h"
 
 #define MESSAGE_TIMEOUT 10000
 //#define MAX_TIMEOUT 60     // ~ 10 minutes
@@ -215,6 +221,52 @@ bool HandleCloseProcess(PerfMessage* pMsg)
     return retVal;
 }
 
+bool HandleAsyncBegin(PerfMessage* pMsg)
+{
+    pid_t           pID = pMsg->msg_data.async.pID;
+
+    // Handle the async span begin message
+    LOG(eTrace, "Async span %llu begin for element %s pid %X\n", 
+                pMsg->msg_data.async.nID, pMsg->msg_data.async.szName, pID);
+
+    PerfAsyncSpans* pSpans = PerfAsyncSpans::GetSpans(pID, true);
+
+    return pSpans->Begin(pMsg->msg_data.async.szName,
+                         pMsg->msg_data.async.nID,
+                         pMsg->msg_data.async.tID,
+                         pMsg->msg_data.async.nTimeStamp);
+}
+
+bool HandleAsyncEnd(PerfMessage* pMsg)
+{
+    pid_t           pID = pMsg->msg_data.async.pID;
+
+    // Handle the async span end message
+    LOG(eTrace, "Async span %llu end pid %X\n", pMsg->msg_data.async.nID, pID);
+
+    PerfAsyncSpans* pSpans = PerfAsyncSpans::GetSpans(pID, false);
+    if(pSpans == NULL) {
+        return false;
+    }
+
+    return pSpans->End(pMsg->msg_data.async.nID, pMsg->msg_data.async.nTimeStamp);
+}
+
+void ReportSystem()
+{
+    // Processes that died without closing, a respawned daemon shows up
+    // under a new PID and continues the history of its name
+    std::vector<pid_t> processIDs = RDKPerf_GetProcessIDs();
+    for(auto it = processIDs.begin(); it != processIDs.end(); it++) {
+        if(kill(*it, 0) != 0 && errno == ESRCH) {
+            LOG(eWarning, "Process %X is gone, closing it\n", *it);
+            RDKPerf_RemoveProcess(*it);
+        }
+    }
+
+    PerfSystemView::ReportData();
+}
+
 bool HandleMessage(PerfMessage* pMsg)
 {
     bool retVal = true;
@@ -242,18 +294,31 @@ bool HandleMessage(PerfMessage* pMsg)
     case eCloseProcess:
         retVal = HandleCloseProcess(pMsg);
         break;
+    case eAsyncBegin:
+        retVal = HandleAsyncBegin(pMsg);
+        break;
+    case eAsyncEnd:
+        retVal = HandleAsyncEnd(pMsg);
+        break;
     default:
         LOG(eError, "Unknown Mesage type %d\n", pMsg->type);
         retVal = false;
         break;
     }
 
+    // Record after handling so the process name is known for new processes
+    PerfEventLog* pLog = PerfEventLog::GetRecorder();
+    if(retVal && pLog != NULL) {
+        pLog->RecordMessage(pMsg);
+    }
+
     return retVal;
 }
 void RunLoop(PerfMsgQueue* pQueue)
 {
     bool        bContinue       = true;
     uint32_t    nTimeoutCount   = 0;
+    time_t      nLastSystem     = time(NULL);
 
     while(bContinue == true) {
         PerfMessage msg;
@@ -281,6 +346,11 @@ void RunLoop(PerfMsgQueue* pQueue)
             // Handle message
             HandleMessage(&msg);
         }
+
+        if(bContinue && time(NULL) - nLastSystem >= SYSTEM_REPORT_INTERVAL) {
+            ReportSystem();
+            nLastSystem = time(NULL);
+        }
     }
 
     LOG(eWarning, "RunLoop exiting\n");
@@ -291,6 +361,9 @@ int main(int argc, char *argv[])
     LOG(eWarning, "Enter perfservice app %s\n", __DATE__);
 
     RDKPerf_InitializeMap();
+    PerfSystemView::Enable(true);
+    PerfConfig::LoadFromEnv();
+    PerfEventLog::RecordFromEnv();
 
     // // Does the queue exist
     if(PerfMsgQueue::IsQueueCreated(RDK_PERF_MSG_QUEUE_NAME)) {
@@ -306,6 +379,7 @@ int main(int argc, char *argv[])
 
         // RunLoop exited, cleanup
         pQueue->Release();
+        ReportSystem();
     }
 
     RDKPerf_DeleteMap();
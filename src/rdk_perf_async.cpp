@@ -0,0 +1,259 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <atomic>
+
+#include "rdk_perf_async.h"
+#include "rdk_perf_node.h"
+#include "rdk_perf_logging.h"
+#include "rdk_perf_scopedlock.h"
+
+// Spans that are begun but never ended would otherwise grow the table forever
+#define ASYNC_MAX_OPEN_PER_SHARD 4096
+
+static std::map<pid_t, PerfAsyncSpans*>*    s_pSpansMap = NULL;
+static std::atomic<PerfAsyncSpans*>         s_pLocal(NULL);
+static std::atomic<uint64_t>                s_nDropped(0);
+
+static void __attribute__((destructor)) AsyncModuleTerminate();
+
+// This function is assigned to execute as library unload
+// using __attribute__((destructor))
+static void AsyncModuleTerminate()
+{
+    SCOPED_LOCK();
+
+    s_pLocal = NULL;
+    if(s_pSpansMap != NULL) {
+        auto it = s_pSpansMap->begin();
+        while(it != s_pSpansMap->end()) {
+            delete it->second;
+            it++;
+        }
+        delete s_pSpansMap;
+        s_pSpansMap = NULL;
+    }
+}
+
+PerfAsyncSpans::PerfAsyncSpans(pid_t pID)
+: m_idProcess(pID)
+, m_nUnmatched(0)
+, m_nReplaced(0)
+{
+    for(uint32_t nIdx = 0; nIdx < ASYNC_SPAN_SHARDS; nIdx++) {
+        pthread_mutex_init(&m_shards[nIdx].lock, NULL);
+    }
+    m_nLastReport = PerfNode::TimeStamp();
+    return;
+}
+
+PerfAsyncSpans::~PerfAsyncSpans()
+{
+    for(uint32_t nIdx = 0; nIdx < ASYNC_SPAN_SHARDS; nIdx++) {
+        pthread_mutex_destroy(&m_shards[nIdx].lock);
+    }
+
+    auto it = m_aggregates.begin();
+    while(it != m_aggregates.end()) {
+        delete it->second.pNode;
+        it++;
+    }
+    return;
+}
+
+PerfAsyncSpans::Shard* PerfAsyncSpans::GetShard(uint64_t nID)
+{
+    // IDs are often pointers or sequence numbers, mix the bits before picking a shard
+    uint64_t nHash = nID * 0x9E3779B97F4A7C15ULL;
+    return &m_shards[nHash >> 60 & (ASYNC_SPAN_SHARDS - 1)];
+}
+
+bool PerfAsyncSpans::Begin(const char* szName, uint64_t nID, pthread_t tID, uint64_t nTimeStamp)
+{
+    bool    retVal      = true;
+    bool    bReplaced   = false;
+    Shard*  pShard      = GetShard(nID);
+
+    pthread_mutex_lock(&pShard->lock);
+    auto it = pShard->spans.find(nID);
+    if(it != pShard->spans.end()) {
+        // ID reused before the previous span was ended, restart it
+        bReplaced = true;
+        it->second.name         = szName;
+        it->second.nStartTime   = nTimeStamp;
+        it->second.tBegin       = tID;
+    }
+    else if(pShard->spans.size() < ASYNC_MAX_OPEN_PER_SHARD) {
+        AsyncSpan& span = pShard->spans[nID];
+        span.name       = szName;
+        span.nStartTime = nTimeStamp;
+        span.tBegin     = tID;
+    }
+    else {
+        retVal = false;
+    }
+    pthread_mutex_unlock(&pShard->lock);
+
+    if(bReplaced) {
+        LOG(eTrace, "Async span %llu <%s> begun again before it ended\n", nID, szName);
+        SCOPED_LOCK();
+        m_nReplaced++;
+    }
+    if(!retVal && (s_nDropped++ % 1000) == 0) {
+        LOG(eError, "Async span table full, dropping <%s> (%llu dropped)\n", szName, s_nDropped.load());
+    }
+
+    return retVal;
+}
+
+bool PerfAsyncSpans::End(uint64_t nID, uint64_t nTimeStamp)
+{
+    bool        retVal  = false;
+    AsyncSpan   span;
+    Shard*      pShard  = GetShard(nID);
+
+    pthread_mutex_lock(&pShard->lock);
+    auto it = pShard->spans.find(nID);
+    if(it != pShard->spans.end()) {
+        span.name.swap(it->second.name);
+        span.nStartTime = it->second.nStartTime;
+        span.tBegin     = it->second.tBegin;
+        pShard->spans.erase(it);
+        retVal = true;
+    }
+    pthread_mutex_unlock(&pShard->lock);
+
+    SCOPED_LOCK();
+    if(retVal) {
+        uint64_t nElapsed = (nTimeStamp > span.nStartTime) ? nTimeStamp - span.nStartTime : 0;
+        Aggregate(span, nElapsed);
+    }
+    else {
+        LOG(eTrace, "Async span %llu ended but was never begun\n", nID);
+        m_nUnmatched++;
+    }
+
+    return retVal;
+}
+
+// Must be called with the lock held
+void PerfAsyncSpans::Aggregate(AsyncSpan& span, uint64_t nElapsed)
+{
+    auto it = m_aggregates.find(span.name);
+    if(it == m_aggregates.end()) {
+        it = m_aggregates.insert(std::pair<std::string, AsyncAggregate>(span.name, AsyncAggregate())).first;
+        it->second.pNode = new PerfNode((char*)span.name.c_str(), span.tBegin, span.nStartTime);
+    }
+
+    it->second.pNode->IncrementData(nElapsed, 0, 0);
+    it->second.total.Add(nElapsed);
+    it->second.interval.Add(nElapsed);
+}
+
+size_t PerfAsyncSpans::GetOpenCount()
+{
+    size_t nCount = 0;
+    for(uint32_t nIdx = 0; nIdx < ASYNC_SPAN_SHARDS; nIdx++) {
+        pthread_mutex_lock(&m_shards[nIdx].lock);
+        nCount += m_shards[nIdx].spans.size();
+        pthread_mutex_unlock(&m_shards[nIdx].lock);
+    }
+    return nCount;
+}
+
+void PerfAsyncSpans::ReportData()
+{
+    SCOPED_LOCK();
+
+    uint64_t nNow = PerfNode::TimeStamp();
+    uint32_t msIntervalTime = (uint32_t)((nNow - m_nLastReport) / 1000);
+    m_nLastReport = nNow;
+
+    if(m_aggregates.empty() && m_nUnmatched == 0) {
+        return;
+    }
+
+    LOG(eWarning, "Async spans for process %X, %d open, %llu ended without begin, %llu begun twice\n",
+        (uint32_t)m_idProcess, (int)GetOpenCount(), m_nUnmatched, m_nReplaced);
+
+    auto it = m_aggregates.begin();
+    while(it != m_aggregates.end()) {
+        char szTotal[128];
+        char szInterval[128];
+
+        it->second.total.Format(szTotal, sizeof(szTotal));
+        it->second.interval.Format(szInterval, sizeof(szInterval));
+        it->second.pNode->ReportData(1, false, msIntervalTime);
+        LOG(eWarning, "  | latency ms Total %s Interval %s\n", szTotal, szInterval);
+        it->second.interval.Reset();
+        it++;
+    }
+}
+
+//--------------------- Span Map Tools ----------------------
+PerfAsyncSpans* PerfAsyncSpans::Local()
+{
+    PerfAsyncSpans* pSpans = s_pLocal.load(std::memory_order_acquire);
+    if(pSpans == NULL) {
+        pSpans = GetSpans(getpid(), true);
+        s_pLocal.store(pSpans, std::memory_order_release);
+    }
+    return pSpans;
+}
+
+PerfAsyncSpans* PerfAsyncSpans::GetSpans(pid_t pID, bool bCreate)
+{
+    PerfAsyncSpans* retVal = NULL;
+
+    SCOPED_LOCK();
+
+    if(s_pSpansMap == NULL) {
+        if(!bCreate) return NULL;
+        s_pSpansMap = new std::map<pid_t, PerfAsyncSpans*>();
+    }
+
+    auto it = s_pSpansMap->find(pID);
+    if(it != s_pSpansMap->end()) {
+        retVal = it->second;
+    }
+    else if(bCreate) {
+        retVal = new PerfAsyncSpans(pID);
+        (*s_pSpansMap)[pID] = retVal;
+    }
+
+    return retVal;
+}
+
+void PerfAsyncSpans::RemoveSpans(pid_t pID)
+{
+    SCOPED_LOCK();
+
+    // The spans of this process stay alive, Local() hands out an unlocked pointer
+    if(s_pSpansMap == NULL || pID == getpid()) return;
+
+    auto it = s_pSpansMap->find(pID);
+    if(it != s_pSpansMap->end()) {
+        delete it->second;
+        s_pSpansMap->erase(it);
+    }
+}
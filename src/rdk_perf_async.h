@@ -0,0 +1,90 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef __RDK_PERF_ASYNC_H__
+#define __RDK_PERF_ASYNC_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <string>
+#include <map>
+#include <unordered_map>
+
+#include "rdk_perf_histogram.h"
+
+// Open spans are spread over shards by ID so that begin/end calls made from
+// different threads rarely contend.  Aggregation of closed spans is done
+// under the global lock, the same as the thread trees.
+#define ASYNC_SPAN_SHARDS 16
+
+// Forward decls
+class PerfNode;
+
+typedef struct _AsyncSpan
+{
+    std::string         name;
+    uint64_t            nStartTime;
+    pthread_t           tBegin;
+} AsyncSpan;
+
+typedef struct _AsyncAggregate
+{
+    PerfNode*           pNode;
+    PerfHistogram       total;
+    PerfHistogram       interval;
+} AsyncAggregate;
+
+class PerfAsyncSpans
+{
+public:
+    PerfAsyncSpans(pid_t pID);
+    ~PerfAsyncSpans();
+
+    bool Begin(const char* szName, uint64_t nID, pthread_t tID, uint64_t nTimeStamp);
+    bool End(uint64_t nID, uint64_t nTimeStamp);
+    size_t GetOpenCount();
+    void ReportData();
+
+    // Spans for this process, created on first use and kept until unload
+    static PerfAsyncSpans* Local();
+    // Spans for any process, used by perfservice and replay
+    static PerfAsyncSpans* GetSpans(pid_t pID, bool bCreate);
+    static void RemoveSpans(pid_t pID);
+
+private:
+    typedef struct _Shard
+    {
+        pthread_mutex_t                         lock;
+        std::unordered_map<uint64_t, AsyncSpan> spans;
+    } Shard;
+
+    Shard* GetShard(uint64_t nID);
+    void Aggregate(AsyncSpan& span, uint64_t nElapsed);
+
+    pid_t                                   m_idProcess;
+    Shard                                   m_shards[ASYNC_SPAN_SHARDS];
+    std::map<std::string, AsyncAggregate>   m_aggregates;
+    uint64_t                                m_nUnmatched;
+    uint64_t                                m_nReplaced;
+    uint64_t                                m_nLastReport;
+};
+
+#endif // __RDK_PERF_ASYNC_H__
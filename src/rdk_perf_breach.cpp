@@ -0,0 +1,208 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <map>
+#include <list>
+#include <atomic>
+
+#include "rdk_perf_breach.h"
+#include "rdk_perf_record.h"
+#include "rdk_perf_logging.h"
+
+typedef struct _BreachWindow
+{
+    uint64_t            nStart;         // us
+    uint64_t            nCount;         // Breaches in the window, including the reported one
+    uint64_t            nWorst;
+} BreachWindow;
+
+typedef struct _BreachSummary
+{
+    std::string         name;
+    uint64_t            nCount;
+    uint64_t            nWorst;
+    uint64_t            nDuration;      // us
+} BreachSummary;
+
+// Protects everything below, never held while logging
+static pthread_mutex_t                      s_lock = PTHREAD_MUTEX_INITIALIZER;
+static std::map<std::string, BreachWindow>  s_windows;
+static std::list<PerfBreach*>               s_queue;
+static std::list<BreachSummary>             s_summaries;
+static uint32_t                             s_nDropped = 0;
+
+static std::atomic<PerfBreachWakeHook>      s_pWakeHook(NULL);
+
+bool PerfBreachQueue::Count(const std::string& name, uint64_t nElapsedUS)
+{
+    bool        bReport = false;
+    uint64_t    nNow    = PerfRecord::TimeStamp();
+
+    pthread_mutex_lock(&s_lock);
+    auto it = s_windows.find(name);
+    if(it == s_windows.end()) {
+        BreachWindow window = { nNow, 1, nElapsedUS };
+        s_windows[name] = window;
+        bReport = true;
+    }
+    else {
+        BreachWindow& window = it->second;
+        if(nNow - window.nStart >= (uint64_t)BREACH_WINDOW_MS * 1000) {
+            // Window over before the report thread got to it
+            if(window.nCount > 1) {
+                BreachSummary summary = { name, window.nCount, window.nWorst, nNow - window.nStart };
+                s_summaries.push_back(summary);
+            }
+            window.nStart = nNow;
+            window.nCount = 1;
+            window.nWorst = nElapsedUS;
+            bReport = true;
+        }
+        else {
+            window.nCount++;
+            if(window.nWorst < nElapsedUS) {
+                window.nWorst = nElapsedUS;
+            }
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+
+    return bReport;
+}
+
+void PerfBreachQueue::Post(PerfBreach* pBreach)
+{
+    pthread_mutex_lock(&s_lock);
+    if(s_queue.size() >= BREACH_QUEUE_MAX) {
+        s_nDropped++;
+        delete pBreach;
+    }
+    else {
+        s_queue.push_back(pBreach);
+    }
+    pthread_mutex_unlock(&s_lock);
+
+    // Without a hook the queue waits for the next Report() or Flush()
+    PerfBreachWakeHook pHook = s_pWakeHook.load();
+    if(pHook != NULL) {
+        pHook();
+    }
+}
+
+void PerfBreachQueue::SetWakeHook(PerfBreachWakeHook pHook)
+{
+    s_pWakeHook = pHook;
+}
+
+void PerfBreachQueue::Report()
+{
+    Drain(false);
+}
+
+void PerfBreachQueue::Flush()
+{
+    Drain(true);
+}
+
+void PerfBreachQueue::Drain(bool bAll)
+{
+    std::list<PerfBreach*>      queue;
+    std::list<BreachSummary>    summaries;
+    uint32_t                    nDropped;
+    uint64_t                    nNow = PerfRecord::TimeStamp();
+
+    pthread_mutex_lock(&s_lock);
+    queue.swap(s_queue);
+    summaries.swap(s_summaries);
+    nDropped = s_nDropped;
+    s_nDropped = 0;
+
+    auto it = s_windows.begin();
+    while(it != s_windows.end()) {
+        BreachWindow& window = it->second;
+        if(bAll || nNow - window.nStart >= (uint64_t)BREACH_WINDOW_MS * 1000) {
+            if(window.nCount > 1) {
+                BreachSummary summary = { it->first, window.nCount, window.nWorst, nNow - window.nStart };
+                summaries.push_back(summary);
+            }
+            // The next breach starts a new window with a detailed report
+            it = s_windows.erase(it);
+        }
+        else {
+            it++;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+
+    auto itBreach = queue.begin();
+    while(itBreach != queue.end()) {
+        LogBreach(*itBreach);
+        delete *itBreach;
+        itBreach++;
+    }
+
+    auto itSummary = summaries.begin();
+    while(itSummary != summaries.end()) {
+        LOG(eWarning, "%s breached its threshold %llu times in last %0.1lf s, worst %0.3lf ms\n",
+            itSummary->name.c_str(), itSummary->nCount,
+            (double)itSummary->nDuration / 1000000.0, (double)itSummary->nWorst / 1000.0);
+        itSummary++;
+    }
+
+    if(nDropped != 0) {
+        LOG(eWarning, "Dropped %u threshold reports, queue full\n", nDropped);
+    }
+}
+
+void PerfBreachQueue::LogBreach(const PerfBreach* pBreach)
+{
+    LOG(eWarning, "%s Threshold %ld exceeded, elapsed time = %0.3lf ms Avg time = %0.3lf ms (last %u s %0.3lf ms, %llu calls)\n",
+        pBreach->name.c_str(),
+        pBreach->nThresholdUS / 1000,
+        ((double)pBreach->nElapsedUS) / 1000.0,
+        pBreach->nTotalAvg / 1000.0,
+        BREACH_WINDOW_MS / 1000,
+        pBreach->nWindowAvg / 1000.0,
+        (unsigned long long)pBreach->nWindowCount);
+    LOG(eWarning, "| %s elapsed time %0.3lf thread %X\n",
+        pBreach->name.c_str(), ((double)pBreach->nElapsedUS) / 1000.0, (uint32_t)pBreach->tID);
+
+    auto it = pBreach->children.begin();
+    while(it != pBreach->children.end()) {
+        LOG(eWarning, "--| %s elapsed time %0.3lf (%u calls)\n",
+            it->name.c_str(), (double)it->nTime / 1000.0, it->nCount);
+        it++;
+    }
+    if(pBreach->nOtherChildTime != 0) {
+        LOG(eWarning, "--| other elapsed time %0.3lf\n", (double)pBreach->nOtherChildTime / 1000.0);
+    }
+
+    if(pBreach->schedEnd.bValid) {
+        char szSched[256];
+        PerfSched::Format(szSched, sizeof(szSched), &pBreach->schedStart, &pBreach->schedEnd, pBreach->nElapsedUS);
+        LOG(eWarning, "%s scheduling: %s\n", pBreach->name.c_str(), szSched);
+    }
+}
@@ -0,0 +1,83 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef __RDK_PERF_BREACH_H__
+#define __RDK_PERF_BREACH_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <string>
+#include <vector>
+
+#include "rdk_perf_sched.h"
+
+#define BREACH_WINDOW_MS    10000   // One detailed report per scope name and window
+#define BREACH_QUEUE_MAX    64      // Detailed reports waiting to be logged
+
+typedef struct _BreachChild
+{
+    std::string         name;
+    uint32_t            nCount;
+    uint64_t            nTime;
+} BreachChild;
+
+// Everything needed to log a breach after the scope and its node are gone
+typedef struct _PerfBreach
+{
+    std::string         name;
+    pthread_t           tID;
+    int32_t             nThresholdUS;
+    uint64_t            nElapsedUS;
+    double              nTotalAvg;
+    double              nWindowAvg;     // Last BREACH_WINDOW_MS and the second in progress
+    uint64_t            nWindowCount;
+    std::vector<BreachChild> children;
+    uint64_t            nOtherChildTime;
+    SchedSnapshot       schedStart;     // Only valid with PERF_SCHED_STATS
+    SchedSnapshot       schedEnd;
+} PerfBreach;
+
+typedef void (*PerfBreachWakeHook)();
+
+// Threshold breaches are logged by the report thread instead of the
+// destructor of the breaching scope.  Per scope name only the first breach
+// of a window is reported in detail, the following ones are counted and
+// summarized when the window ends.
+class PerfBreachQueue
+{
+public:
+    // Counts the breach, true when it should be reported in detail
+    static bool Count(const std::string& name, uint64_t nElapsedUS);
+    // Takes ownership of the breach and wakes the thread that reports it
+    static void Post(PerfBreach* pBreach);
+    // Called by Post(), the thread woken up calls Report()
+    static void SetWakeHook(PerfBreachWakeHook pHook);
+    // Logs queued breaches and the summaries of ended windows on the calling thread
+    static void Report();
+    // Logs queued breaches and all open summaries on the calling thread
+    static void Flush();
+
+private:
+    static void Drain(bool bAll);
+    static void LogBreach(const PerfBreach* pBreach);
+};
+
+#endif // __RDK_PERF_BREACH_H__
@@ -0,0 +1,167 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <set>
+
+#include "rdk_perf_cadence.h"
+#include "rdk_perf_node.h"
+#include "rdk_perf_logging.h"
+#include "rdk_perf_scopedlock.h"
+
+// Cadences of this process, for the process report
+static std::set<PerfCadence*>* s_pCadences = NULL;
+
+PerfCadence::PerfCadence(const char* szName, uint32_t nExpectedPeriodUS)
+: m_nExpectedUS(nExpectedPeriodUS)
+, m_nLastArrival(0)
+, m_nLate(0)
+, m_nMissed(0)
+, m_nPauses(0)
+, m_nTotalLate(0)
+, m_nTotalMissed(0)
+{
+    pthread_spin_init(&m_lock, PTHREAD_PROCESS_PRIVATE);
+    m_pNode = new PerfNode((char*)szName, pthread_self(), TimeStamp());
+
+    SCOPED_LOCK();
+    if(s_pCadences == NULL) {
+        s_pCadences = new std::set<PerfCadence*>();
+    }
+    s_pCadences->insert(this);
+    return;
+}
+
+PerfCadence::~PerfCadence()
+{
+    {
+        SCOPED_LOCK();
+        s_pCadences->erase(this);
+        if(s_pCadences->empty()) {
+            delete s_pCadences;
+            s_pCadences = NULL;
+        }
+    }
+
+    delete m_pNode;
+    pthread_spin_destroy(&m_lock);
+    return;
+}
+
+uint64_t PerfCadence::TimeStamp()
+{
+    struct timespec timeStamp;
+    clock_gettime(CLOCK_MONOTONIC, &timeStamp);
+    return ((uint64_t)timeStamp.tv_sec * 1000000) + (timeStamp.tv_nsec / 1000);
+}
+
+void PerfCadence::Tick()
+{
+    Tick(TimeStamp());
+}
+
+void PerfCadence::Tick(uint64_t nTimeStamp)
+{
+    pthread_spin_lock(&m_lock);
+
+    if(m_nLastArrival != 0 && nTimeStamp > m_nLastArrival) {
+        uint64_t nDelta = nTimeStamp - m_nLastArrival;
+
+        if(m_nExpectedUS != 0 && nDelta > (uint64_t)m_nExpectedUS * CADENCE_PAUSE_PERIODS) {
+            // Stream was paused, start measuring again from this arrival
+            m_nPauses++;
+        }
+        else {
+            m_pNode->IncrementData(nDelta, 0, 0);
+
+            if(m_nExpectedUS != 0) {
+                m_jitter.Add(nDelta > m_nExpectedUS ? nDelta - m_nExpectedUS : m_nExpectedUS - nDelta);
+
+                if(nDelta > m_nExpectedUS + m_nExpectedUS / CADENCE_LATE_FRACTION) {
+                    // Round to the nearest number of periods, one of them is this arrival
+                    uint64_t nPeriods = (nDelta + m_nExpectedUS / 2) / m_nExpectedUS;
+                    if(nPeriods > 1) {
+                        m_nMissed += nPeriods - 1;
+                    }
+                    else {
+                        m_nLate++;
+                    }
+                }
+            }
+        }
+    }
+    m_nLastArrival = nTimeStamp;
+
+    pthread_spin_unlock(&m_lock);
+}
+
+void PerfCadence::ReportData()
+{
+    char            szJitter[128];
+    PerfHistogram   jitter;
+
+    // Copy and reset the interval, print without holding the lock
+    pthread_spin_lock(&m_lock);
+    TimingStats stats   = *m_pNode->GetStats();
+    uint64_t nLate      = m_nLate;
+    uint64_t nMissed    = m_nMissed;
+    uint64_t nPauses    = m_nPauses;
+    jitter.Merge(m_jitter);
+    m_nTotalLate       += m_nLate;
+    m_nTotalMissed     += m_nMissed;
+    uint64_t nTotalLate     = m_nTotalLate;
+    uint64_t nTotalMissed   = m_nTotalMissed;
+    m_nLate   = 0;
+    m_nMissed = 0;
+    m_jitter.Reset();
+    m_pNode->ResetInterval();
+    pthread_spin_unlock(&m_lock);
+
+    double expectedHz = (m_nExpectedUS == 0) ? 0.0 : 1000000.0 / (double)m_nExpectedUS;
+    double actualHz   = (stats.nIntervalAvg == 0) ? 0.0 : 1000000.0 / stats.nIntervalAvg;
+
+    LOG(eWarning, "Cadence %s expected %0.2f Hz actual %0.2f Hz, Interval late %llu missed %llu, Total late %llu missed %llu, pauses %llu\n",
+        stats.elementName.c_str(), expectedHz, actualHz,
+        nLate, nMissed, nTotalLate, nTotalMissed, nPauses);
+    LOG(eWarning, "--| period (Count, Max, Min, Avg) Total %llu, %0.3lf, %0.3lf, %0.3lf Interval %llu, %0.3lf, %0.3lf, %0.3lf\n",
+        stats.nTotalCount, ((double)stats.nTotalMax) / 1000.0, ((double)stats.nTotalMin) / 1000.0, stats.nTotalAvg / 1000.0,
+        stats.nIntervalCount, ((double)stats.nIntervalMax) / 1000.0, ((double)stats.nIntervalMin) / 1000.0, stats.nIntervalAvg / 1000.0);
+    if(m_nExpectedUS != 0) {
+        jitter.Format(szJitter, sizeof(szJitter));
+        LOG(eWarning, "  | jitter ms %s\n", szJitter);
+    }
+}
+
+void PerfCadence::ReportAll()
+{
+    SCOPED_LOCK();
+
+    if(s_pCadences == NULL) {
+        return;
+    }
+
+    auto it = s_pCadences->begin();
+    while(it != s_pCadences->end()) {
+        (*it)->ReportData();
+        it++;
+    }
+}
@@ -0,0 +1,67 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef __RDK_PERF_CADENCE_H__
+#define __RDK_PERF_CADENCE_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <string>
+
+#include "rdk_perf_histogram.h"
+
+// An arrival more than 1/CADENCE_LATE_FRACTION of a period after the expected
+// time is late.  A gap longer than CADENCE_PAUSE_PERIODS periods is treated
+// as the stream being paused, not as missed periods.
+#define CADENCE_LATE_FRACTION   4
+#define CADENCE_PAUSE_PERIODS   32
+
+// Forward decls
+class PerfNode;
+
+class PerfCadence
+{
+public:
+    PerfCadence(const char* szName, uint32_t nExpectedPeriodUS);
+    ~PerfCadence();
+
+    void Tick();
+    void Tick(uint64_t nTimeStamp);
+    void ReportData();
+
+    // Monotonic time in us, inter-arrival times must not jump with the wall clock
+    static uint64_t TimeStamp();
+    static void ReportAll();
+
+private:
+    pthread_spinlock_t  m_lock;             // Held only to update or copy the data
+    PerfNode*           m_pNode;            // Inter-arrival time statistics
+    uint32_t            m_nExpectedUS;
+    uint64_t            m_nLastArrival;
+    PerfHistogram       m_jitter;           // |actual - expected| in the interval
+    uint64_t            m_nLate;
+    uint64_t            m_nMissed;
+    uint64_t            m_nPauses;
+    uint64_t            m_nTotalLate;
+    uint64_t            m_nTotalMissed;
+};
+
+#endif // __RDK_PERF_CADENCE_H__
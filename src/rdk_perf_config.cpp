@@ -0,0 +1,491 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <libgen.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <regex.h>
+#include <sys/inotify.h>
+
+#include <string>
+#include <vector>
+#include <set>
+
+#include "rdk_perf_config.h"
+#include "rdk_perf_schedule.h"
+#include "rdk_perf_control.h"
+#include "rdk_perf_logging.h"
+#include "rdk_perf_scopedlock.h"
+
+#define CONFIG_LINE_SIZE    256
+
+typedef struct _ConfigRule
+{
+    std::string         name;
+    bool                bPrefix;        // name ended in '*'
+    int32_t             nThresholdUS;   // -1 not set by this rule
+    int32_t             nSample;        // -1 not set by this rule
+    bool                bWindow;
+} ConfigRule;
+
+typedef struct _ThreadGroupRule
+{
+    std::string         group;
+    std::string         pattern;
+    bool                bPrefix;        // pattern ended in '*'
+    regex_t*            pRegex;         // pattern started with '~'
+} ThreadGroupRule;
+
+class PerfConfigSet
+{
+public:
+    PerfConfigSet() : bThreadDetail(false), bProcessView(false), bFlightRecorder(false)
+    {
+        PerfReportScheduler::Default(&schedule);
+        memset(&history, 0, sizeof(history));
+    };
+    ~PerfConfigSet()
+    {
+        for(auto it = groups.begin(); it != groups.end(); it++) {
+            if(it->pRegex != NULL) {
+                regfree(it->pRegex);
+                delete it->pRegex;
+            }
+        }
+    };
+
+    std::vector<ConfigRule> rules;
+    std::vector<ThreadGroupRule> groups;
+    std::vector<std::string> disabled;      // For the PerfControl name filter
+    bool                    bThreadDetail;
+    bool                    bProcessView;
+    bool                    bFlightRecorder;
+    ReportSchedule          schedule;
+    HistoryConfig           history;
+    std::string             sink;
+};
+
+std::atomic<uint32_t>   PerfConfig::s_nGeneration(1);
+PerfConfigSet*          PerfConfig::s_pActive = NULL;
+
+// Names given to RDKPerfGetWindowStats(), under the lock
+static std::set<std::string>*   s_pWindowNames = NULL;
+
+void PerfConfig::LoadFromEnv()
+{
+    static std::atomic<bool> s_bLoaded(false);
+    if(s_bLoaded.exchange(true)) {
+        return;
+    }
+
+    const char* szFileName = getenv(RDK_PERF_CONFIG_ENV);
+    if(szFileName != NULL && szFileName[0] != '\0') {
+        Load(szFileName);
+        Watch(szFileName);
+    }
+}
+
+void PerfConfig::Resolve(const std::string& name, ScopeConfig* pConfig)
+{
+    pConfig->nThresholdUS   = -1;
+    pConfig->nSample        = 1;
+    pConfig->bWindow        = s_pWindowNames != NULL && s_pWindowNames->count(name) != 0;
+    if(s_pActive == NULL) {
+        return;
+    }
+
+    // The history is taken from the windows of every scope
+    if(s_pActive->history.nResolution != 0) {
+        pConfig->bWindow = true;
+    }
+    for(auto it = s_pActive->rules.begin(); it != s_pActive->rules.end(); it++) {
+        bool bMatch = it->bPrefix ? name.compare(0, it->name.size(), it->name) == 0 : name == it->name;
+        if(bMatch) {
+            if(it->nThresholdUS >= 0)   pConfig->nThresholdUS = it->nThresholdUS;
+            if(it->nSample >= 0)        pConfig->nSample = (uint32_t)it->nSample;
+            if(it->bWindow)             pConfig->bWindow = true;
+        }
+    }
+}
+
+void PerfConfig::RequestWindow(const std::string& name)
+{
+    if(s_pWindowNames == NULL) {
+        s_pWindowNames = new std::set<std::string>();
+    }
+    if(s_pWindowNames->insert(name).second) {
+        // Nodes resolve their settings again
+        s_nGeneration.fetch_add(1);
+    }
+}
+
+bool PerfConfig::ResolveThreadGroup(const char* szThreadName, std::string* pGroup)
+{
+    if(s_pActive == NULL || szThreadName == NULL) {
+        return false;
+    }
+
+    for(auto it = s_pActive->groups.begin(); it != s_pActive->groups.end(); it++) {
+        bool bMatch = false;
+        if(it->pRegex != NULL) {
+            bMatch = regexec(it->pRegex, szThreadName, 0, NULL, 0) == 0;
+        }
+        else if(it->bPrefix) {
+            bMatch = strncmp(szThreadName, it->pattern.c_str(), it->pattern.size()) == 0;
+        }
+        else {
+            bMatch = it->pattern == szThreadName;
+        }
+        if(bMatch) {
+            *pGroup = it->group;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PerfConfig::ShowThreadDetail()
+{
+    return s_pActive != NULL && s_pActive->bThreadDetail;
+}
+
+bool PerfConfig::ShowProcessView()
+{
+    return s_pActive != NULL && s_pActive->bProcessView;
+}
+
+bool PerfConfig::FlightRecorder()
+{
+    return s_pActive != NULL && s_pActive->bFlightRecorder;
+}
+
+void PerfConfig::GetReportSchedule(ReportSchedule* pSchedule)
+{
+    SCOPED_LOCK();
+    if(s_pActive != NULL) {
+        *pSchedule = s_pActive->schedule;
+    }
+    else {
+        PerfReportScheduler::Default(pSchedule);
+    }
+}
+
+void PerfConfig::GetHistory(HistoryConfig* pHistory)
+{
+    SCOPED_LOCK();
+    if(s_pActive != NULL) {
+        *pHistory = s_pActive->history;
+    }
+    else {
+        memset(pHistory, 0, sizeof(HistoryConfig));
+    }
+}
+
+static bool ParseNumber(const char* szValue, int32_t* pValue)
+{
+    char* szEnd = NULL;
+    long  nValue = strtol(szValue, &szEnd, 10);
+    if(szEnd == szValue || *szEnd != '\0' || nValue < 0 || nValue > INT32_MAX) {
+        return false;
+    }
+    *pValue = (int32_t)nValue;
+    return true;
+}
+
+PerfConfigSet* PerfConfig::Parse(const char* szFileName)
+{
+    FILE* fp = fopen(szFileName, "r");
+    if(fp == NULL) {
+        LOG(eError, "Could not open configuration %s (%s)\n", szFileName, strerror(errno));
+        return NULL;
+    }
+
+    PerfConfigSet*  pSet    = new PerfConfigSet();
+    char            szLine[CONFIG_LINE_SIZE];
+    uint32_t        nLine   = 0;
+    bool            bValid  = true;
+
+    while(bValid && fgets(szLine, sizeof(szLine), fp) != NULL) {
+        nLine++;
+        char* szComment = strchr(szLine, '#');
+        if(szComment != NULL) *szComment = '\0';
+
+        char* szSave    = NULL;
+        char* szKey     = strtok_r(szLine, " \t\r\n", &szSave);
+        char* szArg1    = strtok_r(NULL, " \t\r\n", &szSave);
+        char* szArg2    = strtok_r(NULL, " \t\r\n", &szSave);
+        if(szKey == NULL) {
+            continue;
+        }
+        const char* szMore[3];
+        uint32_t    nMore = 0;
+        while(nMore < 3 && (szMore[nMore] = strtok_r(NULL, " \t\r\n", &szSave)) != NULL) {
+            nMore++;
+        }
+
+        int32_t nValue = 0;
+        if(strcmp(szKey, "report_interval") == 0 && szArg1 != NULL && ParseNumber(szArg1, &nValue)) {
+            // Same as report_schedule fixed, 0 goes back to the default
+            const char* szArgs[1] = { szArg1 };
+            if(nValue == 0) {
+                uint32_t nBudget = pSet->schedule.nCPUBudget;
+                PerfReportScheduler::Default(&pSet->schedule);
+                pSet->schedule.nCPUBudget = nBudget;
+            }
+            else {
+                PerfReportScheduler::Parse(&pSet->schedule, "fixed", szArgs, 1);
+            }
+        }
+        else if(strcmp(szKey, "report_schedule") == 0 && szArg1 != NULL && szArg2 != NULL) {
+            const char* szArgs[4] = { szArg2, szMore[0], szMore[1], szMore[2] };
+            if(!PerfReportScheduler::Parse(&pSet->schedule, szArg1, szArgs, nMore + 1)) {
+                LOG(eError, "Configuration %s line %u is not a valid schedule\n", szFileName, nLine);
+                bValid = false;
+            }
+        }
+        else if(strcmp(szKey, "report_cpu_budget") == 0 && szArg1 != NULL && ParseNumber(szArg1, &nValue) && nValue <= 100) {
+            pSet->schedule.nCPUBudget = (uint32_t)nValue;
+        }
+        else if(strcmp(szKey, "report_trigger") == 0 && szArg1 != NULL && strlen(szArg1) < SCHEDULE_TRIGGER_LEN) {
+            strcpy(pSet->schedule.szTrigger, szArg1);
+        }
+        else if(strcmp(szKey, "log_sink") == 0 && szArg1 != NULL) {
+            pSet->sink = szArg1;
+        }
+        else if((strcmp(szKey, "threshold") == 0 || strcmp(szKey, "sample") == 0) &&
+                szArg1 != NULL && szArg2 != NULL && ParseNumber(szArg2, &nValue)) {
+            bool        bThreshold = szKey[0] == 't';
+            size_t      nLength = strlen(szArg1);
+            ConfigRule  rule;
+            rule.bPrefix        = szArg1[nLength - 1] == '*';
+            rule.name           = std::string(szArg1, rule.bPrefix ? nLength - 1 : nLength);
+            rule.nThresholdUS   = bThreshold ? nValue : -1;
+            rule.nSample        = bThreshold ? -1 : nValue;
+            rule.bWindow        = false;
+            pSet->rules.push_back(rule);
+        }
+        else if(strcmp(szKey, "thread_group") == 0 && szArg1 != NULL && szArg2 != NULL && nMore == 0) {
+            size_t          nLength = strlen(szArg2);
+            ThreadGroupRule rule;
+            rule.group      = szArg1;
+            rule.bPrefix    = szArg2[nLength - 1] == '*';
+            rule.pattern    = std::string(szArg2, rule.bPrefix ? nLength - 1 : nLength);
+            rule.pRegex     = NULL;
+            if(szArg2[0] == '~') {
+                rule.bPrefix    = false;
+                rule.pRegex     = new regex_t;
+                if(regcomp(rule.pRegex, szArg2 + 1, REG_EXTENDED | REG_NOSUB) != 0) {
+                    LOG(eError, "Configuration %s line %u is not a valid regular expression\n", szFileName, nLine);
+                    delete rule.pRegex;
+                    rule.pRegex = NULL;
+                    bValid = false;
+                }
+            }
+            if(bValid) {
+                pSet->groups.push_back(rule);
+            }
+        }
+        else if(strcmp(szKey, "thread_detail") == 0 && szArg1 != NULL &&
+                (strcmp(szArg1, "on") == 0 || strcmp(szArg1, "off") == 0)) {
+            pSet->bThreadDetail = strcmp(szArg1, "on") == 0;
+        }
+        else if(strcmp(szKey, "process_view") == 0 && szArg1 != NULL &&
+                (strcmp(szArg1, "on") == 0 || strcmp(szArg1, "off") == 0)) {
+            pSet->bProcessView = strcmp(szArg1, "on") == 0;
+        }
+        else if(strcmp(szKey, "history") == 0 && szArg1 != NULL && strcmp(szArg1, "off") == 0 && szArg2 == NULL) {
+            memset(&pSet->history, 0, sizeof(HistoryConfig));
+        }
+        else if(strcmp(szKey, "history") == 0 && szArg1 != NULL && szArg2 != NULL && nMore <= 1) {
+            int32_t nResolution, nDuration;
+            int32_t nKB = HISTORY_DEFAULT_KB;
+            if(!ParseNumber(szArg1, &nResolution) || !ParseNumber(szArg2, &nDuration) ||
+               (nMore == 1 && !ParseNumber(szMore[0], &nKB)) ||
+               nResolution == 0 || nResolution > WINDOW_MAX_SECONDS || nDuration < nResolution ||
+               nKB == 0 || nKB > INT32_MAX / 1024) {
+                LOG(eError, "Configuration %s line %u is not a valid history\n", szFileName, nLine);
+                bValid = false;
+            }
+            else {
+                pSet->history.nResolution   = (uint32_t)nResolution;
+                pSet->history.nDuration     = (uint32_t)nDuration;
+                pSet->history.nMaxBytes     = (uint32_t)nKB * 1024;
+            }
+        }
+        else if(strcmp(szKey, "flight_recorder") == 0 && szArg1 != NULL &&
+                (strcmp(szArg1, "on") == 0 || strcmp(szArg1, "off") == 0)) {
+            pSet->bFlightRecorder = strcmp(szArg1, "on") == 0;
+        }
+        else if(strcmp(szKey, "disable") == 0 && szArg1 != NULL && szArg2 == NULL) {
+            if(strlen(szArg1) >= CONTROL_NAME_LEN || pSet->disabled.size() >= CONTROL_NAMES) {
+                LOG(eError, "Configuration %s line %u: at most %u names of up to %u characters can be disabled\n",
+                    szFileName, nLine, CONTROL_NAMES, CONTROL_NAME_LEN - 1);
+                bValid = false;
+            }
+            else {
+                pSet->disabled.push_back(szArg1);
+            }
+        }
+        else if(strcmp(szKey, "window") == 0 && szArg1 != NULL && szArg2 == NULL) {
+            size_t      nLength = strlen(szArg1);
+            ConfigRule  rule;
+            rule.bPrefix        = szArg1[nLength - 1] == '*';
+            rule.name           = std::string(szArg1, rule.bPrefix ? nLength - 1 : nLength);
+            rule.nThresholdUS   = -1;
+            rule.nSample        = -1;
+            rule.bWindow        = true;
+            pSet->rules.push_back(rule);
+        }
+        else {
+            LOG(eError, "Configuration %s line %u is not valid\n", szFileName, nLine);
+            bValid = false;
+        }
+    }
+    fclose(fp);
+
+    if(!bValid) {
+        delete pSet;
+        return NULL;
+    }
+    return pSet;
+}
+
+bool PerfConfig::Load(const char* szFileName)
+{
+    PerfConfigSet* pSet = Parse(szFileName);
+    if(pSet == NULL) {
+        LOG(eError, "Keeping the previous configuration\n");
+        return false;
+    }
+
+    PerfConfigSet* pOld = NULL;
+    {
+        // Nodes resolve their settings under the same lock, none of them
+        // can see half of the new configuration
+        SCOPED_LOCK();
+        pOld = s_pActive;
+        s_pActive = pSet;
+        s_nGeneration.fetch_add(1);
+        PerfControl::SetConfigNames(pSet->disabled);
+        if(pOld == NULL || pOld->sink != pSet->sink) {
+            RDKPerfSetLogSink(pSet->sink.empty() ? NULL : pSet->sink.c_str());
+        }
+    }
+    delete pOld;
+
+    LOG(eWarning, "Loaded configuration %s, %u rules, %u thread groups, log sink %s\n",
+        szFileName, (uint32_t)pSet->rules.size(), (uint32_t)pSet->groups.size(),
+        pSet->sink.empty() ? "stdout" : pSet->sink.c_str());
+    return true;
+}
+
+typedef struct _ConfigWatch
+{
+    int                 fd;
+    std::string         fileName;
+    std::string         baseName;
+} ConfigWatch;
+
+// One file per process, under the lock
+static std::string  s_watchedFile;
+
+bool PerfConfig::Watch(const char* szFileName)
+{
+    SCOPED_LOCK();
+    if(!s_watchedFile.empty()) {
+        if(s_watchedFile == szFileName) {
+            return true;
+        }
+        LOG(eError, "Already watching %s, %s is not watched\n", s_watchedFile.c_str(), szFileName);
+        return false;
+    }
+
+    char*   szDirCopy  = strdup(szFileName);
+    char*   szBaseCopy = strdup(szFileName);
+    ConfigWatch* pWatch = new ConfigWatch();
+    pWatch->fileName    = szFileName;
+    pWatch->baseName    = basename(szBaseCopy);
+
+    // Editors replace the file instead of writing it, so the directory is
+    // watched for the name showing up again.  Added before returning so no
+    // change made after Watch() is missed.
+    pWatch->fd = inotify_init1(IN_CLOEXEC);
+    bool bRetVal = pWatch->fd >= 0 &&
+                   inotify_add_watch(pWatch->fd, dirname(szDirCopy), IN_CLOSE_WRITE | IN_MOVED_TO) >= 0;
+    if(!bRetVal) {
+        LOG(eError, "Could not watch %s (%s), configuration changes need a restart\n", szFileName, strerror(errno));
+    }
+    free(szDirCopy);
+    free(szBaseCopy);
+
+    pthread_t tID;
+    if(bRetVal && pthread_create(&tID, NULL, WatchThread, pWatch) != 0) {
+        LOG(eError, "Could not start the configuration watch thread\n");
+        bRetVal = false;
+    }
+    if(!bRetVal) {
+        if(pWatch->fd >= 0) close(pWatch->fd);
+        delete pWatch;
+        return false;
+    }
+
+    pthread_detach(tID);
+    s_watchedFile = szFileName;
+    return true;
+}
+
+void* PerfConfig::WatchThread(void* pContext)
+{
+    ConfigWatch* pWatch = (ConfigWatch*)pContext;
+
+    pthread_setname_np(pthread_self(), "rdkperf_config");
+
+    alignas(struct inotify_event) char buffer[4096];
+    while(true) {
+        ssize_t nSize = read(pWatch->fd, buffer, sizeof(buffer));
+        if(nSize <= 0) {
+            if(nSize < 0 && errno == EINTR) continue;
+            break;
+        }
+
+        bool bChanged = false;
+        for(char* ptr = buffer; ptr < buffer + nSize; ) {
+            struct inotify_event* pEvent = (struct inotify_event*)ptr;
+            if(pEvent->len > 0 && pWatch->baseName == pEvent->name) {
+                bChanged = true;
+            }
+            ptr += sizeof(struct inotify_event) + pEvent->len;
+        }
+        if(bChanged) {
+            Load(pWatch->fileName.c_str());
+        }
+    }
+
+    close(pWatch->fd);
+    delete pWatch;
+    return NULL;
+}
@@ -0,0 +1,106 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+
+#ifndef __RDK_PERF_CONFIG_H__
+#define __RDK_PERF_CONFIG_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <string>
+
+#include "rdk_perf_schedule.h"
+#include "rdk_perf_history.h"
+
+#define RDK_PERF_CONFIG_ENV     "RDKPERF_CONFIG"
+
+// Settings for one scope name, resolved once per node and configuration
+// so opening a scope only compares a generation number
+typedef struct _ScopeConfig
+{
+    int32_t             nThresholdUS;   // -1 keeps the threshold of the call site
+    uint32_t            nSample;        // Measure 1 in n calls, 0 never
+    bool                bWindow;        // Keep rolling windows
+} ScopeConfig;
+
+class PerfConfigSet;
+
+// Configuration file named by RDKPERF_CONFIG, reloaded whenever the file
+// changes.  A new file is parsed completely before it replaces the old
+// configuration, a file with errors is ignored.
+//
+//  report_interval <seconds>       0 goes back to the default back off
+//  report_schedule fixed <s> | backoff <first s> <step s> <max s> | cron <minute> <hour>
+//  report_cpu_budget <percent>     of one CPU the report thread may use
+//  report_trigger <path>           touching the file requests a report
+//  log_sink stdout|syslog|<path>
+//  threshold <name> <us>           0 removes the threshold of the call site
+//  sample <name> <n>               measure 1 in n calls
+//  disable <name>                  not measured at all, like perfctl disable
+//  window <name>                   keep rolling windows of the scope
+//  thread_group <group> <pattern>  report threads with matching names as one tree
+//  thread_detail on|off            also report the threads of a group one by one
+//  process_view on|off             also report all threads merged by call path
+//  history <s> <duration s> [<KB>] | off   snapshot every <s> (1 to 60) seconds
+//  flight_recorder on|off          dump the last scope events when a threshold is exceeded
+//
+// A name ending in '*' matches every scope starting with the prefix, when
+// several lines match a name the last one wins.  A thread name pattern is
+// either a name, a prefix ending in '*' or an extended regular expression
+// after a '~', the first matching group wins.
+class PerfConfig
+{
+public:
+    static inline uint32_t Generation()
+    {
+        return s_nGeneration.load(std::memory_order_relaxed);
+    };
+
+    // Must be called with the lock held
+    static void Resolve(const std::string& name, ScopeConfig* pConfig);
+    // Scopes with this name keep rolling windows from now on.  Must be
+    // called with the lock held.
+    static void RequestWindow(const std::string& name);
+
+    // Must be called with the lock held
+    static bool ResolveThreadGroup(const char* szThreadName, std::string* pGroup);
+    static bool ShowThreadDetail();
+    static bool ShowProcessView();
+    static bool FlightRecorder();
+
+    static void GetReportSchedule(ReportSchedule* pSchedule);
+    static void GetHistory(HistoryConfig* pHistory);
+    static bool Load(const char* szFileName);
+    // One file per process, false for another one
+    static bool Watch(const char* szFileName);
+    // Loads and watches RDKPERF_CONFIG, once per process.  Called when the
+    // process starts recording, not at library load.
+    static void LoadFromEnv();
+
+private:
+    static PerfConfigSet* Parse(const char* szFileName);
+    static void* WatchThread(void* pContext);
+
+    static std::atomic<uint32_t>    s_nGeneration;
+    static PerfConfigSet*           s_pActive;
+};
+
+#endif // __RDK_PERF_CONFIG_H__
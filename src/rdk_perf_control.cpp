@@ -0,0 +1,317 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "rdk_perf_control.h"
+#include "rdk_perf_logging.h"
+#include "rdk_perf_scopedlock.h"
+
+#define CONTROL_READ_RETRIES    100
+
+// Used until the shared block is mapped, and instead of it when it can not be
+static PerfControlBlock         s_localBlock;
+
+std::atomic<std::atomic<uint32_t>*> PerfControl::s_pFlags(&s_localBlock.nFlags);
+std::atomic<PerfControlBlock*>      PerfControl::s_pBlock(&s_localBlock);
+std::atomic<bool>                   PerfControl::s_bAttached(false);
+PerfControlBlock                    PerfControl::s_configBlock;
+static bool                         s_bShared   = false;
+static bool                         s_bReadOnly = false;
+
+void PerfControl::AttachShared()
+{
+    SCOPED_LOCK();
+    if(s_bAttached.load()) {
+        return;
+    }
+    // Not tried again when it fails
+    s_bAttached.store(true, std::memory_order_release);
+
+    const char* szName = getenv(RDK_PERF_CONTROL_ENV);
+    if(szName == NULL || szName[0] == '\0') {
+        szName = RDK_PERF_CONTROL_NAME;
+    }
+
+    // Whoever comes first creates the block, a zero filled block is valid
+    bool bReadOnly = false;
+    int fd = shm_open(szName, O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+    if(fd >= 0) {
+        fchmod(fd, 0666);   // Not limited by the umask of the first process
+    }
+    else if(errno == EACCES) {
+        fd = shm_open(szName, O_RDONLY | O_CLOEXEC, 0);
+        bReadOnly = true;
+    }
+    if(fd < 0) {
+        LOG(eError, "Could not open control block %s (%s), using a private one\n", szName, strerror(errno));
+        return;
+    }
+
+    struct stat info;
+    if(fstat(fd, &info) != 0 ||
+       ((size_t)info.st_size < sizeof(PerfControlBlock) && (bReadOnly || ftruncate(fd, sizeof(PerfControlBlock)) != 0))) {
+        LOG(eError, "Could not size control block %s, using a private one\n", szName);
+        close(fd);
+        return;
+    }
+
+    void* pMap = mmap(NULL, sizeof(PerfControlBlock), bReadOnly ? PROT_READ : (PROT_READ | PROT_WRITE), MAP_SHARED, fd, 0);
+    close(fd);
+    if(pMap == MAP_FAILED) {
+        LOG(eError, "Could not map control block %s (%s), using a private one\n", szName, strerror(errno));
+        return;
+    }
+
+    PerfControlBlock* pBlock = (PerfControlBlock*)pMap;
+    if(pBlock->nVersion == 0 && !bReadOnly) {
+        pBlock->nVersion = CONTROL_VERSION;
+    }
+    else if(pBlock->nVersion != CONTROL_VERSION && pBlock->nVersion != 0) {
+        LOG(eError, "Control block %s has version %u, expected %u, using a private one\n",
+            szName, pBlock->nVersion, CONTROL_VERSION);
+        munmap(pMap, sizeof(PerfControlBlock));
+        return;
+    }
+
+    // Never unmapped, other threads may be reading it at any time
+    s_bReadOnly = bReadOnly;
+    s_bShared   = true;
+    s_pBlock.store(pBlock, std::memory_order_release);
+    s_pFlags.store(&pBlock->nFlags, std::memory_order_release);
+}
+
+void PerfControl::SetEnabled(bool bEnable)
+{
+    Attach();
+    if(s_bReadOnly) {
+        LOG(eError, "Control block is read only\n");
+        return;
+    }
+    if(bEnable) {
+        Flags()->fetch_and(~(uint32_t)eControlDisabled);
+    }
+    else {
+        Flags()->fetch_or(eControlDisabled);
+    }
+}
+
+bool PerfControl::IsGloballyEnabled()
+{
+    Attach();
+    return (Flags()->load() & eControlDisabled) == 0;
+}
+
+bool PerfControl::IsShared()
+{
+    Attach();
+    return s_bShared;
+}
+
+// Writers serialize on the pid in nWriter and keep the sequence number odd
+// while they change names[], readers retry while it is odd or changed under
+// them.  A writer that was killed holding the block is detected with
+// kill(pid, 0) and its lock taken over, the sequence it left odd is closed
+// by the next Unlock().
+bool PerfControl::Lock()
+{
+    Attach();
+    PerfControlBlock* pBlock = Block();
+    if(s_bReadOnly) {
+        LOG(eError, "Control block is read only\n");
+        return false;
+    }
+
+    int32_t nSelf = (int32_t)getpid();
+    for(uint32_t nTry = 0; nTry < CONTROL_READ_RETRIES * 10; nTry++) {
+        int32_t nWriter = 0;
+        bool    bLocked = pBlock->nWriter.compare_exchange_strong(nWriter, nSelf);
+        if(!bLocked && kill((pid_t)nWriter, 0) != 0 && errno == ESRCH &&
+           pBlock->nWriter.compare_exchange_strong(nWriter, nSelf)) {
+            LOG(eWarning, "Writer %d of the control block is gone, taking over its lock\n", nWriter);
+            bLocked = true;
+        }
+        if(bLocked) {
+            if((pBlock->nSequence.load() & 1) == 0) {
+                pBlock->nSequence.fetch_add(1);
+            }
+            return true;
+        }
+        sched_yield();
+    }
+    LOG(eError, "Control block is locked by process %d\n", pBlock->nWriter.load());
+    return false;
+}
+
+void PerfControl::Unlock()
+{
+    PerfControlBlock* pBlock = Block();
+    if(pBlock->nNames != 0) {
+        Flags()->fetch_or(eControlFiltered);
+    }
+    else {
+        Flags()->fetch_and(~(uint32_t)eControlFiltered);
+    }
+    pBlock->nSequence.fetch_add(1);
+    pBlock->nWriter.store(0);
+}
+
+bool PerfControl::SetNameEnabled(const char* szName, bool bEnable)
+{
+    if(szName == NULL || szName[0] == '\0' || strlen(szName) >= CONTROL_NAME_LEN) {
+        LOG(eError, "Invalid name for the control block\n");
+        return false;
+    }
+    if(!Lock()) {
+        return false;
+    }
+
+    PerfControlBlock* pBlock  = Block();
+    bool              bRetVal = true;
+    uint32_t          nCount  = pBlock->nNames;
+    uint32_t          nIdx    = 0;
+    while(nIdx < nCount && strcmp(pBlock->names[nIdx], szName) != 0) {
+        nIdx++;
+    }
+
+    if(bEnable) {
+        if(nIdx < nCount) {
+            // Keep the table packed
+            memcpy(pBlock->names[nIdx], pBlock->names[nCount - 1], CONTROL_NAME_LEN);
+            pBlock->nNames = nCount - 1;
+        }
+    }
+    else if(nIdx == nCount) {
+        if(nCount < CONTROL_NAMES) {
+            strncpy(pBlock->names[nCount], szName, CONTROL_NAME_LEN - 1);
+            pBlock->names[nCount][CONTROL_NAME_LEN - 1] = '\0';
+            pBlock->nNames = nCount + 1;
+        }
+        else {
+            LOG(eError, "Control block is full, %s stays enabled\n", szName);
+            bRetVal = false;
+        }
+    }
+
+    Unlock();
+    return bRetVal;
+}
+
+void PerfControl::ClearNames()
+{
+    if(Lock()) {
+        Block()->nNames = 0;
+        Unlock();
+    }
+}
+
+std::vector<std::string> PerfControl::GetDisabledNames()
+{
+    Attach();
+    PerfControlBlock* pBlock = Block();
+    std::vector<std::string> names;
+    for(uint32_t nTry = 0; nTry < CONTROL_READ_RETRIES; nTry++) {
+        uint32_t nSequence = pBlock->nSequence.load(std::memory_order_acquire);
+        if(nSequence & 1) {
+            sched_yield();
+            continue;
+        }
+        names.clear();
+        uint32_t nCount = pBlock->nNames;
+        for(uint32_t nIdx = 0; nIdx < nCount && nIdx < CONTROL_NAMES; nIdx++) {
+            names.push_back(std::string(pBlock->names[nIdx], strnlen(pBlock->names[nIdx], CONTROL_NAME_LEN)));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(pBlock->nSequence.load(std::memory_order_relaxed) == nSequence) {
+            break;
+        }
+    }
+    return names;
+}
+
+void PerfControl::SetConfigNames(const std::vector<std::string>& names)
+{
+    PerfControlBlock* pBlock = &s_configBlock;
+    uint32_t          nCount = 0;
+
+    // Same sequence as the shared block, the lock is the writers' lock
+    pBlock->nSequence.fetch_add(1);
+    for(auto it = names.begin(); it != names.end() && nCount < CONTROL_NAMES; it++) {
+        strncpy(pBlock->names[nCount], it->c_str(), CONTROL_NAME_LEN - 1);
+        pBlock->names[nCount][CONTROL_NAME_LEN - 1] = '\0';
+        nCount++;
+    }
+    pBlock->nNames = nCount;
+    if(nCount != 0) {
+        pBlock->nFlags.fetch_or(eControlFiltered);
+    }
+    else {
+        pBlock->nFlags.fetch_and(~(uint32_t)eControlFiltered);
+    }
+    pBlock->nSequence.fetch_add(1);
+}
+
+bool PerfControl::IsFiltered(const char* szName)
+{
+    if((Flags()->load(std::memory_order_relaxed) & eControlFiltered) != 0 && IsFiltered(Block(), szName)) {
+        return true;
+    }
+    return (s_configBlock.nFlags.load(std::memory_order_relaxed) & eControlFiltered) != 0 &&
+           IsFiltered(&s_configBlock, szName);
+}
+
+bool PerfControl::IsFiltered(PerfControlBlock* pBlock, const char* szName)
+{
+    for(uint32_t nTry = 0; nTry < CONTROL_READ_RETRIES; nTry++) {
+        uint32_t nSequence = pBlock->nSequence.load(std::memory_order_acquire);
+        if(nSequence & 1) {
+            continue;
+        }
+
+        bool     bFiltered = false;
+        uint32_t nCount    = pBlock->nNames;
+        for(uint32_t nIdx = 0; nIdx < nCount && nIdx < CONTROL_NAMES && !bFiltered; nIdx++) {
+            const char* szEntry = pBlock->names[nIdx];
+            size_t      nLength = strnlen(szEntry, CONTROL_NAME_LEN);
+            if(nLength > 0 && szEntry[nLength - 1] == '*') {
+                bFiltered = strncmp(szName, szEntry, nLength - 1) == 0;
+            }
+            else {
+                bFiltered = strncmp(szName, szEntry, CONTROL_NAME_LEN) == 0;
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(pBlock->nSequence.load(std::memory_order_relaxed) == nSequence) {
+            return bFiltered;
+        }
+    }
+    // A writer died holding the block, keep measuring
+    return false;
+}
@@ -0,0 +1,112 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+
+#ifndef __RDK_PERF_CONTROL_H__
+#define __RDK_PERF_CONTROL_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#define RDK_PERF_CONTROL_NAME   "/rdkperf_control"
+#define RDK_PERF_CONTROL_ENV    "RDKPERF_CONTROL"   // Overrides the shared memory name
+#define CONTROL_VERSION         2
+#define CONTROL_NAMES           32
+#define CONTROL_NAME_LEN        48
+
+// All zero is the default state (everything enabled, no names disabled), so
+// a block that was just created and truncated is valid before anybody
+// writes to it.
+typedef enum _ControlFlags
+{
+    eControlDisabled    = 0x01,     // Every scope is disabled
+    eControlFiltered    = 0x02      // Some names are disabled, see names[]
+} ControlFlags;
+
+typedef struct _PerfControlBlock
+{
+    uint32_t                nVersion;
+    std::atomic<uint32_t>   nFlags;
+    std::atomic<uint32_t>   nSequence;  // Odd while names[] is being changed
+    std::atomic<int32_t>    nWriter;    // pid of the process changing names[], 0 when none
+    uint32_t                nNames;
+    char                    names[CONTROL_NAMES][CONTROL_NAME_LEN];
+} PerfControlBlock;
+
+// Runtime switch for the instrumentation, shared by every process on the
+// box through a small shared memory block.  A scope checks one flag word
+// before doing anything else; while it is zero the check is the only cost.
+// Names ending in '*' disable every scope that starts with the prefix,
+// which is how a category ("Net::*") is turned off.  The "disable" lines of
+// the configuration file go to a second block of the same layout that is
+// private to the process.
+class PerfControl
+{
+public:
+    static inline bool IsEnabled(const char* szName)
+    {
+        uint32_t nFlags = Flags()->load(std::memory_order_relaxed) |
+                          s_configBlock.nFlags.load(std::memory_order_relaxed);
+        if(__builtin_expect(nFlags == 0, 1)) {
+            return true;
+        }
+        return (nFlags & eControlDisabled) == 0 && !IsFiltered(szName);
+    };
+
+    // Maps the shared block, done with the first scope of the process so
+    // processes that never record do not map it
+    static inline void Attach()
+    {
+        if(!s_bAttached.load(std::memory_order_acquire)) {
+            AttachShared();
+        }
+    };
+
+    static void SetEnabled(bool bEnable);
+    static bool IsGloballyEnabled();
+    static bool SetNameEnabled(const char* szName, bool bEnable);
+    static void ClearNames();
+    static std::vector<std::string> GetDisabledNames();
+    static bool IsShared();
+    // Names disabled by the configuration file of this process, replaces
+    // the previous ones.  Must be called with the lock held.
+    static void SetConfigNames(const std::vector<std::string>& names);
+
+private:
+    static void AttachShared();
+    static bool IsFiltered(const char* szName);
+    static bool IsFiltered(PerfControlBlock* pBlock, const char* szName);
+    static bool Lock();
+    static void Unlock();
+    static inline std::atomic<uint32_t>* Flags()   { return s_pFlags.load(std::memory_order_acquire); };
+    static inline PerfControlBlock*      Block()   { return s_pBlock.load(std::memory_order_acquire); };
+
+    // Switched to the shared block once, which then stays mapped until the
+    // process exits, scopes can still be closing while the library unloads
+    static std::atomic<std::atomic<uint32_t>*>  s_pFlags;
+    static std::atomic<PerfControlBlock*>       s_pBlock;
+    static std::atomic<bool>        s_bAttached;    // Tried, shared or not
+    static PerfControlBlock         s_configBlock;  // Process local, written under the lock
+};
+
+#endif // __RDK_PERF_CONTROL_H__
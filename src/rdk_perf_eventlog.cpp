@@ -0,0 +1,524 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "rdk_perf_eventlog.h"
+#include "rdk_perf_node.h"
+#include "rdk_perf_tree.h"
+#include "rdk_perf_process.h"
+#include "rdk_perf_logging.h"
+#include "rdk_perf_scopedlock.h"
+
+PerfEventLog* PerfEventLog::s_pRecorder = NULL;
+
+static void __attribute__((destructor)) EventLogModuleTerminate();
+
+// This function is assigned to execute as library unload
+// using __attribute__((destructor))
+static void EventLogModuleTerminate()
+{
+    PerfEventLog::StopRecording();
+}
+
+// Signed deltas are zigzag encoded so small negative values stay small
+static inline uint64_t ZigZagEncode(int64_t value)
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t ZigZagDecode(uint64_t value)
+{
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+PerfEventLog::PerfEventLog(const char* szFileName)
+: m_fp(NULL), m_lastTimeStamp(0)
+{
+    m_fp = fopen(szFileName, "wb");
+    if(m_fp == NULL) {
+        LOG(eError, "Could not open event log %s, error %d (%s)\n", szFileName, errno, strerror(errno));
+        return;
+    }
+    setvbuf(m_fp, NULL, _IOFBF, RDK_PERF_EVENTLOG_BUF_SIZE);
+    fwrite(RDK_PERF_EVENTLOG_MAGIC, 1, RDK_PERF_EVENTLOG_MAGIC_LEN, m_fp);
+
+    LOG(eWarning, "Recording perf events to %s\n", szFileName);
+    return;
+}
+
+PerfEventLog::~PerfEventLog()
+{
+    if(m_fp != NULL) {
+        fclose(m_fp);
+        m_fp = NULL;
+    }
+    return;
+}
+
+void PerfEventLog::WriteByte(uint8_t value)
+{
+    fputc(value, m_fp);
+}
+
+void PerfEventLog::WriteVarint(uint64_t value)
+{
+    while(value >= 0x80) {
+        fputc((int)((value & 0x7F) | 0x80), m_fp);
+        value >>= 7;
+    }
+    fputc((int)value, m_fp);
+}
+
+void PerfEventLog::WriteString(const char* szValue)
+{
+    size_t nLen = (szValue != NULL) ? strlen(szValue) : 0;
+    WriteVarint(nLen);
+    if(nLen > 0) {
+        fwrite(szValue, 1, nLen, m_fp);
+    }
+}
+
+void PerfEventLog::DefineProcess(pid_t pID)
+{
+    if(m_processes.find(pID) != m_processes.end()) {
+        return;
+    }
+    m_processes.insert(pID);
+
+    PerfProcess* pProcess = RDKPerf_FindProcess(pID);
+    WriteByte(eLogProcessDef);
+    WriteVarint((uint64_t)pID);
+    WriteString(pProcess != NULL ? pProcess->GetName() : NULL);
+}
+
+uint32_t PerfEventLog::GetThreadIndex(pid_t pID, pthread_t tID, const char* szThreadName)
+{
+    ThreadKey key(pID, tID);
+    auto it = m_threads.find(key);
+    if(it != m_threads.end()) {
+        return it->second;
+    }
+
+    DefineProcess(pID);
+
+    char szName[MAX_NAME_LEN] = { 0 };
+    if(szThreadName == NULL && pID == getpid()) {
+        // In process recording, look up the name only the first time the thread is seen
+        pthread_getname_np(tID, szName, MAX_NAME_LEN);
+        szThreadName = szName;
+    }
+
+    uint32_t nIndex = (uint32_t)m_threads.size();
+    m_threads[key] = nIndex;
+
+    WriteByte(eLogThreadDef);
+    WriteVarint(nIndex);
+    WriteVarint((uint64_t)pID);
+    WriteVarint((uint64_t)tID);
+    WriteString(szThreadName);
+
+    return nIndex;
+}
+
+uint32_t PerfEventLog::GetNameIndex(const char* szName)
+{
+    auto it = m_names.find(szName);
+    if(it != m_names.end()) {
+        return it->second;
+    }
+
+    uint32_t nIndex = (uint32_t)m_names.size();
+    m_names[szName] = nIndex;
+
+    WriteByte(eLogNameDef);
+    WriteVarint(nIndex);
+    WriteString(szName);
+
+    return nIndex;
+}
+
+void PerfEventLog::RecordEntry(pid_t pID, pthread_t tID, const char* szThreadName, const char* szName, uint64_t nTimeStamp, int32_t nThresholdInUS)
+{
+    SCOPED_LOCK();
+
+    if(m_fp == NULL) return;
+
+    uint32_t nThread = GetThreadIndex(pID, tID, szThreadName);
+    uint32_t nName   = GetNameIndex(szName);
+
+    WriteByte(eLogEntry);
+    WriteVarint(nThread);
+    WriteVarint(nName);
+    WriteVarint(ZigZagEncode((int64_t)(nTimeStamp - m_lastTimeStamp)));
+    WriteVarint((uint64_t)((int64_t)nThresholdInUS + 1));   // -1 (no threshold) is stored as 0
+
+    m_lastTimeStamp = nTimeStamp;
+}
+
+void PerfEventLog::RecordExit(pid_t pID, pthread_t tID, const char* szName, uint64_t nElapsedTime)
+{
+    SCOPED_LOCK();
+
+    if(m_fp == NULL) return;
+
+    uint32_t nThread = GetThreadIndex(pID, tID, NULL);
+    uint32_t nName   = GetNameIndex(szName);
+
+    WriteByte(eLogExit);
+    WriteVarint(nThread);
+    WriteVarint(nName);
+    WriteVarint(nElapsedTime);
+}
+
+void PerfEventLog::RecordThreshold(pid_t pID, pthread_t tID, const char* szName, int32_t nThresholdInUS)
+{
+    SCOPED_LOCK();
+
+    if(m_fp == NULL) return;
+
+    uint32_t nThread = GetThreadIndex(pID, tID, NULL);
+    uint32_t nName   = GetNameIndex(szName);
+
+    WriteByte(eLogThreshold);
+    WriteVarint(nThread);
+    WriteVarint(nName);
+    WriteVarint((uint64_t)((int64_t)nThresholdInUS + 1));
+}
+
+void PerfEventLog::RecordMessage(PerfMessage* pMsg)
+{
+    switch(pMsg->type) {
+    case eEntry:
+        RecordEntry(pMsg->msg_data.entry.pID, pMsg->msg_data.entry.tID,
+                    pMsg->msg_data.entry.szThreadName, pMsg->msg_data.entry.szName,
+                    pMsg->msg_data.entry.nTimeStamp, pMsg->msg_data.entry.nThresholdInUS);
+        break;
+    case eExit:
+        // Remote exit messages carry the elapsed time in nTimeStamp
+        RecordExit(pMsg->msg_data.exit.pID, pMsg->msg_data.exit.tID,
+                   pMsg->msg_data.exit.szName, pMsg->msg_data.exit.nTimeStamp);
+        break;
+    case eThreshold:
+        RecordThreshold(pMsg->msg_data.threshold.pID, pMsg->msg_data.threshold.tID,
+                        pMsg->msg_data.threshold.szName, pMsg->msg_data.threshold.nThresholdInUS);
+        break;
+    default:
+        // Reports and close events are not part of the recorded stream
+        break;
+    }
+}
+
+void PerfEventLog::Flush()
+{
+    SCOPED_LOCK();
+    if(m_fp != NULL) {
+        fflush(m_fp);
+    }
+}
+
+void PerfEventLog::RecordFromEnv()
+{
+    const char* szFileName = getenv(RDK_PERF_EVENTLOG_ENV);
+    if(szFileName != NULL && szFileName[0] != '\0' && s_pRecorder == NULL) {
+        StartRecording(szFileName);
+    }
+}
+
+void PerfEventLog::StartRecording(const char* szFileName)
+{
+    SCOPED_LOCK();
+
+    if(s_pRecorder != NULL) {
+        LOG(eError, "Event recording already active\n");
+        return;
+    }
+
+    // "%p" in the file name is replaced with the process ID so that
+    // child processes inheriting the environment do not share a file
+    std::string fileName(szFileName);
+    size_t nPos = fileName.find("%p");
+    if(nPos != std::string::npos) {
+        fileName.replace(nPos, 2, std::to_string(getpid()));
+    }
+
+    PerfEventLog* pLog = new PerfEventLog(fileName.c_str());
+    if(pLog->IsOpen()) {
+        s_pRecorder = pLog;
+    }
+    else {
+        delete pLog;
+    }
+}
+
+void PerfEventLog::StopRecording()
+{
+    SCOPED_LOCK();
+
+    if(s_pRecorder != NULL) {
+        delete s_pRecorder;
+        s_pRecorder = NULL;
+    }
+}
+
+//--------------------- Replay ----------------------
+class EventLogReader
+{
+public:
+    EventLogReader(const uint8_t* pData, size_t nSize)
+    : m_pData(pData), m_nSize(nSize), m_nPos(0), m_bError(false) {};
+
+    bool AtEnd()    { return m_nPos >= m_nSize || m_bError; };
+    bool IsError()  { return m_bError; };
+
+    uint8_t ReadByte()
+    {
+        if(m_nPos >= m_nSize) {
+            m_bError = true;
+            return 0;
+        }
+        return m_pData[m_nPos++];
+    }
+
+    uint64_t ReadVarint()
+    {
+        uint64_t value = 0;
+        uint32_t nShift = 0;
+        while(m_nPos < m_nSize && nShift < 64) {
+            uint8_t byte = m_pData[m_nPos++];
+            value |= ((uint64_t)(byte & 0x7F)) << nShift;
+            if((byte & 0x80) == 0) {
+                return value;
+            }
+            nShift += 7;
+        }
+        m_bError = true;
+        return 0;
+    }
+
+    void ReadString(char* szBuffer, size_t nBufferSize)
+    {
+        uint64_t nLen = ReadVarint();
+        if(m_bError || nLen > m_nSize - m_nPos) {
+            m_bError = true;
+            szBuffer[0] = '\0';
+            return;
+        }
+        size_t nCopy = MIN((size_t)nLen, nBufferSize - 1);
+        memcpy(szBuffer, &m_pData[m_nPos], nCopy);
+        szBuffer[nCopy] = '\0';
+        m_nPos += (size_t)nLen;
+    }
+
+private:
+    const uint8_t*  m_pData;
+    size_t          m_nSize;
+    size_t          m_nPos;
+    bool            m_bError;
+};
+
+typedef struct _ReplayThread
+{
+    pid_t       pID;
+    pthread_t   tID;
+    char        szName[MAX_NAME_LEN];
+} ReplayThread;
+
+static PerfTree* ReplayGetTree(pid_t pID, pthread_t tID, std::map<pid_t, std::string>& processNames)
+{
+    PerfProcess* pProcess = RDKPerf_FindProcess(pID);
+    if(pProcess == NULL) {
+        pProcess = new PerfProcess(pID, processNames[pID].c_str());
+        RDKPerf_InsertProcess(pID, pProcess);
+    }
+
+    PerfTree* pTree = pProcess->GetTree(tID);
+    if(pTree == NULL) {
+        pTree = pProcess->NewTree(tID);
+    }
+
+    return pTree;
+}
+
+// Takes the innermost open node with this name off the stack.  Scopes may
+// close out of order, e.g. when stopped on another thread, the nodes opened
+// after it stay open.
+static PerfNode* ReplayCloseNode(PerfTree* pTree, const char* szName, bool* pbInOrder)
+{
+    std::stack<PerfNode*>*  pStack = pTree->GetStack();
+    std::vector<PerfNode*>  above;
+    PerfNode*               pNode  = NULL;
+
+    while(!pStack->empty()) {
+        PerfNode* pTop = pStack->top();
+        pStack->pop();
+        if(pTop->GetName().compare(szName) == 0) {
+            pNode = pTop;
+            break;
+        }
+        above.push_back(pTop);
+    }
+    *pbInOrder = above.empty();
+    while(!above.empty()) {
+        pStack->push(above.back());
+        above.pop_back();
+    }
+
+    return pNode;
+}
+
+uint64_t PerfEventLog::Replay(const char* szFileName, std::set<pid_t>* pProcesses)
+{
+    uint64_t                        nEvents = 0;
+    uint64_t                        nOutOfOrder = 0;
+    uint64_t                        nUnmatched = 0;
+    std::vector<uint8_t>            data;
+    std::vector<ReplayThread>       threads;
+    std::vector<std::string>        names;
+    std::map<pid_t, std::string>    processNames;
+
+    FILE* fp = fopen(szFileName, "rb");
+    if(fp == NULL) {
+        LOG(eError, "Could not open event log %s, error %d (%s)\n", szFileName, errno, strerror(errno));
+        return 0;
+    }
+    fseek(fp, 0, SEEK_END);
+    long nFileSize = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if(nFileSize > 0) {
+        data.resize((size_t)nFileSize);
+        if(fread(data.data(), 1, data.size(), fp) != data.size()) {
+            data.clear();
+        }
+    }
+    fclose(fp);
+
+    if(data.size() < RDK_PERF_EVENTLOG_MAGIC_LEN ||
+       memcmp(data.data(), RDK_PERF_EVENTLOG_MAGIC, RDK_PERF_EVENTLOG_MAGIC_LEN) != 0) {
+        LOG(eError, "%s is not a perf event log\n", szFileName);
+        return 0;
+    }
+
+    SCOPED_LOCK();
+
+    EventLogReader  reader(data.data() + RDK_PERF_EVENTLOG_MAGIC_LEN, data.size() - RDK_PERF_EVENTLOG_MAGIC_LEN);
+    uint64_t        nTimeStamp = 0;
+    char            szBuffer[MAX_NAME_LEN];
+
+    while(!reader.AtEnd()) {
+        uint8_t tag = reader.ReadByte();
+
+        if(tag == eLogProcessDef) {
+            pid_t pID = (pid_t)reader.ReadVarint();
+            reader.ReadString(szBuffer, sizeof(szBuffer));
+            processNames[pID] = szBuffer;
+            if(pProcesses != NULL) {
+                pProcesses->insert(pID);
+            }
+            continue;
+        }
+        if(tag == eLogThreadDef) {
+            ReplayThread thread;
+            uint32_t nIndex = (uint32_t)reader.ReadVarint();
+            thread.pID = (pid_t)reader.ReadVarint();
+            thread.tID = (pthread_t)reader.ReadVarint();
+            reader.ReadString(thread.szName, THREAD_NAMELEN);
+            if(nIndex != threads.size()) {
+                LOG(eError, "Out of order thread definition %u\n", nIndex);
+                break;
+            }
+            threads.push_back(thread);
+            continue;
+        }
+        if(tag == eLogNameDef) {
+            uint32_t nIndex = (uint32_t)reader.ReadVarint();
+            reader.ReadString(szBuffer, sizeof(szBuffer));
+            if(nIndex != names.size()) {
+                LOG(eError, "Out of order name definition %u\n", nIndex);
+                break;
+            }
+            names.push_back(szBuffer);
+            continue;
+        }
+
+        // Event records
+        uint64_t nThread = reader.ReadVarint();
+        uint64_t nName   = reader.ReadVarint();
+        if(reader.IsError() || nThread >= threads.size() || nName >= names.size()) {
+            LOG(eError, "Corrupt event record at event %llu\n", nEvents);
+            break;
+        }
+        ReplayThread&   thread = threads[nThread];
+        char*           szName = (char*)names[nName].c_str();
+        PerfTree*       pTree  = ReplayGetTree(thread.pID, thread.tID, processNames);
+
+        switch(tag) {
+        case eLogEntry: {
+            nTimeStamp += (uint64_t)ZigZagDecode(reader.ReadVarint());
+            int32_t nThresholdInUS = (int32_t)((int64_t)reader.ReadVarint() - 1);
+            PerfNode* pNode = pTree->AddNode(szName, thread.tID, thread.szName, nTimeStamp);
+            if(nThresholdInUS > 0) {
+                pNode->SetThreshold(nThresholdInUS);
+            }
+            break;
+        }
+        case eLogExit: {
+            uint64_t nElapsedTime = reader.ReadVarint();
+            bool     bInOrder     = true;
+            PerfNode* pNode = ReplayCloseNode(pTree, szName, &bInOrder);
+            if(pNode != NULL) {
+                pNode->IncrementData(nElapsedTime, 0, 0);
+                if(!bInOrder) {
+                    nOutOfOrder++;
+                }
+            }
+            else {
+                nUnmatched++;
+            }
+            break;
+        }
+        case eLogThreshold: {
+            int32_t nThresholdInUS = (int32_t)((int64_t)reader.ReadVarint() - 1);
+            PerfNode* pNode = pTree->GetStack()->empty() ? NULL : pTree->GetStack()->top();
+            if(pNode != NULL && nThresholdInUS > 0) {
+                pNode->SetThreshold(nThresholdInUS);
+            }
+            break;
+        }
+        default:
+            LOG(eError, "Unknown event log record %d\n", tag);
+            return nEvents;
+        }
+        nEvents++;
+    }
+
+    if(reader.IsError()) {
+        LOG(eError, "Event log %s is truncated after %llu events\n", szFileName, nEvents);
+    }
+    if(nOutOfOrder != 0 || nUnmatched != 0) {
+        LOG(eWarning, "Event log %s: %llu exits closed out of order, %llu exits without an open scope were dropped\n",
+            szFileName, (unsigned long long)nOutOfOrder, (unsigned long long)nUnmatched);
+    }
+
+    return nEvents;
+}
@@ -0,0 +1,97 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef __RDK_PERF_EVENTLOG_H__
+#define __RDK_PERF_EVENTLOG_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <string>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "rdk_perf_msgqueue.h"
+
+// Set this environment variable to a file name to record all events
+#define RDK_PERF_EVENTLOG_ENV       "RDKPERF_EVENT_LOG"
+#define RDK_PERF_EVENTLOG_MAGIC     "RDKPEVT1"
+#define RDK_PERF_EVENTLOG_MAGIC_LEN 8
+#define RDK_PERF_EVENTLOG_BUF_SIZE  (64 * 1024)
+
+// Record tags, event records reuse the message queue types so the
+// stream can be replayed through the same code paths as perfservice.
+// Definition records assign a small index to each process, thread and
+// scope name the first time it is seen, events only carry the indexes.
+typedef enum _EventLogTag
+{
+    eLogEntry       = eEntry,
+    eLogExit        = eExit,
+    eLogThreshold   = eThreshold,
+    eLogProcessDef  = 0x10,
+    eLogThreadDef   = 0x11,
+    eLogNameDef     = 0x12
+} EventLogTag;
+
+class PerfEventLog
+{
+public:
+    PerfEventLog(const char* szFileName);
+    ~PerfEventLog();
+
+    bool IsOpen() { return m_fp != NULL; };
+
+    void RecordEntry(pid_t pID, pthread_t tID, const char* szThreadName, const char* szName, uint64_t nTimeStamp, int32_t nThresholdInUS);
+    void RecordExit(pid_t pID, pthread_t tID, const char* szName, uint64_t nElapsedTime);
+    void RecordThreshold(pid_t pID, pthread_t tID, const char* szName, int32_t nThresholdInUS);
+    void RecordMessage(PerfMessage* pMsg);
+    void Flush();
+
+    static PerfEventLog* GetRecorder() { return s_pRecorder; };
+    static void StartRecording(const char* szFileName);
+    // Starts recording to RDKPERF_EVENT_LOG when it is set
+    static void RecordFromEnv();
+    static void StopRecording();
+
+    // Replay a recorded file into the process map, returns the number of events applied
+    static uint64_t Replay(const char* szFileName, std::set<pid_t>* pProcesses = NULL);
+
+private:
+    typedef std::pair<pid_t, pthread_t> ThreadKey;
+
+    uint32_t GetThreadIndex(pid_t pID, pthread_t tID, const char* szThreadName);
+    uint32_t GetNameIndex(const char* szName);
+    void DefineProcess(pid_t pID);
+
+    void WriteByte(uint8_t value);
+    void WriteVarint(uint64_t value);
+    void WriteString(const char* szValue);
+
+    FILE*                           m_fp;
+    uint64_t                        m_lastTimeStamp;
+    std::set<pid_t>                 m_processes;
+    std::map<ThreadKey, uint32_t>   m_threads;
+    std::map<std::string, uint32_t> m_names;
+
+    static PerfEventLog*            s_pRecorder;
+};
+
+#endif // __RDK_PERF_EVENTLOG_H__
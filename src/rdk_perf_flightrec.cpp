@@ -0,0 +1,288 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include <set>
+#include <list>
+#include <atomic>
+
+#include "rdk_perf_flightrec.h"
+#include "rdk_perf_record.h"
+#include "rdk_perf_logging.h"
+#include "rdk_perf_scopedlock.h"
+#include "rdk_perf_config.h"
+
+typedef struct _FlightThread
+{
+    pthread_t           tID;
+    char                szThreadName[16];
+    uint32_t            nCount;
+    FlightEvent         events[FLIGHT_RECORDER_EVENTS];
+} FlightThread;
+
+typedef struct _FlightDump
+{
+    char                    szTrigger[256];
+    std::list<FlightThread*> threads;
+} FlightDump;
+
+// Rings of the live threads and the last dump, under the global lock.  The
+// events in the rings are not.
+static std::set<PerfFlightRing*>*   s_pRings = NULL;
+static uint64_t                     s_nLastDump = 0;
+
+// Dumps waiting for the writer thread
+static pthread_mutex_t              s_queueLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t               s_queueCond = PTHREAD_COND_INITIALIZER;
+static std::list<FlightDump*>       s_queue;
+static bool                         s_bWriterStarted = false;
+
+// -1 until RDKPERF_FLIGHT has been read
+static std::atomic<int>             s_nEnabled(-1);
+
+PerfFlightRing::PerfFlightRing()
+: m_idThread(pthread_self())
+, m_nHead(0)
+{
+    m_pEvents = new FlightEvent[FLIGHT_RECORDER_EVENTS];
+
+    SCOPED_LOCK();
+    if(s_pRings == NULL) {
+        s_pRings = new std::set<PerfFlightRing*>();
+    }
+    s_pRings->insert(this);
+    return;
+}
+
+PerfFlightRing::~PerfFlightRing()
+{
+    {
+        SCOPED_LOCK();
+        s_pRings->erase(this);
+        if(s_pRings->empty()) {
+            delete s_pRings;
+            s_pRings = NULL;
+        }
+    }
+
+    delete [] m_pEvents;
+    return;
+}
+
+uint32_t PerfFlightRing::Freeze(FlightEvent* pEvents)
+{
+    uint64_t nHead  = m_nHead.load(std::memory_order_acquire);
+    uint32_t nCount = (nHead < FLIGHT_RECORDER_EVENTS) ? (uint32_t)nHead : FLIGHT_RECORDER_EVENTS;
+    for(uint32_t nIdx = 0; nIdx < nCount; nIdx++) {
+        pEvents[nIdx] = m_pEvents[(nHead - nCount + nIdx) % FLIGHT_RECORDER_EVENTS];
+    }
+    if(pthread_equal(m_idThread, pthread_self())) {
+        return nCount;
+    }
+
+    // The owner kept recording during the copy.  Event nNewHead may be half
+    // written and overwrites the slot of event nNewHead - FLIGHT_RECORDER_EVENTS,
+    // so every copied event older than that is dropped.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t nNewHead = m_nHead.load(std::memory_order_relaxed);
+    uint64_t nFirst   = nHead - nCount;
+    if(nNewHead + 1 > nFirst + FLIGHT_RECORDER_EVENTS) {
+        uint64_t nStale = nNewHead + 1 - FLIGHT_RECORDER_EVENTS - nFirst;
+        if(nStale >= nCount) {
+            return 0;
+        }
+        memmove(pEvents, pEvents + nStale, (nCount - nStale) * sizeof(FlightEvent));
+        nCount -= (uint32_t)nStale;
+    }
+
+    return nCount;
+}
+
+bool PerfFlightRecorder::IsEnabled()
+{
+    int nEnabled = s_nEnabled.load(std::memory_order_relaxed);
+    if(nEnabled < 0) {
+        const char* szEnabled = getenv(FLIGHT_RECORDER_ENV);
+        nEnabled = (szEnabled != NULL && atoi(szEnabled) != 0) ? 1 : 0;
+        s_nEnabled.store(nEnabled, std::memory_order_relaxed);
+    }
+    return nEnabled != 0 || PerfConfig::FlightRecorder();
+}
+
+void PerfFlightRecorder::Enable(bool bEnable)
+{
+    s_nEnabled.store(bEnable ? 1 : 0, std::memory_order_relaxed);
+}
+
+PerfFlightRing* PerfFlightRecorder::ForThread()
+{
+    static thread_local PerfFlightRing t_ring;
+    return &t_ring;
+}
+
+static void FormatTime(char* szBuffer, size_t nSize, uint64_t nTimeStamp)
+{
+    struct tm   local;
+    time_t      seconds = (time_t)(nTimeStamp / 1000000);
+
+    localtime_r(&seconds, &local);
+    snprintf(szBuffer, nSize, "%02d:%02d:%02d.%06u",
+             local.tm_hour, local.tm_min, local.tm_sec, (uint32_t)(nTimeStamp % 1000000));
+}
+
+static void WriteDump(FlightDump* pDump, uint32_t nDump)
+{
+    static const char* s_eventNames[] = { "begin ", "end   ", "BREACH" };
+    char        szPath[256];
+    char        szTime[32];
+    const char* szDir = getenv("RDKPERF_FLIGHT_DIR");
+
+    // A scope that breaches on every call must not fill /tmp, the oldest
+    // dump is overwritten
+    snprintf(szPath, sizeof(szPath), "%s/rdkperf_flight_%d_%u.txt",
+             szDir != NULL ? szDir : "/tmp", (int)getpid(), nDump % FLIGHT_DUMP_FILES);
+    FILE* pFile = fopen(szPath, "w");
+    if(pFile == NULL) {
+        LOG(eError, "Could not write flight recorder dump %s\n", szPath);
+        return;
+    }
+
+    fprintf(pFile, "rdkperf flight recorder, pid %d, %s\n", (int)getpid(), pDump->szTrigger);
+    auto it = pDump->threads.begin();
+    while(it != pDump->threads.end()) {
+        FlightThread* pThread = *it;
+        fprintf(pFile, "\nthread %X %s, last %u events\n", (uint32_t)pThread->tID, pThread->szThreadName, pThread->nCount);
+        for(uint32_t nIdx = 0; nIdx < pThread->nCount; nIdx++) {
+            const FlightEvent& event = pThread->events[nIdx];
+            FormatTime(szTime, sizeof(szTime), event.nTimeStamp);
+            if(event.type == eFlightBegin) {
+                fprintf(pFile, "  %s %s %s\n", szTime, s_eventNames[event.type], event.szName);
+            }
+            else {
+                fprintf(pFile, "  %s %s %s %0.3lf ms\n", szTime, s_eventNames[event.type], event.szName,
+                        (double)event.nDuration / 1000.0);
+            }
+        }
+        it++;
+    }
+    fclose(pFile);
+
+    LOG(eWarning, "Flight recorder dump written to %s\n", szPath);
+}
+
+static void* WriterThread(void* pArg)
+{
+    uint32_t nDump = 0;
+
+    pthread_setname_np(pthread_self(), "rdkperf_flight");
+    while(true) {
+        pthread_mutex_lock(&s_queueLock);
+        while(s_queue.empty()) {
+            pthread_cond_wait(&s_queueCond, &s_queueLock);
+        }
+        FlightDump* pDump = s_queue.front();
+        s_queue.pop_front();
+        pthread_mutex_unlock(&s_queueLock);
+
+        WriteDump(pDump, nDump);
+        nDump++;
+
+        auto it = pDump->threads.begin();
+        while(it != pDump->threads.end()) {
+            delete *it;
+            it++;
+        }
+        delete pDump;
+    }
+
+    return NULL;
+}
+
+static FlightThread* FreezeRing(PerfFlightRing* pRing)
+{
+    FlightThread* pThread = new FlightThread;
+
+    pThread->tID = pRing->GetThreadID();
+    if(pthread_getname_np(pThread->tID, pThread->szThreadName, sizeof(pThread->szThreadName)) != 0) {
+        pThread->szThreadName[0] = '\0';
+    }
+    pThread->nCount = pRing->Freeze(pThread->events);
+    return pThread;
+}
+
+void PerfFlightRecorder::Trigger(const char* szName, int32_t nThresholdUS, uint64_t nElapsedUS)
+{
+    char szTime[32];
+
+    SCOPED_LOCK();
+
+    if(!IsEnabled()) {
+        return;
+    }
+
+    // A stall usually breaches several scopes, the first dump has the history
+    uint64_t nNow = PerfRecord::TimeStamp();
+    if(s_nLastDump != 0 && nNow - s_nLastDump < FLIGHT_DUMP_INTERVAL_MS * 1000) {
+        return;
+    }
+    s_nLastDump = nNow;
+
+    FlightDump* pDump = new FlightDump;
+    FormatTime(szTime, sizeof(szTime), nNow);
+    snprintf(pDump->szTrigger, sizeof(pDump->szTrigger), "%s exceeded threshold %0.3lf ms, elapsed %0.3lf ms at %s",
+             szName, (double)nThresholdUS / 1000.0, (double)nElapsedUS / 1000.0, szTime);
+
+    // Freeze the breaching thread first, then the others
+    PerfFlightRing* pOwn = ForThread();
+    pDump->threads.push_back(FreezeRing(pOwn));
+    const char* szAll = getenv("RDKPERF_FLIGHT_ALL");
+    if(szAll != NULL && atoi(szAll) != 0 && s_pRings != NULL) {
+        auto it = s_pRings->begin();
+        while(it != s_pRings->end()) {
+            if(*it != pOwn) {
+                pDump->threads.push_back(FreezeRing(*it));
+            }
+            it++;
+        }
+    }
+
+    pthread_mutex_lock(&s_queueLock);
+    s_queue.push_back(pDump);
+    if(!s_bWriterStarted) {
+        pthread_t tID;
+        if(pthread_create(&tID, NULL, WriterThread, NULL) == 0) {
+            pthread_detach(tID);
+            s_bWriterStarted = true;
+        }
+        else {
+            LOG(eError, "Could not start the flight recorder writer\n");
+        }
+    }
+    pthread_cond_signal(&s_queueCond);
+    pthread_mutex_unlock(&s_queueLock);
+}
@@ -0,0 +1,98 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef __RDK_PERF_FLIGHTREC_H__
+#define __RDK_PERF_FLIGHTREC_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <atomic>
+
+#define FLIGHT_RECORDER_EVENTS  128     // Events kept per thread
+#define FLIGHT_RECORDER_NAME    40
+#define FLIGHT_DUMP_INTERVAL_MS 1000    // At most one dump per interval
+#define FLIGHT_DUMP_FILES       4       // File names reused in turn
+#define FLIGHT_RECORDER_ENV     "RDKPERF_FLIGHT"
+
+typedef enum _FlightEventType
+{
+    eFlightBegin    = 0,
+    eFlightEnd      = 1,
+    eFlightBreach   = 2
+} FlightEventType;
+
+typedef struct _FlightEvent
+{
+    uint64_t            nTimeStamp;     // Wall clock in us
+    uint64_t            nDuration;      // End and breach only
+    uint32_t            type;
+    char                szName[FLIGHT_RECORDER_NAME];
+} FlightEvent;
+
+// Ring of the last scope events of one thread.  Only the owning thread
+// writes, without a lock: it fills the slot and then publishes it with a
+// release store of the head.  A dump of another thread's ring copies the
+// slots and drops the ones the owner may have overwritten meanwhile.
+class PerfFlightRing
+{
+public:
+    PerfFlightRing();
+    ~PerfFlightRing();
+
+    // Owning thread only
+    inline void Record(FlightEventType type, const char* szName, uint64_t nTimeStamp, uint64_t nDuration)
+    {
+        uint64_t     nHead = m_nHead.load(std::memory_order_relaxed);
+        FlightEvent& event = m_pEvents[nHead % FLIGHT_RECORDER_EVENTS];
+        event.nTimeStamp = nTimeStamp;
+        event.nDuration  = nDuration;
+        event.type       = type;
+        strncpy(event.szName, szName, FLIGHT_RECORDER_NAME - 1);
+        event.szName[FLIGHT_RECORDER_NAME - 1] = '\0';
+        m_nHead.store(nHead + 1, std::memory_order_release);
+    };
+
+    // Copies the events oldest first, returns the number copied.  May be
+    // called from any thread while the ring exists.
+    uint32_t Freeze(FlightEvent* pEvents);
+    pthread_t GetThreadID() { return m_idThread; };
+
+private:
+    pthread_t               m_idThread;
+    FlightEvent*            m_pEvents;
+    std::atomic<uint64_t>   m_nHead;
+};
+
+// Every thread with a scope records into its ring.  The rings are dumped
+// to RDKPERF_FLIGHT_DIR (default /tmp) when a scope exceeds its threshold,
+// only the breaching thread unless RDKPERF_FLIGHT_ALL=1.  The file is
+// written by a background thread.  Dumps are off unless RDKPERF_FLIGHT=1,
+// "flight_recorder on" in the configuration or Enable().
+class PerfFlightRecorder
+{
+public:
+    static bool IsEnabled();
+    static void Enable(bool bEnable);
+    static PerfFlightRing* ForThread();
+    static void Trigger(const char* szName, int32_t nThresholdUS, uint64_t nElapsedUS);
+};
+
+#endif // __RDK_PERF_FLIGHTREC_H__
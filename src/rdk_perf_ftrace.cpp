@@ -0,0 +1,135 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "rdk_perf_ftrace.h"
+#include "rdk_perf_logging.h"
+#include "rdk_perf_scopedlock.h"
+
+#define FTRACE_RECORD_SIZE  256
+
+#ifndef MIN
+#define MIN(a,b) (((a)<(b))?(a):(b))
+#endif
+
+// tracefs is mounted on its own since kernel 4.1, older kernels only have
+// it under debugfs
+static const char* s_markers[] = {
+    "/sys/kernel/tracing/trace_marker",
+    "/sys/kernel/debug/tracing/trace_marker",
+    NULL
+};
+
+std::atomic<int>    PerfFTrace::s_nState(-1);
+int                 PerfFTrace::s_fd = -1;
+static bool         s_bOpenFailed = false;
+
+int PerfFTrace::Init()
+{
+    SCOPED_LOCK();
+
+    int nState = s_nState.load();
+    if(nState < 0) {
+        const char* szEnv = getenv("RDKPERF_FTRACE");
+        nState = (szEnv != NULL && atoi(szEnv) != 0 && Open()) ? 1 : 0;
+        s_nState.store(nState);
+    }
+    return nState;
+}
+
+bool PerfFTrace::Open()
+{
+    if(s_fd >= 0) {
+        return true;
+    }
+    if(s_bOpenFailed) {
+        return false;
+    }
+
+    for(int nIdx = 0; s_markers[nIdx] != NULL; nIdx++) {
+        // Kept open for the life of the process
+        s_fd = open(s_markers[nIdx], O_WRONLY | O_CLOEXEC);
+        if(s_fd >= 0) {
+            LOG(eWarning, "Writing scopes to %s\n", s_markers[nIdx]);
+            return true;
+        }
+    }
+
+    LOG(eError, "Could not open trace_marker (%s), ftrace output disabled\n", strerror(errno));
+    s_bOpenFailed = true;
+    return false;
+}
+
+void PerfFTrace::Enable(bool bEnable)
+{
+    SCOPED_LOCK();
+
+    s_nState.store((bEnable && Open()) ? 1 : 0);
+}
+
+void PerfFTrace::Write(const char* szRecord, size_t nSize)
+{
+    // One write per record, the kernel keeps records of different threads apart
+    if(write(s_fd, szRecord, nSize) < 0 && errno == EBADF) {
+        s_nState.store(0);
+    }
+}
+
+void PerfFTrace::Begin(const char* szName)
+{
+    char szRecord[FTRACE_RECORD_SIZE];
+
+    int nSize = snprintf(szRecord, sizeof(szRecord), "B|%d|%s", (int)getpid(), szName);
+    if(nSize > 0) {
+        Write(szRecord, MIN((size_t)nSize, sizeof(szRecord) - 1));
+    }
+}
+
+void PerfFTrace::End()
+{
+    char szRecord[32];
+
+    int nSize = snprintf(szRecord, sizeof(szRecord), "E|%d", (int)getpid());
+    if(nSize > 0) {
+        Write(szRecord, (size_t)nSize);
+    }
+}
+
+void PerfFTrace::Print(const char* szFormat, va_list args)
+{
+    char szRecord[FTRACE_RECORD_SIZE];
+
+    // Explicit prints do not need RDKPERF_FTRACE
+    if(s_fd < 0) {
+        SCOPED_LOCK();
+        if(!Open()) {
+            return;
+        }
+    }
+    int nSize = vsnprintf(szRecord, sizeof(szRecord), szFormat, args);
+    if(nSize > 0) {
+        Write(szRecord, MIN((size_t)nSize, sizeof(szRecord) - 1));
+    }
+}
@@ -0,0 +1,61 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef __RDK_PERF_FTRACE_H__
+#define __RDK_PERF_FTRACE_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include <atomic>
+
+// Writes scope begin and end records to the ftrace trace_marker using the
+// systrace convention ("B|pid|name" / "E|pid"), so scopes show up next to
+// the kernel scheduler events in the same trace.  Enabled with
+// RDKPERF_FTRACE=1 in the environment or RDKPerfSetFTrace().  The marker is
+// opened once and every record is a single write(), formatted in a buffer
+// on the calling thread's stack.
+class PerfFTrace
+{
+public:
+    static inline bool IsEnabled()
+    {
+        int nState = s_nState.load(std::memory_order_relaxed);
+        if(nState < 0) {
+            nState = Init();
+        }
+        return nState > 0;
+    };
+
+    static void Enable(bool bEnable);
+    static void Begin(const char* szName);
+    static void End();
+    static void Print(const char* szFormat, va_list args);
+
+private:
+    static int Init();
+    static bool Open();
+    static void Write(const char* szRecord, size_t nSize);
+
+    static std::atomic<int> s_nState;       // -1 not checked, 0 off, 1 on
+    static int              s_fd;
+};
+
+#endif // __RDK_PERF_FTRACE_H__
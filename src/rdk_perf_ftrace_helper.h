@@ -22,17 +22,16 @@
 #include <stdio.h>
 #include <stdarg.h>
 
+#include "rdk_perf_ftrace.h"
+
 #define RDK_PERF_TRACE_MARKER "/sys/kernel/debug/tracing/trace_marker"
 
+// The marker stays open, see PerfFTrace
 static inline void ftrace_print(const char* msg, ...)
 {
     va_list args;
     va_start (args, msg);
-    FILE* tracefd = fopen(RDK_PERF_TRACE_MARKER, "wt");
-    if (tracefd != NULL) {
-        vfprintf(tracefd, msg, args);
-        fclose(tracefd);
-    }
+    PerfFTrace::Print(msg, args);
     va_end(args);
 }
 
@@ -0,0 +1,135 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef __RDK_PERF_HISTOGRAM_H__
+#define __RDK_PERF_HISTOGRAM_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+
+// Log-linear histogram, values are usually microseconds.  Every power of two
+// is split into HISTOGRAM_SUB_BUCKETS buckets, so a bucket is at most 25% wide
+// and percentiles are reported within that precision.  Values above 2^32 are
+// counted in the last bucket.
+//
+// Add() only touches one bucket, so with std::atomic<> counts the histogram
+// can be updated without a lock.
+#define HISTOGRAM_SUB_BITS      2
+#define HISTOGRAM_SUB_BUCKETS   (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_MAX_BITS      32
+#define HISTOGRAM_BUCKETS       ((HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+template<typename CountType>
+class PerfHistogramT
+{
+public:
+    PerfHistogramT() { Reset(); };
+
+    void Reset()
+    {
+        for(uint32_t nIdx = 0; nIdx < HISTOGRAM_BUCKETS; nIdx++) {
+            m_buckets[nIdx] = 0;
+        }
+    }
+
+    void Add(uint64_t nValue)
+    {
+        m_buckets[Bucket(nValue)]++;
+    }
+
+    template<typename OtherType>
+    void Merge(const PerfHistogramT<OtherType>& other)
+    {
+        for(uint32_t nIdx = 0; nIdx < HISTOGRAM_BUCKETS; nIdx++) {
+            m_buckets[nIdx] += other.GetBucket(nIdx);
+        }
+    }
+
+    uint64_t GetCount() const
+    {
+        uint64_t nCount = 0;
+        for(uint32_t nIdx = 0; nIdx < HISTOGRAM_BUCKETS; nIdx++) {
+            nCount += m_buckets[nIdx];
+        }
+        return nCount;
+    }
+    uint64_t GetBucket(uint32_t nIdx) const     { return m_buckets[nIdx]; };
+    void SetBucket(uint32_t nIdx, uint64_t n)   { m_buckets[nIdx] = n; };
+
+    // Returns the upper bound in us of the bucket holding the given percentile
+    uint64_t Percentile(double percentile) const
+    {
+        uint64_t nCount = GetCount();
+        if(nCount == 0) return 0;
+
+        uint64_t nTarget = (uint64_t)((percentile / 100.0) * (double)nCount + 0.5);
+        if(nTarget == 0) nTarget = 1;
+        uint64_t nSeen = 0;
+        for(uint32_t nIdx = 0; nIdx < HISTOGRAM_BUCKETS; nIdx++) {
+            nSeen += m_buckets[nIdx];
+            if(nSeen >= nTarget) {
+                return UpperBound(nIdx);
+            }
+        }
+        return UpperBound(HISTOGRAM_BUCKETS - 1);
+    }
+
+    // "p50 x p90 y p99 z" in ms
+    void Format(char* szBuffer, size_t nSize) const
+    {
+        snprintf(szBuffer, nSize, "p50 %0.3lf, p90 %0.3lf, p99 %0.3lf",
+                 (double)Percentile(50.0) / 1000.0,
+                 (double)Percentile(90.0) / 1000.0,
+                 (double)Percentile(99.0) / 1000.0);
+    }
+
+    static uint32_t Bucket(uint64_t nValue)
+    {
+        if(nValue < HISTOGRAM_SUB_BUCKETS) {
+            return (uint32_t)nValue;
+        }
+        uint32_t nBits = 63 - __builtin_clzll(nValue);
+        if(nBits >= HISTOGRAM_MAX_BITS) {
+            return HISTOGRAM_BUCKETS - 1;
+        }
+        uint32_t nSub = (uint32_t)(nValue >> (nBits - HISTOGRAM_SUB_BITS)) & (HISTOGRAM_SUB_BUCKETS - 1);
+        return (nBits - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS + nSub;
+    }
+
+    static uint64_t UpperBound(uint32_t nBucket)
+    {
+        if(nBucket < HISTOGRAM_SUB_BUCKETS) {
+            return nBucket;
+        }
+        uint32_t nBits = nBucket / HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BITS - 1;
+        uint64_t nSub  = nBucket % HISTOGRAM_SUB_BUCKETS;
+        uint64_t nStep = 1ULL << (nBits - HISTOGRAM_SUB_BITS);
+        return (1ULL << nBits) + (nSub + 1) * nStep - 1;
+    }
+
+private:
+    CountType   m_buckets[HISTOGRAM_BUCKETS];
+};
+
+typedef PerfHistogramT<uint32_t>                PerfHistogram;
+typedef PerfHistogramT<std::atomic<uint32_t> >  PerfAtomicHistogram;
+
+#endif // __RDK_PERF_HISTOGRAM_H__
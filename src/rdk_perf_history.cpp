@@ -0,0 +1,370 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+
+#include "rdk_perf_history.h"
+#include "rdk_perf_node.h"
+#include "rdk_perf_logging.h"
+
+// Map, deque and string overhead of a series, an estimate
+#define SERIES_OVERHEAD     (sizeof(HistorySeries) + 96)
+
+static inline void PutVarint(std::vector<uint8_t>* pData, uint64_t nValue)
+{
+    while(nValue >= 0x80) {
+        pData->push_back((uint8_t)(nValue | 0x80));
+        nValue >>= 7;
+    }
+    pData->push_back((uint8_t)nValue);
+}
+
+static inline uint64_t GetVarint(const uint8_t** ppData)
+{
+    uint64_t nValue = 0;
+    uint32_t nShift = 0;
+    const uint8_t* pData = *ppData;
+    while(*pData & 0x80) {
+        nValue |= (uint64_t)(*pData++ & 0x7F) << nShift;
+        nShift += 7;
+    }
+    nValue |= (uint64_t)(*pData++) << nShift;
+    *ppData = pData;
+    return nValue;
+}
+
+// Small differences of either sign take one byte
+static inline uint64_t ZigZag(int64_t nValue)
+{
+    return ((uint64_t)nValue << 1) ^ (uint64_t)(nValue >> 63);
+}
+
+static inline int64_t UnZigZag(uint64_t nValue)
+{
+    return (int64_t)(nValue >> 1) ^ -(int64_t)(nValue & 1);
+}
+
+PerfHistory::PerfHistory()
+: m_nStart(0), m_nFirst(0), m_nNext(0), m_nBytes(0)
+{
+    return;
+}
+
+void PerfHistory::CollectNode(PerfNode* pNode, std::map<std::string, PerfWindow*>* pWindows, HistoryInputs* pInputs)
+{
+    PerfWindow* pWindow = pNode->GetRollingWindow();
+    if(pWindow != NULL) {
+        TimingStats*  pStats = pNode->GetStats();
+        HistoryInput& input  = (*pInputs)[pNode->GetName()];
+        input.nTotalCount   += pStats->nTotalCount;
+        input.nTotalTime    += pStats->nTotalTime;
+
+        PerfWindow*& pSum = (*pWindows)[pNode->GetName()];
+        if(pSum == NULL) {
+            pSum = new PerfWindow();
+        }
+        pSum->Merge(*pWindow);
+    }
+
+    auto it = pNode->GetChildren().begin();
+    while(it != pNode->GetChildren().end()) {
+        CollectNode(it->second, pWindows, pInputs);
+        it++;
+    }
+}
+
+void PerfHistory::Collect(const std::vector<PerfNode*>& roots, uint32_t nSeconds, HistoryInputs* pInputs)
+{
+    std::map<std::string, PerfWindow*> windows;
+
+    for(auto itRoot = roots.begin(); itRoot != roots.end(); itRoot++) {
+        CollectNode(*itRoot, &windows, pInputs);
+    }
+
+    uint32_t nNow = PerfWindow::Now();
+    auto it = windows.begin();
+    while(it != windows.end()) {
+        WindowStats   stats;
+        HistoryInput& input = (*pInputs)[it->first];
+        it->second->Get(nSeconds, nNow, &stats);
+        input.nMax  = stats.nMax;
+        input.nP99  = stats.nP99;
+        delete it->second;
+        it++;
+    }
+}
+
+void PerfHistory::Append(HistorySeries* pSeries, const uint64_t values[4])
+{
+    if(pSeries->chunks.empty() || pSeries->chunks.back().nSamples == HISTORY_CHUNK_SAMPLES) {
+        if(!pSeries->chunks.empty()) {
+            // Complete, it does not grow any more
+            HistoryChunk& full = pSeries->chunks.back();
+            m_nBytes -= full.data.capacity();
+            full.data.shrink_to_fit();
+            m_nBytes += full.data.capacity();
+        }
+        pSeries->chunks.push_back(HistoryChunk());
+        HistoryChunk& chunk = pSeries->chunks.back();
+        chunk.nFirst    = m_nNext;
+        chunk.nSamples  = 0;
+        memset(chunk.last, 0, sizeof(chunk.last));
+        m_nBytes += sizeof(HistoryChunk);
+    }
+
+    HistoryChunk& chunk = pSeries->chunks.back();
+    size_t nCapacity = chunk.data.capacity();
+    for(uint32_t nIdx = 0; nIdx < 4; nIdx++) {
+        PutVarint(&chunk.data, ZigZag((int64_t)(values[nIdx] - chunk.last[nIdx])));
+        chunk.last[nIdx] = values[nIdx];
+    }
+    chunk.nSamples++;
+    m_nBytes += chunk.data.capacity() - nCapacity;
+}
+
+void PerfHistory::Snapshot(time_t nNow, const HistoryConfig& config, const HistoryInputs& inputs)
+{
+    bool bBaseline = m_nNext == 0 && m_times.empty() && m_series.empty();
+
+    // New scopes start a series, the first difference is to zero
+    auto itInput = inputs.begin();
+    while(itInput != inputs.end()) {
+        if(m_series.find(itInput->first) == m_series.end()) {
+            HistorySeries& series = m_series[itInput->first];
+            series.nLastCount   = bBaseline ? itInput->second.nTotalCount : 0;
+            series.nLastTime    = bBaseline ? itInput->second.nTotalTime : 0;
+            series.nLastActive  = m_nNext;
+            m_nBytes += SERIES_OVERHEAD + itInput->first.size();
+        }
+        itInput++;
+    }
+    if(bBaseline) {
+        m_nStart = nNow;
+        return;
+    }
+
+    // Every series gets a sample, so the samples of a chunk are consecutive
+    auto it = m_series.begin();
+    while(it != m_series.end()) {
+        HistorySeries& series = it->second;
+        uint64_t values[4] = { 0, 0, 0, 0 };
+
+        itInput = inputs.find(it->first);
+        if(itInput != inputs.end()) {
+            const HistoryInput& input = itInput->second;
+            // Totals go down when the tree of a thread is closed
+            values[0] = input.nTotalCount >= series.nLastCount ? input.nTotalCount - series.nLastCount : 0;
+            values[1] = input.nTotalTime >= series.nLastTime ? input.nTotalTime - series.nLastTime : 0;
+            values[2] = input.nMax;
+            values[3] = input.nP99;
+            series.nLastCount   = input.nTotalCount;
+            series.nLastTime    = input.nTotalTime;
+        }
+        if(values[0] != 0) {
+            series.nLastActive = m_nNext;
+        }
+        Append(&series, values);
+        it++;
+    }
+    m_times.push_back(nNow);
+    m_nNext++;
+    m_nBytes += sizeof(time_t);
+
+    Trim(nNow, config);
+}
+
+void PerfHistory::DropChunks(uint64_t nFirst)
+{
+    while(m_nFirst < nFirst && !m_times.empty()) {
+        m_nStart = m_times.front();
+        m_times.pop_front();
+        m_nFirst++;
+        m_nBytes -= sizeof(time_t);
+    }
+
+    auto it = m_series.begin();
+    while(it != m_series.end()) {
+        HistorySeries& series = it->second;
+        while(!series.chunks.empty() &&
+              series.chunks.front().nFirst + series.chunks.front().nSamples <= m_nFirst) {
+            m_nBytes -= sizeof(HistoryChunk) + series.chunks.front().data.capacity();
+            series.chunks.pop_front();
+        }
+        if(series.nLastActive < m_nFirst) {
+            // No calls left in the history
+            m_nBytes -= SERIES_OVERHEAD + it->first.size();
+            auto itChunk = series.chunks.begin();
+            while(itChunk != series.chunks.end()) {
+                m_nBytes -= sizeof(HistoryChunk) + itChunk->data.capacity();
+                itChunk++;
+            }
+            it = m_series.erase(it);
+        }
+        else {
+            it++;
+        }
+    }
+}
+
+void PerfHistory::Trim(time_t nNow, const HistoryConfig& config)
+{
+    // Snapshots older than the duration, whole chunks are freed once all
+    // of their samples are out
+    uint64_t nFirst = m_nFirst;
+    while(nFirst < m_nNext && m_times[nFirst - m_nFirst] <= nNow - (time_t)config.nDuration) {
+        nFirst++;
+    }
+    if(nFirst != m_nFirst) {
+        DropChunks(nFirst);
+    }
+
+    // Over the cap, drop the oldest chunk of every series
+    while(m_nBytes > config.nMaxBytes && m_nNext - m_nFirst > HISTORY_CHUNK_SAMPLES) {
+        uint64_t nOldest = m_nNext;
+        auto it = m_series.begin();
+        while(it != m_series.end()) {
+            if(!it->second.chunks.empty()) {
+                const HistoryChunk& chunk = it->second.chunks.front();
+                nOldest = std::min(nOldest, chunk.nFirst + chunk.nSamples);
+            }
+            it++;
+        }
+        DropChunks(std::max(nOldest, m_nFirst + 1));
+    }
+}
+
+void PerfHistory::Decode(const HistorySeries& series, uint64_t nFrom, std::vector<HistorySample>* pSamples)
+{
+    auto itChunk = series.chunks.begin();
+    while(itChunk != series.chunks.end()) {
+        const HistoryChunk& chunk = *itChunk;
+        const uint8_t* pData = chunk.data.data();
+        uint64_t values[4] = { 0, 0, 0, 0 };
+
+        for(uint32_t nSample = 0; nSample < chunk.nSamples; nSample++) {
+            for(uint32_t nIdx = 0; nIdx < 4; nIdx++) {
+                values[nIdx] += (uint64_t)UnZigZag(GetVarint(&pData));
+            }
+            uint64_t nIndex = chunk.nFirst + nSample;
+            if(nIndex < nFrom || nIndex < m_nFirst) {
+                continue;
+            }
+            HistorySample sample;
+            time_t nPrev    = (nIndex == m_nFirst) ? m_nStart : m_times[nIndex - m_nFirst - 1];
+            sample.nEnd     = m_times[nIndex - m_nFirst];
+            sample.nSeconds = (uint32_t)(sample.nEnd - nPrev);
+            sample.nCount   = values[0];
+            sample.nTime    = values[1];
+            sample.nMax     = values[2];
+            sample.nP99     = values[3];
+            pSamples->push_back(sample);
+        }
+        itChunk++;
+    }
+}
+
+bool PerfHistory::Get(const std::string& name, uint32_t nSeconds, std::vector<HistorySample>* pSamples)
+{
+    auto it = m_series.find(name);
+    if(it == m_series.end() || m_times.empty()) {
+        return false;
+    }
+
+    // Snapshots that end within the last nSeconds
+    uint64_t nFrom = m_nNext;
+    while(nFrom > m_nFirst && m_times[nFrom - 1 - m_nFirst] > m_times.back() - (time_t)nSeconds) {
+        nFrom--;
+    }
+    Decode(it->second, nFrom, pSamples);
+
+    return true;
+}
+
+// Calls, time and worst p99 of a run of samples
+static void SumSamples(std::vector<HistorySample>::const_iterator itBegin, std::vector<HistorySample>::const_iterator itEnd,
+                       HistorySample* pSum)
+{
+    memset((void*)pSum, 0, sizeof(HistorySample));
+    while(itBegin != itEnd) {
+        pSum->nSeconds += itBegin->nSeconds;
+        pSum->nCount   += itBegin->nCount;
+        pSum->nTime    += itBegin->nTime;
+        pSum->nP99      = std::max(pSum->nP99, itBegin->nP99);
+        itBegin++;
+    }
+}
+
+static bool Changed(double nBefore, double nAfter)
+{
+    return nBefore > 0.0 && (nAfter > nBefore * (100 + HISTORY_TREND_PERCENT) / 100.0 ||
+                             nAfter < nBefore * (100 - HISTORY_TREND_PERCENT) / 100.0);
+}
+
+void PerfHistory::ReportTrends()
+{
+    if(m_times.empty()) {
+        return;
+    }
+    uint32_t nSpan = (uint32_t)(m_times.back() - m_nStart);
+    LOG(eWarning, "History of %u s, %u snapshots, %u scopes in %u bytes\n",
+        nSpan, (uint32_t)m_times.size(), (uint32_t)m_series.size(), (uint32_t)m_nBytes);
+
+    auto it = m_series.begin();
+    while(it != m_series.end()) {
+        std::vector<HistorySample> samples;
+        Decode(it->second, m_nFirst, &samples);
+
+        // First and last minute, or quarter of a short history
+        size_t nTotalSeconds = 0;
+        for(auto itSample = samples.begin(); itSample != samples.end(); itSample++) {
+            nTotalSeconds += itSample->nSeconds;
+        }
+        size_t nGroup = 1;
+        if(!samples.empty() && nTotalSeconds != 0) {
+            size_t nPerMinute = (60 * samples.size() + nTotalSeconds - 1) / nTotalSeconds;
+            nGroup = std::max((size_t)1, std::min(nPerMinute, samples.size() / 4));
+        }
+        if(samples.size() < 2 * nGroup) {
+            it++;
+            continue;
+        }
+
+        HistorySample before, after;
+        SumSamples(samples.begin(), samples.begin() + nGroup, &before);
+        SumSamples(samples.end() - nGroup, samples.end(), &after);
+        if(before.nCount != 0 && after.nCount != 0) {
+            double nAvgBefore = (double)before.nTime / (double)before.nCount;
+            double nAvgAfter  = (double)after.nTime / (double)after.nCount;
+            if(Changed(nAvgBefore, nAvgAfter) || Changed((double)before.nP99, (double)after.nP99)) {
+                LOG(eWarning, "%s over the last %u s: p99 %0.3lf -> %0.3lf ms, avg %0.3lf -> %0.3lf ms, %0.1lf -> %0.1lf calls/s\n",
+                    it->first.c_str(), nSpan,
+                    (double)before.nP99 / 1000.0, (double)after.nP99 / 1000.0,
+                    nAvgBefore / 1000.0, nAvgAfter / 1000.0,
+                    (double)before.nCount / (double)std::max(before.nSeconds, (uint32_t)1),
+                    (double)after.nCount / (double)std::max(after.nSeconds, (uint32_t)1));
+            }
+        }
+        it++;
+    }
+}
@@ -0,0 +1,127 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+
+#ifndef __RDK_PERF_HISTORY_H__
+#define __RDK_PERF_HISTORY_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <map>
+#include <deque>
+#include <vector>
+
+#include "rdk_perf_window.h"
+
+#define HISTORY_CHUNK_SAMPLES   32      // Samples per encoded chunk, the unit that is dropped
+#define HISTORY_DEFAULT_KB      256     // Memory cap when the configuration has none
+#define HISTORY_TREND_PERCENT   25      // Change of avg or p99 that is worth a trend line
+
+// Forward decls
+class PerfNode;
+
+typedef struct _HistoryConfig
+{
+    uint32_t            nResolution;    // Seconds between snapshots, 0 when off
+    uint32_t            nDuration;      // Seconds kept
+    uint32_t            nMaxBytes;
+} HistoryConfig;
+
+// One scope name in one snapshot
+typedef struct _HistorySample
+{
+    time_t              nEnd;           // End of the interval, wall clock
+    uint32_t            nSeconds;       // Length of the interval
+    uint64_t            nCount;
+    uint64_t            nTime;
+    uint64_t            nMax;           // From the rolling window, see PerfWindow
+    uint64_t            nP99;
+} HistorySample;
+
+// Values of one scope name collected from the trees of a process
+typedef struct _HistoryInput
+{
+    uint64_t            nTotalCount;
+    uint64_t            nTotalTime;
+    uint64_t            nMax;
+    uint64_t            nP99;
+} HistoryInput;
+typedef std::map<std::string, HistoryInput> HistoryInputs;
+
+// Samples of one series, each value is the zig zag varint of its difference
+// to the previous sample.  A chunk starts from zero so it can be dropped
+// and decoded on its own.
+typedef struct _HistoryChunk
+{
+    uint64_t            nFirst;         // Snapshot index of the first sample
+    uint32_t            nSamples;
+    uint64_t            last[4];        // Last sample, for the next difference
+    std::vector<uint8_t> data;
+} HistoryChunk;
+
+typedef struct _HistorySeries
+{
+    uint64_t            nLastCount;     // Totals of the previous snapshot
+    uint64_t            nLastTime;
+    uint64_t            nLastActive;    // Snapshot index of the last sample with calls
+    std::deque<HistoryChunk> chunks;
+} HistorySeries;
+
+// Interval history of a process, one sample per scope name and snapshot.
+// Counts and times are the differences of the totals in TimingStats, which
+// reports do not reset, max and p99 come from the rolling windows.  When
+// the history is over its memory cap the oldest chunk of every series is
+// dropped, so the history gets shorter instead of larger.  Must be used
+// with the lock held.
+class PerfHistory
+{
+public:
+    PerfHistory();
+
+    // Sums the nodes of the trees that have run by name, max and p99 are
+    // those of the last nSeconds
+    static void Collect(const std::vector<PerfNode*>& roots, uint32_t nSeconds, HistoryInputs* pInputs);
+
+    // The first snapshot only takes the totals the next one is compared to
+    void Snapshot(time_t nNow, const HistoryConfig& config, const HistoryInputs& inputs);
+    // Samples of the last nSeconds, oldest first.  False when the name has no history.
+    bool Get(const std::string& name, uint32_t nSeconds, std::vector<HistorySample>* pSamples);
+    // Scopes whose avg or p99 changed by HISTORY_TREND_PERCENT over the history
+    void ReportTrends();
+    size_t GetBytes() { return m_nBytes; };
+
+private:
+    static void CollectNode(PerfNode* pNode, std::map<std::string, PerfWindow*>* pWindows, HistoryInputs* pInputs);
+    void Append(HistorySeries* pSeries, const uint64_t values[4]);
+    void Trim(time_t nNow, const HistoryConfig& config);
+    void DropChunks(uint64_t nFirst);
+    void Decode(const HistorySeries& series, uint64_t nFrom, std::vector<HistorySample>* pSamples);
+
+    std::map<std::string, HistorySeries> m_series;
+    std::deque<time_t>  m_times;            // Time of each snapshot still kept
+    time_t              m_nStart;           // Time of the snapshot before m_times.front()
+    uint64_t            m_nFirst;           // Snapshot index of m_times.front()
+    uint64_t            m_nNext;            // Index of the next snapshot
+    size_t              m_nBytes;
+};
+
+#endif // __RDK_PERF_HISTORY_H__
@@ -0,0 +1,193 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "rdk_perf_hwcounters.h"
+#include "rdk_perf_logging.h"
+#include "rdk_perf_scopedlock.h"
+
+typedef enum _CounterSource
+{
+    eSourceUnknown      = 0,    // Not probed yet
+    eSourceEvent        = 1,    // Requested event
+    eSourceFallback     = 2,    // Software replacement
+    eSourceUnavailable  = 3
+} CounterSource;
+
+typedef struct _CounterDef
+{
+    const char*     szName;
+    uint32_t        type;
+    uint64_t        config;
+    const char*     szFallbackName;
+    uint32_t        fallbackType;
+    uint64_t        fallbackConfig;
+} CounterDef;
+
+static const CounterDef s_counters[eHWCounterCount] = {
+    { "cycles",         PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES,          "task-clock-ns", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK },
+    { "instructions",   PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS,        NULL,            0,                  0 },
+    { "cache-misses",   PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES,        NULL,            0,                  0 },
+    { "branch-misses",  PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES,       NULL,            0,                  0 },
+    { "ctx-switches",   PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES,    NULL,            0,                  0 },
+    { "page-faults",    PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS,         NULL,            0,                  0 },
+};
+
+// Opening order, the first counter that opens leads the group.  A task-clock
+// leader (the cycles fallback) leaves its software siblings at 0, so the
+// plain software events come first.
+static const uint32_t s_openOrder[eHWCounterCount] = {
+    eHWPageFaults, eHWContextSwitches, eHWCycles, eHWInstructions, eHWCacheMisses, eHWBranchMisses
+};
+
+// Decided by the first thread that opens the counters, so every thread
+// reports the same events
+static CounterSource s_source[eHWCounterCount] = { eSourceUnknown };
+
+static int PerfEventOpen(uint32_t type, uint64_t config, int groupFd)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = type;
+    attr.config         = config;
+    attr.read_format    = PERF_FORMAT_GROUP;
+    attr.exclude_kernel = 1;    // Allowed for the own thread with perf_event_paranoid <= 2
+    attr.exclude_hv     = 1;
+
+    // Calling thread, any CPU
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC);
+}
+
+PerfHWCounters::PerfHWCounters()
+: m_fdLeader(-1)
+, m_nOpen(0)
+{
+    SCOPED_LOCK();
+
+    for(uint32_t nIdx = 0; nIdx < eHWCounterCount; nIdx++) {
+        m_fd[nIdx]      = -1;
+        m_nSlot[nIdx]   = -1;
+    }
+
+    for(uint32_t nOrder = 0; nOrder < eHWCounterCount; nOrder++) {
+        uint32_t          nIdx = s_openOrder[nOrder];
+        const CounterDef& def = s_counters[nIdx];
+        switch(s_source[nIdx]) {
+        case eSourceUnknown:
+            if(Open(nIdx, def.type, def.config)) {
+                s_source[nIdx] = eSourceEvent;
+            }
+            else if(def.szFallbackName != NULL && Open(nIdx, def.fallbackType, def.fallbackConfig)) {
+                s_source[nIdx] = eSourceFallback;
+                LOG(eWarning, "Counter %s not available (%s), using %s\n", def.szName, strerror(errno), def.szFallbackName);
+            }
+            else {
+                s_source[nIdx] = eSourceUnavailable;
+                LOG(eWarning, "Counter %s not available (%s)\n", def.szName, strerror(errno));
+            }
+            break;
+        case eSourceEvent:
+            Open(nIdx, def.type, def.config);
+            break;
+        case eSourceFallback:
+            Open(nIdx, def.fallbackType, def.fallbackConfig);
+            break;
+        default:
+            break;
+        }
+    }
+    return;
+}
+
+PerfHWCounters::~PerfHWCounters()
+{
+    for(uint32_t nIdx = 0; nIdx < eHWCounterCount; nIdx++) {
+        if(m_fd[nIdx] >= 0 && m_fd[nIdx] != m_fdLeader) {
+            close(m_fd[nIdx]);
+        }
+    }
+    if(m_fdLeader >= 0) {
+        close(m_fdLeader);
+    }
+    return;
+}
+
+bool PerfHWCounters::Open(uint32_t nCounter, uint32_t type, uint64_t config)
+{
+    int fd = PerfEventOpen(type, config, m_fdLeader);
+    if(fd < 0) {
+        return false;
+    }
+    if(m_fdLeader < 0) {
+        m_fdLeader = fd;
+    }
+    m_fd[nCounter]      = fd;
+    m_nSlot[nCounter]   = (int32_t)m_nOpen++;
+    return true;
+}
+
+void PerfHWCounters::Read(HWCounterValues* pValues)
+{
+    // { nr, value[nr] } in the order the counters joined the group
+    uint64_t buffer[1 + eHWCounterCount];
+    ssize_t  nSize = (ssize_t)((1 + m_nOpen) * sizeof(uint64_t));
+
+    memset(pValues, 0, sizeof(HWCounterValues));
+    if(m_nOpen == 0 || read(m_fdLeader, buffer, nSize) != nSize || buffer[0] != m_nOpen) {
+        return;
+    }
+    for(uint32_t nIdx = 0; nIdx < eHWCounterCount; nIdx++) {
+        if(m_nSlot[nIdx] >= 0) {
+            pValues->value[nIdx] = buffer[1 + m_nSlot[nIdx]];
+        }
+    }
+}
+
+PerfHWCounters* PerfHWCounters::ForThread()
+{
+    // Counters are per thread, closed when the thread exits
+    static thread_local PerfHWCounters t_counters;
+    return &t_counters;
+}
+
+const char* PerfHWCounters::GetName(uint32_t nCounter)
+{
+    if(s_source[nCounter] == eSourceFallback) {
+        return s_counters[nCounter].szFallbackName;
+    }
+    return s_counters[nCounter].szName;
+}
+
+bool PerfHWCounters::IsAvailable(uint32_t nCounter)
+{
+    return s_source[nCounter] == eSourceEvent || s_source[nCounter] == eSourceFallback;
+}
+
+bool PerfHWCounters::HasIPC()
+{
+    return s_source[eHWCycles] == eSourceEvent && s_source[eHWInstructions] == eSourceEvent;
+}
@@ -0,0 +1,73 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef __RDK_PERF_HWCOUNTERS_H__
+#define __RDK_PERF_HWCOUNTERS_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Counters read for every scope when built with PERF_HW_COUNTERS.  The
+// arrays are always present so that the layout of PerfRecord does not
+// depend on the feature flag.
+typedef enum _HWCounter
+{
+    eHWCycles           = 0,
+    eHWInstructions     = 1,
+    eHWCacheMisses      = 2,
+    eHWBranchMisses     = 3,
+    eHWContextSwitches  = 4,
+    eHWPageFaults       = 5,
+    eHWCounterCount     = 6
+} HWCounter;
+
+typedef struct _HWCounterValues
+{
+    uint64_t            value[eHWCounterCount];
+} HWCounterValues;
+
+// Per thread group of perf_event_open counters, opened on first use.  The
+// first counter that opens leads the group, the others join it, and
+// PERF_FORMAT_GROUP returns all of them with a single read() of the
+// leader.  When the PMU is not available (VMs, containers) cycles fall back
+// to the task clock and the other hardware counters are reported as
+// unavailable.
+class PerfHWCounters
+{
+public:
+    PerfHWCounters();
+    ~PerfHWCounters();
+
+    static PerfHWCounters* ForThread();
+    static const char* GetName(uint32_t nCounter);
+    static bool IsAvailable(uint32_t nCounter);
+    static bool HasIPC();
+
+    void Read(HWCounterValues* pValues);
+
+private:
+    bool Open(uint32_t nCounter, uint32_t type, uint64_t config);
+
+    int                 m_fdLeader;
+    int                 m_fd[eHWCounterCount];
+    int32_t             m_nSlot[eHWCounterCount];  // Position in the group read, -1 when not open
+    uint32_t            m_nOpen;
+};
+
+#endif // __RDK_PERF_HWCOUNTERS_H__
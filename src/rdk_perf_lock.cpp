@@ -0,0 +1,245 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "rdk_perf_lock.h"
+#include "rdk_perf_record.h"
+#include "rdk_perf_logging.h"
+#include "rdk_perf_scopedlock.h"
+
+#ifndef MIN
+#define MIN(a,b) (((a)<(b))?(a):(b))
+#endif
+
+// Named locks of this process, for the process report
+static std::map<std::string, PerfLock*>* s_pLocks = NULL;
+
+PerfLock::PerfLock(const char* szName, LockType type)
+: m_name(szName)
+, m_type(type)
+, m_nRefCount(0)
+, m_nCount(0)
+, m_nContended(0)
+, m_nWaitUS(0)
+, m_nWaitMaxUS(0)
+, m_nHoldUS(0)
+, m_nHoldMaxUS(0)
+, m_nTotalCount(0)
+, m_nTotalContended(0)
+{
+    pthread_spin_init(&m_scopeLock, PTHREAD_PROCESS_PRIVATE);
+    return;
+}
+
+PerfLock::~PerfLock()
+{
+    pthread_spin_destroy(&m_scopeLock);
+    return;
+}
+
+uint64_t PerfLock::TimeStamp()
+{
+    struct timespec timeStamp;
+    clock_gettime(CLOCK_MONOTONIC, &timeStamp);
+    return ((uint64_t)timeStamp.tv_sec * 1000000) + (timeStamp.tv_nsec / 1000);
+}
+
+void PerfLock::UpdateMax(std::atomic<uint64_t>& nMax, uint64_t nValue)
+{
+    uint64_t nCurrent = nMax.load(std::memory_order_relaxed);
+    while(nValue > nCurrent && !nMax.compare_exchange_weak(nCurrent, nValue, std::memory_order_relaxed)) {
+    }
+}
+
+void PerfLock::NoteAcquire(uint64_t nWaitUS, bool bContended)
+{
+    m_nCount.fetch_add(1, std::memory_order_relaxed);
+    if(!bContended) {
+        return;
+    }
+
+    m_nContended.fetch_add(1, std::memory_order_relaxed);
+    m_nWaitUS.fetch_add(nWaitUS, std::memory_order_relaxed);
+    UpdateMax(m_nWaitMaxUS, nWaitUS);
+    m_wait.Add(nWaitUS);
+
+    // Which scope was waiting, only on the contended path.  Under the lock,
+    // the record may be stopped on another thread.
+    std::string scope("(no scope)");
+    {
+        SCOPED_LOCK();
+        PerfRecord* pRecord = PerfRecord::Current();
+        if(pRecord != NULL) {
+            scope = pRecord->GetName();
+        }
+    }
+
+    pthread_spin_lock(&m_scopeLock);
+    ScopeWait& entry = m_scopes[scope];
+    entry.nCount++;
+    entry.nWaitUS += nWaitUS;
+    pthread_spin_unlock(&m_scopeLock);
+}
+
+void PerfLock::NoteRelease(uint64_t nHoldUS)
+{
+    m_nHoldUS.fetch_add(nHoldUS, std::memory_order_relaxed);
+    UpdateMax(m_nHoldMaxUS, nHoldUS);
+}
+
+void PerfLock::NoteWait(uint64_t nWaitUS, bool bTimedOut)
+{
+    m_nCount.fetch_add(1, std::memory_order_relaxed);
+    if(bTimedOut) {
+        m_nContended.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_nWaitUS.fetch_add(nWaitUS, std::memory_order_relaxed);
+    UpdateMax(m_nWaitMaxUS, nWaitUS);
+    m_wait.Add(nWaitUS);
+}
+
+void PerfLock::ReportData()
+{
+    std::map<std::string, ScopeWait> scopes;
+
+    const uint64_t nCount       = m_nCount.exchange(0, std::memory_order_relaxed);
+    const uint64_t nContended   = m_nContended.exchange(0, std::memory_order_relaxed);
+    const uint64_t nWaitUS      = m_nWaitUS.exchange(0, std::memory_order_relaxed);
+    const uint64_t nWaitMaxUS   = m_nWaitMaxUS.exchange(0, std::memory_order_relaxed);
+    const uint64_t nHoldUS      = m_nHoldUS.exchange(0, std::memory_order_relaxed);
+    const uint64_t nHoldMaxUS   = m_nHoldMaxUS.exchange(0, std::memory_order_relaxed);
+    PerfHistogram wait;
+    wait.Merge(m_wait);
+    m_wait.Reset();
+
+    pthread_spin_lock(&m_scopeLock);
+    scopes.swap(m_scopes);
+    pthread_spin_unlock(&m_scopeLock);
+
+    m_nTotalCount       += nCount;
+    m_nTotalContended   += nContended;
+
+    if(m_type == eLockCondVar) {
+        LOG(eWarning, "CondVar %s (Waits, Timeouts) Total %llu, %llu Interval %llu, %llu\n",
+            m_name.c_str(), m_nTotalCount, m_nTotalContended, nCount, nContended);
+        if(nCount != 0) {
+            LOG(eWarning, "--| wait ms (Max, Avg) %0.3lf, %0.3lf p50 %0.3lf, p90 %0.3lf, p99 %0.3lf\n",
+                (double)nWaitMaxUS / 1000.0, (double)nWaitUS / (double)nCount / 1000.0,
+                (double)MIN(wait.Percentile(50.0), nWaitMaxUS) / 1000.0,
+                (double)MIN(wait.Percentile(90.0), nWaitMaxUS) / 1000.0,
+                (double)MIN(wait.Percentile(99.0), nWaitMaxUS) / 1000.0);
+        }
+        return;
+    }
+
+    LOG(eWarning, "Lock %s (Acquired, Contended %%) Total %llu, %0.1f Interval %llu, %0.1f\n",
+        m_name.c_str(),
+        m_nTotalCount, (m_nTotalCount == 0) ? 0.0 : (double)m_nTotalContended * 100.0 / (double)m_nTotalCount,
+        nCount, (nCount == 0) ? 0.0 : (double)nContended * 100.0 / (double)nCount);
+    if(nContended != 0) {
+        LOG(eWarning, "--| wait ms (Max, Avg) %0.3lf, %0.3lf p50 %0.3lf, p90 %0.3lf, p99 %0.3lf\n",
+            (double)nWaitMaxUS / 1000.0, (double)nWaitUS / (double)nContended / 1000.0,
+            (double)MIN(wait.Percentile(50.0), nWaitMaxUS) / 1000.0,
+            (double)MIN(wait.Percentile(90.0), nWaitMaxUS) / 1000.0,
+            (double)MIN(wait.Percentile(99.0), nWaitMaxUS) / 1000.0);
+    }
+    if(nCount != 0) {
+        LOG(eWarning, "--| hold ms (Max, Avg) %0.3lf, %0.3lf\n",
+            (double)nHoldMaxUS / 1000.0, (double)nHoldUS / (double)nCount / 1000.0);
+    }
+    auto it = scopes.begin();
+    while(it != scopes.end()) {
+        LOG(eWarning, "  | waited in %s %llu times, %0.3lf ms\n",
+            it->first.c_str(), it->second.nCount, (double)it->second.nWaitUS / 1000.0);
+        it++;
+    }
+}
+
+PerfLock* PerfLock::GetLock(const char* szName, LockType type)
+{
+    SCOPED_LOCK();
+
+    if(s_pLocks == NULL) {
+        s_pLocks = new std::map<std::string, PerfLock*>();
+    }
+
+    // Mutexes and condition variables may use the same name
+    std::string key = std::string(type == eLockCondVar ? "c:" : "m:") + szName;
+    PerfLock* pLock = NULL;
+    auto it = s_pLocks->find(key);
+    if(it == s_pLocks->end()) {
+        pLock = new PerfLock(szName, type);
+        (*s_pLocks)[key] = pLock;
+    }
+    else {
+        pLock = it->second;
+    }
+    pLock->m_nRefCount++;
+
+    return pLock;
+}
+
+void PerfLock::ReleaseLock(PerfLock* pLock)
+{
+    SCOPED_LOCK();
+
+    // Kept with no references until the next report has printed its
+    // statistics, a lock created and destroyed between reports would
+    // otherwise never show up
+    pLock->m_nRefCount--;
+}
+
+void PerfLock::ReportAll()
+{
+    SCOPED_LOCK();
+
+#ifdef PERF_LOCK_STATS
+    Library()->ReportData();
+#endif
+
+    if(s_pLocks == NULL) {
+        return;
+    }
+
+    auto it = s_pLocks->begin();
+    while(it != s_pLocks->end()) {
+        it->second->ReportData();
+        if(it->second->m_nRefCount == 0) {
+            delete it->second;
+            it = s_pLocks->erase(it);
+        }
+        else {
+            it++;
+        }
+    }
+    if(s_pLocks->empty()) {
+        delete s_pLocks;
+        s_pLocks = NULL;
+    }
+}
+
+PerfLock* PerfLock::Library()
+{
+    // Never deleted, ScopedMutex may still be used while static objects are destroyed
+    static PerfLock* s_pLibrary = new PerfLock("rdkperf", eLockMutex);
+    return s_pLibrary;
+}
@@ -0,0 +1,90 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef __RDK_PERF_LOCK_H__
+#define __RDK_PERF_LOCK_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <atomic>
+#include <string>
+#include <map>
+
+#include "rdk_perf_histogram.h"
+
+typedef enum _LockType
+{
+    eLockMutex      = 0,    // Wait to acquire, hold time and contention
+    eLockCondVar    = 1     // Time blocked in wait and timeouts
+} LockType;
+
+// Contention statistics of a named lock.  Locks with the same name share
+// one instance, e.g. the per object mutex of a class.  Updates only use
+// atomics, except that a contended acquisition also records the scope that
+// was open on the waiting thread.
+class PerfLock
+{
+public:
+    PerfLock(const char* szName, LockType type);
+    ~PerfLock();
+
+    void NoteAcquire(uint64_t nWaitUS, bool bContended);
+    void NoteRelease(uint64_t nHoldUS);
+    void NoteWait(uint64_t nWaitUS, bool bTimedOut);
+
+    void ReportData();
+
+    // Monotonic time in us, waits must not jump with the wall clock
+    static uint64_t TimeStamp();
+    // Shared, reference counted instance for the name
+    static PerfLock* GetLock(const char* szName, LockType type);
+    // The last release keeps the instance until ReportAll() printed it
+    static void ReleaseLock(PerfLock* pLock);
+    static void ReportAll();
+    // Statistics of RDKPERF::ScopedMutex, only updated with PERF_LOCK_STATS
+    static PerfLock* Library();
+
+private:
+    typedef struct _ScopeWait
+    {
+        uint64_t    nCount;
+        uint64_t    nWaitUS;
+    } ScopeWait;
+
+    static void UpdateMax(std::atomic<uint64_t>& nMax, uint64_t nValue);
+
+    std::string             m_name;
+    LockType                m_type;
+    uint32_t                m_nRefCount;        // Changed under the global lock
+    std::atomic<uint64_t>   m_nCount;           // Acquisitions or waits in the interval
+    std::atomic<uint64_t>   m_nContended;       // Contended acquisitions or timeouts
+    std::atomic<uint64_t>   m_nWaitUS;
+    std::atomic<uint64_t>   m_nWaitMaxUS;
+    std::atomic<uint64_t>   m_nHoldUS;
+    std::atomic<uint64_t>   m_nHoldMaxUS;
+    uint64_t                m_nTotalCount;
+    uint64_t                m_nTotalContended;
+    PerfAtomicHistogram     m_wait;             // Contended waits only
+    pthread_spinlock_t      m_scopeLock;
+    std::map<std::string, ScopeWait> m_scopes;  // Waiting scope name, interval
+};
+
+#endif // __RDK_PERF_LOCK_H__
@@ -21,8 +21,12 @@
 
 #include <unistd.h> // for getipd()
 #include <pthread.h>
+#include <syslog.h>
+#include <errno.h>
 
 static bool s_VerboseLog = false;
+static bool s_bSyslog    = false;
+static FILE* s_fpSink    = NULL;    // Replaces stdout and stderr when set
 void RDKPerfLogging(eLogLevel level, const char* function, int line, const char * format, ...)
 {    
     char logMessage[LOG_MESSAGE_SIZE];
@@ -40,8 +44,16 @@ void RDKPerfLogging(eLogLevel level, const char* function, int line, const char
     vsnprintf(logMessage, LOG_MESSAGE_SIZE, format, ap);
     va_end(ap);
 
+    if(s_bSyslog) {
+        syslog(level == eError ? LOG_ERR : LOG_INFO, "%s(%d) : %s", function, line, logMessage);
+        return;
+    }
+
     FILE* fpOut = stdout;
-    if(level == eError) {
+    if(s_fpSink != NULL) {
+        fpOut = s_fpSink;
+    }
+    else if(level == eError) {
         fpOut = stderr;
     }
 
@@ -51,6 +63,33 @@ void RDKPerfLogging(eLogLevel level, const char* function, int line, const char
     return;
 }
 
+void RDKPerfSetLogSink(const char* szSink)
+{
+    SCOPED_LOCK();
+
+    if(s_fpSink != NULL) {
+        fclose(s_fpSink);
+        s_fpSink = NULL;
+    }
+    if(s_bSyslog) {
+        closelog();
+        s_bSyslog = false;
+    }
+
+    if(szSink == NULL || strcmp(szSink, "stdout") == 0) {
+        return;
+    }
+    if(strcmp(szSink, "syslog") == 0) {
+        openlog("rdkperf", LOG_PID, LOG_USER);
+        s_bSyslog = true;
+        return;
+    }
+    s_fpSink = fopen(szSink, "ae");
+    if(s_fpSink == NULL) {
+        LOG(eError, "Could not open log file %s (%s), logging to stdout\n", szSink, strerror(errno));
+    }
+}
+
 static void __attribute__((constructor)) LogModuleInit();
 static void __attribute__((destructor)) LogModuleTerminate();
 
@@ -36,6 +36,8 @@ typedef enum eLogLevel_
 #define LOG_MESSAGE_SIZE 4096
 
 void RDKPerfLogging(eLogLevel level, const char* function, int line, const char * format, ...);
+// "syslog", a file name to append to, or NULL for stdout and stderr
+void RDKPerfSetLogSink(const char* szSink);
 void DebugBinaryData(char* szName, uint8_t* pData, size_t nSize);
 
 #endif // __RDK_PERF_LOGGING_H__
@@ -0,0 +1,236 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "rdk_perf_metrics.h"
+#include "rdk_perf_node.h"
+#include "rdk_perf_logging.h"
+#include "rdk_perf_scopedlock.h"
+
+#ifndef MIN
+#define MIN(a,b) (((a)<(b))?(a):(b))
+#endif
+
+static const char* s_typeNames[] = { "counter", "gauge", "distribution" };
+
+static PerfMetricMap*   s_pGlobals = NULL;
+
+static void __attribute__((destructor)) MetricsModuleTerminate();
+
+// This function is assigned to execute as library unload
+// using __attribute__((destructor))
+static void MetricsModuleTerminate()
+{
+    SCOPED_LOCK();
+
+    if(s_pGlobals != NULL) {
+        auto it = s_pGlobals->begin();
+        while(it != s_pGlobals->end()) {
+            delete it->second;
+            it++;
+        }
+        delete s_pGlobals;
+        s_pGlobals = NULL;
+    }
+}
+
+PerfMetric::PerfMetric(const std::string& name, MetricType type)
+: m_name(name)
+, m_type(type)
+, m_nTotal(0)
+, m_nInterval(0)
+, m_nMin(INT64_MAX)
+, m_nMax(INT64_MIN)
+, m_nCount(0)
+, m_pHistogram(NULL)
+{
+    if(m_type == eMetricDistribution) {
+        m_pHistogram = new PerfAtomicHistogram();
+    }
+    return;
+}
+
+PerfMetric::~PerfMetric()
+{
+    if(m_pHistogram != NULL) {
+        delete m_pHistogram;
+    }
+    return;
+}
+
+void PerfMetric::UpdateRange(int64_t nValue)
+{
+    int64_t nCurrent = m_nMin.load(std::memory_order_relaxed);
+    while(nValue < nCurrent && !m_nMin.compare_exchange_weak(nCurrent, nValue, std::memory_order_relaxed));
+
+    nCurrent = m_nMax.load(std::memory_order_relaxed);
+    while(nValue > nCurrent && !m_nMax.compare_exchange_weak(nCurrent, nValue, std::memory_order_relaxed));
+}
+
+void PerfMetric::Add(int64_t nValue)
+{
+    if(m_type == eMetricGauge) {
+        // Relative update of a gauge, e.g. queue depth +1/-1
+        int64_t nNew = m_nTotal.fetch_add(nValue, std::memory_order_relaxed) + nValue;
+        m_nCount.fetch_add(1, std::memory_order_relaxed);
+        UpdateRange(nNew);
+        return;
+    }
+    m_nTotal.fetch_add(nValue, std::memory_order_relaxed);
+    m_nInterval.fetch_add(nValue, std::memory_order_relaxed);
+    m_nCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerfMetric::Set(int64_t nValue)
+{
+    m_nTotal.store(nValue, std::memory_order_relaxed);
+    m_nCount.fetch_add(1, std::memory_order_relaxed);
+    UpdateRange(nValue);
+}
+
+void PerfMetric::Record(uint64_t nValue)
+{
+    if(m_pHistogram == NULL) {
+        Add((int64_t)nValue);
+        return;
+    }
+    m_nTotal.fetch_add((int64_t)nValue, std::memory_order_relaxed);
+    m_nInterval.fetch_add((int64_t)nValue, std::memory_order_relaxed);
+    m_nCount.fetch_add(1, std::memory_order_relaxed);
+    UpdateRange((int64_t)nValue);
+    m_pHistogram->Add(nValue);
+}
+
+void PerfMetric::ReportData(uint32_t nLevel, uint32_t msIntervalTime)
+{
+    char buffer[MAX_BUF_SIZE] = { 0 };
+    char* ptr = &buffer[0];
+
+    // Print the indent
+    for(uint32_t nIdx = 0; nIdx < nLevel; nIdx++) {
+        snprintf(ptr, MAX_BUF_SIZE, "--");
+        ptr += 2;
+    }
+
+    // Updates that land while the report is printed go to the next interval
+    const uint64_t nCount = m_nCount.exchange(0, std::memory_order_relaxed);
+
+    switch(m_type) {
+    case eMetricCounter: {
+        const int64_t nInterval = m_nInterval.exchange(0, std::memory_order_relaxed);
+        const double  rate      = (msIntervalTime == 0) ? 0.0 : (double)nInterval * 1000.0 / (double)msIntervalTime;
+        snprintf(ptr, MAX_BUF_SIZE - strlen(buffer), "* %s %s Total %lld Interval %lld Rate %0.1f/s",
+                 m_name.c_str(), s_typeNames[m_type],
+                 (long long)m_nTotal.load(), (long long)nInterval, rate);
+        break;
+    }
+    case eMetricGauge: {
+        const int64_t nLast = m_nTotal.load(std::memory_order_relaxed);
+        const int64_t nMin  = m_nMin.exchange(nLast, std::memory_order_relaxed);
+        const int64_t nMax  = m_nMax.exchange(nLast, std::memory_order_relaxed);
+        if(nCount == 0) {
+            snprintf(ptr, MAX_BUF_SIZE - strlen(buffer), "* %s %s Last %lld (no updates in interval)",
+                     m_name.c_str(), s_typeNames[m_type], (long long)nLast);
+        }
+        else {
+            snprintf(ptr, MAX_BUF_SIZE - strlen(buffer), "* %s %s (Last, Min, Max) %lld, %lld, %lld Updates %llu",
+                     m_name.c_str(), s_typeNames[m_type],
+                     (long long)nLast, (long long)nMin, (long long)nMax, (unsigned long long)nCount);
+        }
+        break;
+    }
+    case eMetricDistribution: {
+        const int64_t nInterval = m_nInterval.exchange(0, std::memory_order_relaxed);
+        const int64_t nMin      = m_nMin.exchange(INT64_MAX, std::memory_order_relaxed);
+        const int64_t nMax      = m_nMax.exchange(INT64_MIN, std::memory_order_relaxed);
+        const double  rate      = (msIntervalTime == 0) ? 0.0 : (double)nInterval * 1000.0 / (double)msIntervalTime;
+        if(nCount == 0) {
+            snprintf(ptr, MAX_BUF_SIZE - strlen(buffer), "* %s %s Total %lld (no values in interval)",
+                     m_name.c_str(), s_typeNames[m_type], (long long)m_nTotal.load());
+        }
+        else {
+            snprintf(ptr, MAX_BUF_SIZE - strlen(buffer), "* %s %s (Count, Max, Min, Avg) Interval %llu, %lld, %lld, %0.1f p50 %llu, p90 %llu, p99 %llu Rate %0.1f/s",
+                     m_name.c_str(), s_typeNames[m_type],
+                     (unsigned long long)nCount, (long long)nMax, (long long)nMin, (double)nInterval / (double)nCount,
+                     (unsigned long long)MIN((int64_t)m_pHistogram->Percentile(50.0), nMax),
+                     (unsigned long long)MIN((int64_t)m_pHistogram->Percentile(90.0), nMax),
+                     (unsigned long long)MIN((int64_t)m_pHistogram->Percentile(99.0), nMax),
+                     rate);
+        }
+        m_pHistogram->Reset();
+        break;
+    }
+    }
+
+    LOG(eWarning, "%s\n", buffer);
+}
+
+PerfMetric* PerfMetric::Discard()
+{
+    static PerfMetric s_discard("discard", eMetricCounter);
+    return &s_discard;
+}
+
+PerfMetric* PerfMetric::GetGlobal(const char* szName, MetricType type)
+{
+    SCOPED_LOCK();
+
+    if(s_pGlobals == NULL) {
+        s_pGlobals = new PerfMetricMap();
+    }
+    return RDKPerf_GetMetric(*s_pGlobals, szName, type);
+}
+
+void PerfMetric::ReportGlobals(uint32_t msIntervalTime)
+{
+    SCOPED_LOCK();
+
+    if(s_pGlobals == NULL || s_pGlobals->empty()) {
+        return;
+    }
+
+    LOG(eWarning, "Process metrics, Interval Elapsed wallClock: %lu ms\n", msIntervalTime);
+    auto it = s_pGlobals->begin();
+    while(it != s_pGlobals->end()) {
+        it->second->ReportData(1, msIntervalTime);
+        it++;
+    }
+}
+
+PerfMetric* RDKPerf_GetMetric(PerfMetricMap& metrics, const char* szName, MetricType type)
+{
+    PerfMetric* pMetric = NULL;
+
+    auto it = metrics.find(szName);
+    if(it == metrics.end()) {
+        pMetric = new PerfMetric(szName, type);
+        metrics[szName] = pMetric;
+    }
+    else {
+        pMetric = it->second;
+        if(pMetric->GetType() != type) {
+            LOG(eError, "Metric %s already exists as a %s, not a %s\n",
+                szName, s_typeNames[pMetric->GetType()], s_typeNames[type]);
+        }
+    }
+
+    return pMetric;
+}
@@ -0,0 +1,81 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef __RDK_PERF_METRICS_H__
+#define __RDK_PERF_METRICS_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <string>
+#include <map>
+
+#include "rdk_perf_histogram.h"
+
+// Values match RDKPerfMetricType in rdk_perf.h
+typedef enum _MetricType
+{
+    eMetricCounter      = 0,    // Monotonic, reported as total, interval and rate
+    eMetricGauge        = 1,    // Last value with the min and max of the interval
+    eMetricDistribution = 2     // Count, average and percentiles of recorded values
+} MetricType;
+
+// Metrics are created under the global lock, updating one only uses atomics.
+// A metric lives as long as the node or process map that owns it.
+class PerfMetric
+{
+public:
+    PerfMetric(const std::string& name, MetricType type);
+    ~PerfMetric();
+
+    void Add(int64_t nValue);
+    void Set(int64_t nValue);
+    void Record(uint64_t nValue);
+
+    const std::string& GetName() { return m_name; };
+    MetricType GetType() { return m_type; };
+
+    void ReportData(uint32_t nLevel, uint32_t msIntervalTime);
+
+    // Sink for updates when metrics are not available (remote or disabled builds)
+    static PerfMetric* Discard();
+    // Process wide metrics, reported with the process
+    static PerfMetric* GetGlobal(const char* szName, MetricType type);
+    static void ReportGlobals(uint32_t msIntervalTime);
+
+private:
+    void UpdateRange(int64_t nValue);
+
+    std::string             m_name;
+    MetricType              m_type;
+    std::atomic<int64_t>    m_nTotal;       // Counter total, gauge last value, distribution sum
+    std::atomic<int64_t>    m_nInterval;    // Counter and distribution sum since the last report
+    std::atomic<int64_t>    m_nMin;
+    std::atomic<int64_t>    m_nMax;
+    std::atomic<uint64_t>   m_nCount;
+    PerfAtomicHistogram*    m_pHistogram;   // Distribution only
+};
+
+typedef std::map<std::string, PerfMetric*> PerfMetricMap;
+
+// Finds or creates a metric in the map, must be called with the lock held
+PerfMetric* RDKPerf_GetMetric(PerfMetricMap& metrics, const char* szName, MetricType type);
+
+#endif // __RDK_PERF_METRICS_H__
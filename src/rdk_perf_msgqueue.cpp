@@ -151,6 +151,25 @@ bool PerfMsgQueue::SendMessage(MessageType type, const char* szName, uint64_t nT
     return retVal;
 }
 
+bool PerfMsgQueue::SendAsyncMessage(MessageType type, const char* szName, uint64_t nID, uint64_t nTimeStamp)
+{
+    PerfMessage msg;
+
+    // Set message data to 0s
+    memset((void*)&msg, 0, sizeof(PerfMessage));
+
+    msg.type = type;
+    msg.msg_data.async.pID = getpid();
+    msg.msg_data.async.tID = pthread_self();
+    msg.msg_data.async.nID = nID;
+    msg.msg_data.async.nTimeStamp = nTimeStamp;
+    if(szName != NULL) {
+        memcpy((void*)msg.msg_data.async.szName, (void*)szName, MIN((size_t)(MAX_NAME_LEN - 1), strlen(szName)));
+    }
+
+    return SendMessage(&msg);
+}
+
 bool PerfMsgQueue::SendMessage(PerfMessage* pMsg)
 {
     bool            retVal      = false;
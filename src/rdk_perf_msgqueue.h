@@ -57,6 +57,8 @@ typedef enum _MessageType
     eReportProcess   = 5,
     eCloseThread     = 6,
     eCloseProcess    = 7,
+    eAsyncBegin      = 8,
+    eAsyncEnd        = 9,
     eExitQueue       = 9998,
     eMaxType         = 9999
 } MessageType;
@@ -109,6 +111,15 @@ typedef struct _CloseProcess
     pid_t               pID;
 } CloseProcess;
 
+typedef struct _AsyncMessage 
+{
+    pid_t               pID;
+    pthread_t           tID;
+    char                szName[MAX_NAME_LEN];
+    uint64_t            nID;
+    uint64_t            nTimeStamp;
+} AsyncMessage;
+
 typedef union _MessageData
 {
     EntryMessage        entry;
@@ -118,6 +129,7 @@ typedef union _MessageData
     ReportProcess       report_process;
     CloseThread         close_thread;
     CloseProcess        close_process;
+    AsyncMessage        async;
 } MessageData;
 
 typedef struct _PerfMessage 
@@ -139,6 +151,7 @@ public:
 
     bool SendMessage(MessageType type, const char* szName = NULL, uint64_t nTimeStamp = 0, int32_t nThresholdInUS = -1);
     bool SendMessage(PerfMessage* pMsg);
+    bool SendAsyncMessage(MessageType type, const char* szName, uint64_t nID, uint64_t nTimeStamp);
     bool ReceiveMessage(PerfMessage* pMsg, int32_t nTimeoutInMS = 0);
 
     static PerfMsgQueue* GetQueue(const char* szQueueName, bool bService);
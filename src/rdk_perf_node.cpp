@@ -22,15 +22,23 @@
 #include <string.h>
 #include <dlfcn.h>
 #include <unistd.h>
+#include <time.h>
+
+#include <algorithm>
 
 #include "rdk_perf_node.h"
 #include "rdk_perf_record.h"
 #include "rdk_perf_tree.h"
 #include "rdk_perf_process.h"
 #include "rdk_perf_logging.h"
+#include "rdk_perf_symbols.h"
+#include "rdk_perf_scopedlock.h"
+#include "rdk_perf_system.h"
 
 PerfNode::PerfNode()
 : m_elementName("root_node"), m_Tree(NULL), m_ThresholdInUS(-1)
+, m_nConfigGeneration(0), m_nSampleCount(0)
+, m_pParent(NULL), m_pMirror(NULL), m_pWindow(NULL)
 {
     m_startTime     = TimeStamp();
     m_idThread      = pthread_self();
@@ -49,6 +57,8 @@ PerfNode::PerfNode()
 
 PerfNode::PerfNode(PerfRecord* pRecord)
 : m_Tree(NULL), m_ThresholdInUS(-1)
+, m_nConfigGeneration(0), m_nSampleCount(0)
+, m_pParent(NULL), m_pMirror(NULL), m_pWindow(NULL)
 {
     m_idThread      = pRecord->GetThreadID();
     m_elementName   = pRecord->GetName();
@@ -66,6 +76,8 @@ PerfNode::PerfNode(PerfRecord* pRecord)
 
 PerfNode::PerfNode(char* szName, pthread_t tID, uint64_t nStartTime)
 : m_Tree(NULL), m_ThresholdInUS(-1)
+, m_nConfigGeneration(0), m_nSampleCount(0)
+, m_pParent(NULL), m_pMirror(NULL), m_pWindow(NULL)
 {
     m_idThread      = tID;
     m_elementName   = std::string(szName);
@@ -85,6 +97,8 @@ PerfNode::~PerfNode()
 {
     // LOG(eWarning, "Deleting Node %s\n", GetName().c_str());
 
+    delete m_pWindow;
+
     // This is a node in the tree and should be cleaned up
     auto it = m_childNodes.begin();
     while(it != m_childNodes.end()) {
@@ -92,6 +106,12 @@ PerfNode::~PerfNode()
         it++;
     }
 
+    auto itMetric = m_metrics.begin();
+    while(itMetric != m_metrics.end()) {
+        delete itMetric->second;
+        itMetric++;
+    }
+
     return;
 }
 PerfNode* PerfNode::AddChild(PerfRecord * pRecord)
@@ -103,6 +123,7 @@ PerfNode* PerfNode::AddChild(PerfRecord * pRecord)
         // new child
         // Create copy of Node for storage in the tree
         pNode = new PerfNode(pRecord);
+        pNode->m_pParent = this;
         m_childNodes[pRecord->GetName()] = pNode;
     }
     else {
@@ -122,6 +143,7 @@ PerfNode* PerfNode::AddChild(char* szName, pthread_t tID, uint64_t nStartTime)
         // new child
         // Create copy of Node for storage in the tree
         pNode = new PerfNode(szName, tID, nStartTime);
+        pNode->m_pParent = this;
         m_childNodes[szName] = pNode;
     }
     else {
@@ -131,6 +153,13 @@ PerfNode* PerfNode::AddChild(char* szName, pthread_t tID, uint64_t nStartTime)
     return pNode;
 }
 
+PerfMetric* PerfNode::GetMetric(const char* szName, MetricType type)
+{
+    SCOPED_LOCK();
+
+    return RDKPerf_GetMetric(m_metrics, szName, type);
+}
+
 void PerfNode::CloseNode()
 {
     if(m_Tree != NULL) {
@@ -170,11 +199,342 @@ void PerfNode::IncrementData(uint64_t deltaTime, uint64_t userCPU, uint64_t syst
     m_stats.nTotalUserCPU += userCPU;
     m_stats.nTotalSystemCPU += systemCPU;
 
+    // Only scopes that are asked for pay for the window and the clock
+    if(m_pWindow == NULL && GetConfig()->bWindow) {
+        m_pWindow = new PerfWindow();
+    }
+    if(m_pWindow != NULL) {
+        m_pWindow->Add(deltaTime, PerfWindow::Now());
+    }
+
+    return;
+}
+
+void PerfNode::IncrementCounters(const HWCounterValues* pDelta)
+{
+    for(uint32_t nIdx = 0; nIdx < eHWCounterCount; nIdx++) {
+        m_stats.nLastCounters[nIdx]      = pDelta->value[nIdx];
+        m_stats.nIntervalCounters[nIdx] += pDelta->value[nIdx];
+        m_stats.nTotalCounters[nIdx]    += pDelta->value[nIdx];
+    }
+
+    return;
+}
+
+void PerfNode::IncrementAllocs(uint64_t nAllocs, uint64_t nAllocBytes, uint64_t nFrees, uint64_t nFreeBytes)
+{
+    m_stats.nIntervalAllocs     += nAllocs;
+    m_stats.nIntervalAllocBytes += nAllocBytes;
+    m_stats.nIntervalFrees      += nFrees;
+    m_stats.nIntervalFreeBytes  += nFreeBytes;
+    m_stats.nTotalAllocs        += nAllocs;
+    m_stats.nTotalAllocBytes    += nAllocBytes;
+
+    return;
+}
+
+static bool SlowerThan(const SlowInvocation& a, const SlowInvocation& b)
+{
+    return a.nDuration > b.nDuration;
+}
+
+void PerfNode::AddInvocation(const SlowInvocation& invocation)
+{
+    if(m_slowest.size() < SLOWEST_COUNT) {
+        m_slowest.push_back(invocation);
+        std::push_heap(m_slowest.begin(), m_slowest.end(), SlowerThan);
+    }
+    else if(invocation.nDuration > m_slowest.front().nDuration) {
+        // Replace the fastest of the kept invocations
+        std::pop_heap(m_slowest.begin(), m_slowest.end(), SlowerThan);
+        m_slowest.back() = invocation;
+        std::push_heap(m_slowest.begin(), m_slowest.end(), SlowerThan);
+    }
+
+    return;
+}
+
+void PerfNode::ReportSlowest(uint32_t nLevel)
+{
+    char buffer[MAX_BUF_SIZE] = { 0 };
+
+    // Only outliers are worth a line, a single call is not an outlier
+    if(m_stats.nIntervalCount < 2) {
+        return;
+    }
+
+    // Slowest first
+    std::vector<SlowInvocation> slowest(m_slowest);
+    std::sort_heap(slowest.begin(), slowest.end(), SlowerThan);
+
+    auto it = slowest.begin();
+    while(it != slowest.end() && (double)it->nDuration >= m_stats.nIntervalAvg * SLOWEST_FACTOR) {
+        char*       ptr = &buffer[0];
+        struct tm   local;
+        time_t      seconds = (time_t)(it->nStartTime / 1000000);
+
+        for(uint32_t nIdx = 0; nIdx < nLevel; nIdx++) {
+            snprintf(ptr, MAX_BUF_SIZE, "--");
+            ptr += 2;
+        }
+        localtime_r(&seconds, &local);
+        size_t nUsed = ptr - buffer;
+        nUsed += snprintf(ptr, MAX_BUF_SIZE - nUsed, "! slow at %02d:%02d:%02d.%03u %0.3lf ms thread %X",
+                          local.tm_hour, local.tm_min, local.tm_sec, (uint32_t)((it->nStartTime % 1000000) / 1000),
+                          (double)it->nDuration / 1000.0, (uint32_t)it->tID);
+        for(uint32_t nIdx = 0; nIdx < it->nChildren && nUsed < MAX_BUF_SIZE; nIdx++) {
+            const ChildTime& child = it->children[nIdx];
+            nUsed += snprintf(buffer + nUsed, MAX_BUF_SIZE - nUsed, "%s %s %ux %0.3lf ms",
+                              nIdx == 0 ? " children" : ",", child.pNode->GetName().c_str(),
+                              child.nCount, (double)child.nTime / 1000.0);
+        }
+        if(it->nOtherChildTime != 0 && nUsed < MAX_BUF_SIZE) {
+            snprintf(buffer + nUsed, MAX_BUF_SIZE - nUsed, ", other %0.3lf ms", (double)it->nOtherChildTime / 1000.0);
+        }
+        LOG(eWarning, "%s\n", buffer);
+        it++;
+    }
+
+    return;
+}
+
+void PerfNode::MergeFrom(PerfNode* pOther)
+{
+    const TimingStats& other = pOther->m_stats;
+
+    m_stats.nLastDelta          = other.nLastDelta;
+    m_stats.nTotalTime         += other.nTotalTime;
+    m_stats.nTotalCount        += other.nTotalCount;
+    m_stats.nTotalMin           = std::min(m_stats.nTotalMin, other.nTotalMin);
+    m_stats.nTotalMax           = std::max(m_stats.nTotalMax, other.nTotalMax);
+    m_stats.nIntervalTime      += other.nIntervalTime;
+    m_stats.nIntervalCount     += other.nIntervalCount;
+    m_stats.nIntervalMin        = std::min(m_stats.nIntervalMin, other.nIntervalMin);
+    m_stats.nIntervalMax        = std::max(m_stats.nIntervalMax, other.nIntervalMax);
+    if(m_stats.nTotalCount != 0) {
+        m_stats.nTotalAvg = (double)m_stats.nTotalTime / (double)m_stats.nTotalCount;
+    }
+    if(m_stats.nIntervalCount != 0) {
+        m_stats.nIntervalAvg = (double)m_stats.nIntervalTime / (double)m_stats.nIntervalCount;
+    }
+
+    m_stats.nUserCPU            = other.nUserCPU;
+    m_stats.nSystemCPU          = other.nSystemCPU;
+    m_stats.nIntervalUserCPU   += other.nIntervalUserCPU;
+    m_stats.nIntervalSystemCPU += other.nIntervalSystemCPU;
+    m_stats.nTotalUserCPU      += other.nTotalUserCPU;
+    m_stats.nTotalSystemCPU    += other.nTotalSystemCPU;
+
+    for(uint32_t nIdx = 0; nIdx < eHWCounterCount; nIdx++) {
+        m_stats.nLastCounters[nIdx]      = other.nLastCounters[nIdx];
+        m_stats.nIntervalCounters[nIdx] += other.nIntervalCounters[nIdx];
+        m_stats.nTotalCounters[nIdx]    += other.nTotalCounters[nIdx];
+    }
+
+    m_stats.nIntervalAllocs     += other.nIntervalAllocs;
+    m_stats.nIntervalAllocBytes += other.nIntervalAllocBytes;
+    m_stats.nIntervalFrees      += other.nIntervalFrees;
+    m_stats.nIntervalFreeBytes  += other.nIntervalFreeBytes;
+    m_stats.nTotalAllocs        += other.nTotalAllocs;
+    m_stats.nTotalAllocBytes    += other.nTotalAllocBytes;
+
+    if(pOther->m_pWindow != NULL) {
+        if(m_pWindow == NULL) {
+            m_pWindow = new PerfWindow();
+        }
+        m_pWindow->Merge(*pOther->m_pWindow);
+    }
+
+    // Slow invocations point at nodes of the other tree and metrics belong
+    // to the other thread's code paths, neither is carried over
+    MergeChildren(pOther);
+
+    return;
+}
+
+void PerfNode::MergeChildren(PerfNode* pOther)
+{
+    // Both child maps are sorted by name, walking them in step finds every
+    // match without a lookup per node
+    auto itMine = m_childNodes.begin();
+    auto it = pOther->m_childNodes.begin();
+    while(it != pOther->m_childNodes.end()) {
+        while(itMine != m_childNodes.end() && itMine->first < it->first) {
+            itMine++;
+        }
+        PerfNode* pChild = NULL;
+        if(itMine != m_childNodes.end() && itMine->first == it->first) {
+            pChild = itMine->second;
+        }
+        else {
+            pChild = new PerfNode((char*)it->first.c_str(), it->second->m_idThread, it->second->m_startTime);
+            pChild->m_ThresholdInUS = it->second->m_ThresholdInUS;
+            pChild->SetTree(m_Tree);
+            pChild->m_pParent = this;
+            itMine = m_childNodes.emplace_hint(itMine, it->first, pChild);
+        }
+        pChild->MergeFrom(it->second);
+        it++;
+    }
+
     return;
 }
 
-void PerfNode::ResetInterval()
+void PerfNode::KeepWindow()
 {
+    if(m_pWindow == NULL) {
+        m_pWindow = new PerfWindow();
+    }
+}
+
+bool PerfNode::GetWindow(uint32_t nSeconds, WindowStats* pStats, bool bCurrent)
+{
+    if(m_pWindow == NULL) {
+        memset((void*)pStats, 0, sizeof(WindowStats));
+        return false;
+    }
+    m_pWindow->Get(nSeconds, PerfWindow::Now(), pStats, bCurrent);
+    return true;
+}
+
+bool PerfNode::CollectWindows(const std::string& name, PerfWindow* pSum)
+{
+    bool bFound = false;
+
+    if(m_pWindow != NULL && m_elementName == name) {
+        pSum->Merge(*m_pWindow);
+        bFound = true;
+    }
+    auto it = m_childNodes.begin();
+    while(it != m_childNodes.end()) {
+        bFound = it->second->CollectWindows(name, pSum) || bFound;
+        it++;
+    }
+
+    return bFound;
+}
+
+PerfNode* PerfNode::GetMirror()
+{
+    if(m_pMirror == NULL) {
+        if(m_pParent == NULL) {
+            // Root of a thread tree, matches the root of the view
+            m_pMirror = (m_Tree != NULL) ? m_Tree->GetViewRoot() : NULL;
+        }
+        else {
+            PerfNode* pParentMirror = m_pParent->GetMirror();
+            if(pParentMirror != NULL) {
+                m_pMirror = pParentMirror->AddChild((char*)m_elementName.c_str(), 0, m_startTime);
+                m_pMirror->m_ThresholdInUS = m_ThresholdInUS;
+            }
+        }
+    }
+    return m_pMirror;
+}
+
+void PerfNode::FoldInterval()
+{
+    if(m_pParent == NULL || m_stats.nIntervalCount == 0 ||
+       !(PerfConfig::ShowProcessView() || PerfSystemView::IsEnabled())) {
+        return;
+    }
+    PerfNode* pMirror = GetMirror();
+    if(pMirror != NULL) {
+        pMirror->AddInterval(m_stats, m_Tree);
+    }
+}
+
+void PerfNode::AddInterval(const TimingStats& stats, PerfTree* pTree)
+{
+    m_stats.nLastDelta          = stats.nLastDelta;
+    m_stats.nTotalTime         += stats.nIntervalTime;
+    m_stats.nTotalCount        += stats.nIntervalCount;
+    m_stats.nTotalMin           = std::min(m_stats.nTotalMin, stats.nIntervalMin);
+    m_stats.nTotalMax           = std::max(m_stats.nTotalMax, stats.nIntervalMax);
+    m_stats.nTotalAvg           = (double)m_stats.nTotalTime / (double)m_stats.nTotalCount;
+    m_stats.nIntervalTime      += stats.nIntervalTime;
+    m_stats.nIntervalCount     += stats.nIntervalCount;
+    m_stats.nIntervalMin        = std::min(m_stats.nIntervalMin, stats.nIntervalMin);
+    m_stats.nIntervalMax        = std::max(m_stats.nIntervalMax, stats.nIntervalMax);
+    m_stats.nIntervalAvg        = (double)m_stats.nIntervalTime / (double)m_stats.nIntervalCount;
+
+    m_stats.nIntervalUserCPU   += stats.nIntervalUserCPU;
+    m_stats.nIntervalSystemCPU += stats.nIntervalSystemCPU;
+    m_stats.nTotalUserCPU      += stats.nIntervalUserCPU;
+    m_stats.nTotalSystemCPU    += stats.nIntervalSystemCPU;
+    for(uint32_t nIdx = 0; nIdx < eHWCounterCount; nIdx++) {
+        m_stats.nIntervalCounters[nIdx] += stats.nIntervalCounters[nIdx];
+        m_stats.nTotalCounters[nIdx]    += stats.nIntervalCounters[nIdx];
+    }
+    m_stats.nIntervalAllocs     += stats.nIntervalAllocs;
+    m_stats.nIntervalAllocBytes += stats.nIntervalAllocBytes;
+    m_stats.nIntervalFrees      += stats.nIntervalFrees;
+    m_stats.nIntervalFreeBytes  += stats.nIntervalFreeBytes;
+    m_stats.nTotalAllocs        += stats.nIntervalAllocs;
+    m_stats.nTotalAllocBytes    += stats.nIntervalAllocBytes;
+
+    // Few threads run the same call path, a linear search is enough
+    auto it = m_shares.begin();
+    while(it != m_shares.end() && it->pTree != pTree) {
+        it++;
+    }
+    if(it == m_shares.end()) {
+        ThreadShare share;
+        char        szName[THREAD_NAMELEN + 32];
+        if(pTree->GetMergedThreads() != 0) {
+            snprintf(szName, sizeof(szName), "exited %s", pTree->GetName());
+        }
+        else {
+            snprintf(szName, sizeof(szName), "%s %X", pTree->GetName(),
+                     (uint32_t)pTree->GetThreadID());
+        }
+        share.pTree         = pTree;
+        share.threadName    = szName;
+        share.nCount        = 0;
+        share.nTime         = 0;
+        m_shares.push_back(share);
+        it = m_shares.end() - 1;
+    }
+    it->nCount  += stats.nIntervalCount;
+    it->nTime   += stats.nIntervalTime;
+
+    return;
+}
+
+void PerfNode::ReportShares(uint32_t nLevel)
+{
+    char        szIndent[MAX_BUF_SIZE / 2] = { 0 };
+    uint64_t    nMaxTime = 0;
+
+    // A call path run by one thread has nothing to compare
+    if(m_shares.size() < 2 || m_stats.nIntervalTime == 0) {
+        return;
+    }
+
+    for(uint32_t nIdx = 0; nIdx < nLevel && nIdx * 2 + 2 < sizeof(szIndent); nIdx++) {
+        strcat(szIndent, "--");
+    }
+    for(auto it = m_shares.begin(); it != m_shares.end(); it++) {
+        nMaxTime = std::max(nMaxTime, it->nTime);
+    }
+    // Busiest thread against an even split, 1.00 is perfectly balanced
+    const double nMean = (double)m_stats.nIntervalTime / (double)m_shares.size();
+    LOG(eWarning, "%s= %u threads, imbalance (max / mean) %0.2f\n",
+        szIndent, (uint32_t)m_shares.size(), (double)nMaxTime / nMean);
+    for(auto it = m_shares.begin(); it != m_shares.end(); it++) {
+        LOG(eWarning, "%s= %s count %llu, %0.3lf ms (%0.1f%%)\n",
+            szIndent, it->threadName.c_str(), (unsigned long long)it->nCount, (double)it->nTime / 1000.0,
+            (double)it->nTime * 100.0 / (double)m_stats.nIntervalTime);
+    }
+
+    return;
+}
+
+void PerfNode::ResetInterval(bool bChildren)
+{
+    // The process view gets the interval before it is gone
+    FoldInterval();
+
     m_stats.nIntervalTime       = 0;
     m_stats.nIntervalAvg        = 0;
     m_stats.nIntervalMax        = 0;
@@ -182,14 +542,48 @@ void PerfNode::ResetInterval()
     m_stats.nIntervalCount      = 0;
     m_stats.nIntervalUserCPU    = 0;
     m_stats.nIntervalSystemCPU  = 0;
+    memset(m_stats.nIntervalCounters, 0, sizeof(m_stats.nIntervalCounters));
+    m_stats.nIntervalAllocs     = 0;
+    m_stats.nIntervalAllocBytes = 0;
+    m_stats.nIntervalFrees      = 0;
+    m_stats.nIntervalFreeBytes  = 0;
+    m_slowest.clear();
+    m_shares.clear();
+
+    if(bChildren) {
+        auto it = m_childNodes.begin();
+        while(it != m_childNodes.end()) {
+            it->second->ResetInterval(true);
+            it++;
+        }
+    }
 
     return;
 }
 
+#ifdef PERF_HW_COUNTERS
+static void FormatCounters(char* ptr, size_t nSize, const uint64_t* pCounters)
+{
+    size_t nUsed = snprintf(ptr, nSize, " HW");
+    for(uint32_t nIdx = 0; nIdx < eHWCounterCount && nUsed < nSize; nIdx++) {
+        if(PerfHWCounters::IsAvailable(nIdx)) {
+            nUsed += snprintf(ptr + nUsed, nSize - nUsed, " %s %llu",
+                              PerfHWCounters::GetName(nIdx), (unsigned long long)pCounters[nIdx]);
+        }
+    }
+    if(PerfHWCounters::HasIPC() && pCounters[eHWCycles] != 0 && nUsed < nSize) {
+        snprintf(ptr + nUsed, nSize - nUsed, " IPC %0.2f",
+                 (double)pCounters[eHWInstructions] / (double)pCounters[eHWCycles]);
+    }
+}
+#endif
+
 void PerfNode::ReportData(uint32_t nLevel, bool bShowOnlyDelta, uint32_t msIntervalTime)
 {
     char buffer[MAX_BUF_SIZE] = { 0 };
     char* ptr = &buffer[0];
+    const char* szName = PerfSymbols::IsAddressName(m_stats.elementName) ?
+                         PerfSymbols::Resolve(m_stats.elementName) : m_stats.elementName.c_str();
     // Print the indent 
     for(uint32_t nIdx = 0; nIdx < nLevel; nIdx++) {
         snprintf(ptr, MAX_BUF_SIZE, "--");
@@ -200,12 +594,12 @@ void PerfNode::ReportData(uint32_t nLevel, bool bShowOnlyDelta, uint32_t msInter
         // Print only the current delta time data 
 #ifdef PERF_SHOW_CPU
         snprintf(ptr, MAX_BUF_SIZE - strlen(buffer), "| %s elapsed time %0.3lf ms CPU User %0.3lf ms, System %0.3lf ms\n",
-                m_stats.elementName.c_str(),
+                szName,
                 (double)m_stats.nLastDelta / 1000.0,
                 (double)m_stats.nUserCPU / 1000.0, (double)m_stats.nSystemCPU / 1000.0);
 #else
         snprintf(ptr, MAX_BUF_SIZE - strlen(buffer), "| %s elapsed time %0.3lf\n",
-                m_stats.elementName.c_str(),
+                szName,
                 (double)m_stats.nLastDelta / 1000.0);
 #endif
     }
@@ -216,19 +610,51 @@ void PerfNode::ReportData(uint32_t nLevel, bool bShowOnlyDelta, uint32_t msInter
         const float systemCPU = (msIntervalTime == 0)?0.0f:m_stats.nIntervalSystemCPU/ (msIntervalTime * 10.0f);
 
         snprintf(ptr, MAX_BUF_SIZE - strlen(buffer), "| %s (Count, Max ms, Min ms, Avg ms) Total %llu, %0.3lf, %0.3lf, %0.3lf Interval %llu, %0.3lf, %0.3lf, %0.3lf CPU User %u ms(%0.1f%%), System %u ms (%0.1f%%)",
-                m_stats.elementName.c_str(),
+                szName,
                 m_stats.nTotalCount, ((double)m_stats.nTotalMax) / 1000.0, ((double)m_stats.nTotalMin) / 1000.0, m_stats.nTotalAvg / 1000.0,
                 m_stats.nIntervalCount, ((double)m_stats.nIntervalMax) / 1000.0, ((double)m_stats.nIntervalMin) / 1000.0, m_stats.nIntervalAvg / 1000.0,
                 (uint32_t)(m_stats.nIntervalUserCPU / 1000), userCPU,
                 (uint32_t)(m_stats.nIntervalSystemCPU / 1000), systemCPU);
 #else
         snprintf(ptr, MAX_BUF_SIZE - strlen(buffer), "| %s (Count, Max, Min, Avg) Total %llu, %0.3lf, %0.3lf, %0.3lf Interval %llu, %0.3lf, %0.3lf, %0.3lf",
-                m_stats.elementName.c_str(),
+                szName,
                 m_stats.nTotalCount, ((double)m_stats.nTotalMax) / 1000.0, ((double)m_stats.nTotalMin) / 1000.0, m_stats.nTotalAvg / 1000.0,
                 m_stats.nIntervalCount, ((double)m_stats.nIntervalMax) / 1000.0, ((double)m_stats.nIntervalMin) / 1000.0, m_stats.nIntervalAvg / 1000.0);
 #endif
     }
+    if(!bShowOnlyDelta && m_stats.nTotalAllocs != 0) {
+        // Only present when the allocation interposer is active
+        const double nCalls = (m_stats.nIntervalCount == 0) ? 1.0 : (double)m_stats.nIntervalCount;
+        snprintf(buffer + strlen(buffer), MAX_BUF_SIZE - strlen(buffer),
+                 " Allocs (per call, bytes per call) Total %0.1f, %0.0f Interval %0.1f, %0.0f frees %llu, %llu bytes",
+                 (double)m_stats.nTotalAllocs / (double)m_stats.nTotalCount,
+                 (double)m_stats.nTotalAllocBytes / (double)m_stats.nTotalCount,
+                 (double)m_stats.nIntervalAllocs / nCalls,
+                 (double)m_stats.nIntervalAllocBytes / nCalls,
+                 (unsigned long long)m_stats.nIntervalFrees, (unsigned long long)m_stats.nIntervalFreeBytes);
+    }
+    if(!bShowOnlyDelta && m_nConfigGeneration != 0 && m_config.nSample > 1) {
+        snprintf(buffer + strlen(buffer), MAX_BUF_SIZE - strlen(buffer), " sampled 1 in %u", m_config.nSample);
+    }
+#ifdef PERF_HW_COUNTERS
+    size_t nLen = strlen(buffer);
+    if(nLen > 0 && buffer[nLen - 1] == '\n') {
+        buffer[nLen - 1] = '\0';
+    }
+    FormatCounters(buffer + strlen(buffer), MAX_BUF_SIZE - strlen(buffer),
+                   bShowOnlyDelta ? m_stats.nLastCounters : m_stats.nIntervalCounters);
+#endif
     LOG(eWarning, "%s\n", buffer);
+
+    if(!bShowOnlyDelta) {
+        auto itMetric = m_metrics.begin();
+        while(itMetric != m_metrics.end()) {
+            itMetric->second->ReportData(nLevel + 1, msIntervalTime);
+            itMetric++;
+        }
+        ReportSlowest(nLevel + 1);
+        ReportShares(nLevel + 1);
+    }
     
     // Print data for all the children
     auto it = m_childNodes.begin();
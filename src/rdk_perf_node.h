@@ -30,9 +30,18 @@
 #include <list>
 #include <map>
 #include <stack>
+#include <vector>
+
+#include "rdk_perf_metrics.h"
+#include "rdk_perf_hwcounters.h"
+#include "rdk_perf_config.h"
+#include "rdk_perf_window.h"
 
 #define INITIAL_MIN_VALUE 1000000000
 #define MAX_BUF_SIZE 2048
+#define SLOWEST_COUNT       5       // Slowest invocations kept per node and interval
+#define SLOWEST_CHILDREN    8       // Distinct children kept per invocation
+#define SLOWEST_FACTOR      2       // Reported when at least this many times the interval average
 
 typedef struct _TimingStats
 {
@@ -54,11 +63,49 @@ typedef struct _TimingStats
     uint64_t            nIntervalSystemCPU;
     uint64_t            nTotalUserCPU;
     uint64_t            nTotalSystemCPU;
+    uint64_t            nLastCounters[eHWCounterCount];
+    uint64_t            nIntervalCounters[eHWCounterCount];
+    uint64_t            nTotalCounters[eHWCounterCount];
+    uint64_t            nIntervalAllocs;
+    uint64_t            nIntervalAllocBytes;
+    uint64_t            nIntervalFrees;
+    uint64_t            nIntervalFreeBytes;
+    uint64_t            nTotalAllocs;
+    uint64_t            nTotalAllocBytes;
 } TimingStats;
 
 // Forward decls
 class PerfTree;
 class PerfRecord;
+class PerfNode;
+
+// Time spent in one child node during a single invocation of its parent
+typedef struct _ChildTime
+{
+    PerfNode*           pNode;
+    uint32_t            nCount;
+    uint64_t            nTime;
+} ChildTime;
+
+typedef struct _SlowInvocation
+{
+    uint64_t            nStartTime;     // Wall clock in us, to match against logs
+    uint64_t            nDuration;
+    pthread_t           tID;
+    uint32_t            nChildren;
+    uint64_t            nOtherChildTime;    // Children that did not fit
+    ChildTime           children[SLOWEST_CHILDREN];
+} SlowInvocation;
+
+// Interval time one thread spent in a node of the process view
+typedef struct _ThreadShare
+{
+    const PerfTree*     pTree;
+    std::string         threadName;
+    uint64_t            nCount;
+    uint64_t            nTime;
+} ThreadShare;
+
 class PerfNode
 {
 public:
@@ -72,17 +119,62 @@ public:
     static uint64_t TimeStamp();
 
     std::string& GetName() { return m_elementName; };
+    const std::map<std::string, PerfNode*>& GetChildren() { return m_childNodes; };
     TimingStats* GetStats() { return &m_stats; };
     void SetTree(PerfTree* pTree) { m_Tree = pTree; };
+    PerfTree* GetTree() { return m_Tree; };
     void SetThreshold(int32_t nThreshold) { m_ThresholdInUS = nThreshold; };
+    // Must be called with the lock held
+    const ScopeConfig* GetConfig()
+    {
+        if(m_nConfigGeneration != PerfConfig::Generation()) {
+            m_nConfigGeneration = PerfConfig::Generation();
+            PerfConfig::Resolve(m_elementName, &m_config);
+        }
+        return &m_config;
+    };
+    bool Sample()
+    {
+        const ScopeConfig* pConfig = GetConfig();
+        return pConfig->nSample == 1 || (pConfig->nSample != 0 && (m_nSampleCount++ % pConfig->nSample) == 0);
+    };
+    PerfMetric* GetMetric(const char* szName, MetricType type);
 
     void CloseNode();
     void IncrementData(uint64_t deltaTime, uint64_t userCPU, uint64_t systemCPU);
-    void ResetInterval();
+    void IncrementCounters(const HWCounterValues* pDelta);
+    void IncrementAllocs(uint64_t nAllocs, uint64_t nAllocBytes, uint64_t nFrees, uint64_t nFreeBytes);
+    bool IsSlowInvocation(uint64_t nDuration)
+    {
+        return m_slowest.size() < SLOWEST_COUNT || nDuration > m_slowest.front().nDuration;
+    };
+    void AddInvocation(const SlowInvocation& invocation);
+    void ResetInterval(bool bChildren = false);
+    // Adds the statistics of a node from another tree, used to fold the tree
+    // of an exited thread into the aggregate for its thread name
+    void MergeFrom(PerfNode* pOther);
+    void MergeChildren(PerfNode* pOther);
+    // Node of the process view this node adds its interval to, resolved
+    // through the parent the first time it is needed
+    PerfNode* GetMirror();
+    // Rolling windows are kept for scopes with a threshold, for names given
+    // to RDKPerfGetWindowStats() or "window" in the configuration, and for
+    // all scopes while the history is on
+    void KeepWindow();
+    // Rolling window of this node's calls, false when it keeps none
+    bool GetWindow(uint32_t nSeconds, WindowStats* pStats, bool bCurrent = false);
+    // Adds the windows of this node and its descendants named name
+    bool CollectWindows(const std::string& name, PerfWindow* pSum);
+    PerfWindow* GetRollingWindow() { return m_pWindow; };
 
     void ReportData(uint32_t nLevel, bool bShowOnlyDelta, uint32_t msIntervalTime);
 
 private:
+    void ReportSlowest(uint32_t nLevel);
+    void ReportShares(uint32_t nLevel);
+    void FoldInterval();
+    void AddInterval(const TimingStats& stats, PerfTree* pTree);
+
     pthread_t               m_idThread;
     std::string             m_elementName;
     TimingStats             m_stats;
@@ -90,6 +182,15 @@ private:
     PerfTree*               m_Tree;
     int32_t                 m_ThresholdInUS;
     std::map<std::string, PerfNode*>    m_childNodes;
+    PerfMetricMap           m_metrics;
+    std::vector<SlowInvocation> m_slowest;  // Min heap on nDuration, at most SLOWEST_COUNT
+    uint32_t                m_nConfigGeneration;    // 0 until resolved
+    ScopeConfig             m_config;
+    uint32_t                m_nSampleCount;
+    PerfNode*               m_pParent;      // NULL for the root node
+    PerfNode*               m_pMirror;      // NULL until the process view needs it
+    std::vector<ThreadShare> m_shares;      // Only in process view nodes
+    PerfWindow*             m_pWindow;      // NULL unless the node keeps windows
 };
 
 #endif // __RDK_PERF_NODE_H__
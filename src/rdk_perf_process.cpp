@@ -20,6 +20,9 @@
 #include <stdio.h>
 #include <string.h>
 #include <dlfcn.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
 
 #include "rdk_perf_node.h"
 #include "rdk_perf_tree.h"
@@ -27,11 +30,19 @@
 #include "rdk_perf_logging.h"
 #include "rdk_perf_scopedlock.h"
 #include "rdk_perf_clock.h"
+#include "rdk_perf_async.h"
+#include "rdk_perf_metrics.h"
+#include "rdk_perf_cadence.h"
+#include "rdk_perf_lock.h"
+#include "rdk_perf_config.h"
+#include "rdk_perf_system.h"
 
 static std::map<pid_t, PerfProcess*>* sp_ProcessMap;
+static bool                             s_bMapClosed = false;
+static RDKPerfStartHook                 s_pStartHook = NULL;
 
 PerfProcess::PerfProcess(pid_t pID)
-: m_idProcess(pID)
+: m_idProcess(pID), m_pViewRoot(new PerfNode()), m_pHistory(NULL)
 {
     LOG(eWarning, "Creating PerfProcess %p\n", this);
     memset(m_ProcessName, 0, PROCESS_NAMELEN);
@@ -41,6 +52,17 @@ PerfProcess::PerfProcess(pid_t pID)
                   m_ProcessName);
     return;
 }
+PerfProcess::PerfProcess(pid_t pID, const char* szName)
+: m_idProcess(pID), m_pViewRoot(new PerfNode()), m_pHistory(NULL)
+{
+    // Used when the process is not running on this system (i.e. event replay)
+    memset(m_ProcessName, 0, PROCESS_NAMELEN);
+    if(szName != NULL) {
+        strncpy(m_ProcessName, szName, PROCESS_NAMELEN - 1);
+    }
+    LOG(eWarning, "Creating PerfProcess %p named <%s>\n", this, m_ProcessName);
+    return;
+}
 PerfProcess::~PerfProcess()
 {
     LOG(eWarning, "Deleting PerfProcess %p\n", this);
@@ -49,12 +71,39 @@ PerfProcess::~PerfProcess()
         delete it->second;
         it++;
     }
+    auto itExited = m_mapExited.begin();
+    while(itExited != m_mapExited.end()) {
+        delete itExited->second;
+        itExited++;
+    }
+    // Trees point into the view, it goes last
+    delete m_pViewRoot;
+    delete m_pHistory;
     return;
 }
 bool PerfProcess::CloseInactiveThreads()
 {
     bool retVal = false;
 
+    // Exited threads whose last scope has been closed by now
+    auto itExiting = m_mapExiting.begin();
+    while(itExiting != m_mapExiting.end()) {
+        auto itTree = m_mapThreads.find(itExiting->first);
+        if(itTree == m_mapThreads.end()) {
+            itExiting = m_mapExiting.erase(itExiting);
+        }
+        else if(itTree->second->GetStack()->top() == itTree->second->GetRoot()) {
+            FoldExited(itTree->second, itExiting->second);
+            delete itTree->second;
+            m_mapThreads.erase(itTree);
+            itExiting = m_mapExiting.erase(itExiting);
+            retVal = true;
+        }
+        else {
+            itExiting++;
+        }
+    }
+
     auto it = m_mapThreads.begin();
     while(it != m_mapThreads.end()) {
         PerfTree* pTree = it->second;
@@ -74,6 +123,19 @@ bool PerfProcess::CloseInactiveThreads()
             it++;
         }
     }
+
+    // Thread names that saw no exits since the last report
+    auto itExited = m_mapExited.begin();
+    while(itExited != m_mapExited.end()) {
+        if(itExited->second->IsInactive()) {
+            delete itExited->second;
+            itExited = m_mapExited.erase(itExited);
+            retVal = true;
+        }
+        else {
+            itExited++;
+        }
+    }
     return retVal;
 }
 
@@ -82,16 +144,141 @@ bool PerfProcess::RemoveTree(pthread_t tID)
     bool retVal = false;
  
     // Remove tree from process list.
-    auto it = m_mapThreads.find(tID);
-    if(it != m_mapThreads.end()) {
-        // Remove from list
-        delete it->second;
-        it = m_mapThreads.erase(it);
-        retVal = true;
+    auto it = m_mapThreads.begin();
+    while(it != m_mapThreads.end()) {
+        if(it->second->GetThreadID() == tID) {
+            // Remove from list
+            m_mapExiting.erase(it->first);
+            delete it->second;
+            it = m_mapThreads.erase(it);
+            retVal = true;
+            break;
+        }
+        it++;
     }    
     return retVal;
 }
 
+PerfTree* PerfProcess::FindTree(pthread_t tID)
+{
+    // Only live threads have a tree, so a reused pthread_t is not ambiguous
+    auto it = m_mapThreads.begin();
+    while(it != m_mapThreads.end()) {
+        if(it->second->GetThreadID() == tID) {
+            return it->second;
+        }
+        it++;
+    }
+    return NULL;
+}
+
+void PerfProcess::ThreadExited(pthread_t tKey, const char* szThreadName)
+{
+    auto it = m_mapThreads.find(tKey);
+    if(it == m_mapThreads.end()) {
+        // Already closed with RDKPerf_CloseThread() or at report time
+        return;
+    }
+
+    PerfTree* pTree = it->second;
+    std::string name((szThreadName != NULL && szThreadName[0] != '\0') ? szThreadName : pTree->GetName());
+
+    if(pTree->GetStack()->top() != pTree->GetRoot()) {
+        // Records of the open scopes still point into the tree
+        LOG(eTrace, "Thread %ld named %s exited with open scopes\n", (long)tKey, name.c_str());
+        m_mapExiting[tKey] = name;
+        return;
+    }
+
+    FoldExited(pTree, name);
+    LOG(eTrace, "Thread %ld named %s exited\n", (long)tKey, name.c_str());
+    delete pTree;
+    m_mapThreads.erase(it);
+
+    return;
+}
+
+void PerfProcess::FoldExited(PerfTree* pTree, const std::string& name)
+{
+    PerfTree* pExited = NULL;
+    auto itExited = m_mapExited.find(name);
+    if(itExited == m_mapExited.end()) {
+        pExited = new PerfTree();
+        pExited->SetViewRoot(m_pViewRoot);
+        m_mapExited[name] = pExited;
+    }
+    else {
+        pExited = itExited->second;
+    }
+    pExited->MergeFrom(pTree);
+
+    return;
+}
+
+void PerfProcess::CloseSystemView()
+{
+    auto it = m_mapThreads.begin();
+    while(it != m_mapThreads.end()) {
+        it->second->ResetInterval();
+        it++;
+    }
+    auto itExited = m_mapExited.begin();
+    while(itExited != m_mapExited.end()) {
+        itExited->second->ResetInterval();
+        itExited++;
+    }
+    PerfSystemView::AddInterval(m_ProcessName, m_pViewRoot);
+    m_pViewRoot->ResetInterval(true);
+    PerfSystemView::ProcessExited(m_ProcessName, m_idProcess);
+
+    return;
+}
+
+bool PerfProcess::GetWindow(const std::string& name, uint32_t nSeconds, WindowStats* pStats)
+{
+    PerfWindow sum;
+    bool bFound = false;
+
+    auto it = m_mapThreads.begin();
+    while(it != m_mapThreads.end()) {
+        bFound = it->second->GetRoot()->CollectWindows(name, &sum) || bFound;
+        it++;
+    }
+    auto itExited = m_mapExited.begin();
+    while(itExited != m_mapExited.end()) {
+        bFound = itExited->second->GetRoot()->CollectWindows(name, &sum) || bFound;
+        itExited++;
+    }
+    sum.Get(nSeconds, PerfWindow::Now(), pStats);
+
+    return bFound;
+}
+
+void PerfProcess::Snapshot(time_t nNow, const HistoryConfig& config)
+{
+    std::vector<PerfNode*> roots;
+    HistoryInputs inputs;
+
+    auto it = m_mapThreads.begin();
+    while(it != m_mapThreads.end()) {
+        roots.push_back(it->second->GetRoot());
+        it++;
+    }
+    auto itExited = m_mapExited.begin();
+    while(itExited != m_mapExited.end()) {
+        roots.push_back(itExited->second->GetRoot());
+        itExited++;
+    }
+    PerfHistory::Collect(roots, config.nResolution, &inputs);
+
+    if(m_pHistory == NULL) {
+        m_pHistory = new PerfHistory();
+    }
+    m_pHistory->Snapshot(nNow, config, inputs);
+
+    return;
+}
+
 void PerfProcess::GetProcessName()
 {
     char cmd[80] = { 0 };
@@ -135,6 +322,7 @@ PerfTree* PerfProcess::NewTree(pthread_t tID)
     if(it == m_mapThreads.end()) {
         // Cound not find thread in list
         pTree = new PerfTree();
+        pTree->SetViewRoot(m_pViewRoot);
         m_mapThreads[tID] = pTree;
     }
     else {
@@ -174,6 +362,30 @@ void PerfProcess::ShowTree(PerfTree* pTree)
     return;
 }
 
+void PerfProcess::ReportTree(PerfTree* pTree, uint32_t msIntervalTime, std::map<std::string, PerfTree*>& groups)
+{
+    std::string group;
+    if(!pTree->GetGroup(&group)) {
+        pTree->ReportData(msIntervalTime);
+        return;
+    }
+
+    PerfTree*& pGroup = groups[group];
+    if(pGroup == NULL) {
+        pGroup = new PerfTree();
+    }
+    // Merged before the thread's own report clears its interval
+    pGroup->MergeFrom(pTree);
+    if(PerfConfig::ShowThreadDetail()) {
+        pTree->ReportData(msIntervalTime);
+    }
+    else {
+        pTree->ResetInterval();
+    }
+
+    return;
+}
+
 void PerfProcess::ReportData()
 {
     // Print reports for all the trees in this process.
@@ -182,12 +394,13 @@ void PerfProcess::ReportData()
                   sizeof(m_ProcessName) <= PROCESS_NAMELEN ? (int)sizeof(m_ProcessName) : (int)PROCESS_NAMELEN, 
                   m_ProcessName);
     auto it = m_mapThreads.begin();
+    std::map<std::string, PerfTree*> groups;
 
-    if(it != m_mapThreads.end()) {
-        PerfClock::Now(&m_clock, PerfClock::Elapsed);
-
-        const uint64_t msIntervalTime = m_clock.GetWallClock(PerfClock::millisecond);
+    // The interval is needed for rates even when no thread is left
+    PerfClock::Now(&m_clock, PerfClock::Elapsed);
+    const uint64_t msIntervalTime = m_clock.GetWallClock(PerfClock::millisecond);
 
+    if(it != m_mapThreads.end()) {
         const float userCPU = (m_clock.GetUserCPU(PerfClock::millisecond) * 100.0f) / (float)msIntervalTime;
         const float systemCPU = (m_clock.GetSystemCPU(PerfClock::millisecond) * 100.0f) / (float)msIntervalTime;
 
@@ -195,13 +408,62 @@ void PerfProcess::ReportData()
             m_clock.GetUserCPU(PerfClock::millisecond), userCPU,
             m_clock.GetSystemCPU(PerfClock::millisecond), systemCPU);
 
-        PerfClock::Now(&m_clock, PerfClock::Marker);
-
         while(it != m_mapThreads.end()) {
-            it->second->ReportData(msIntervalTime);
+            ReportTree(it->second, msIntervalTime, groups);
             it++;
         }
     } 
+    auto itExited = m_mapExited.begin();
+    while(itExited != m_mapExited.end()) {
+        ReportTree(itExited->second, msIntervalTime, groups);
+        itExited++;
+    }
+
+    // Thread groups are built for the report only
+    auto itGroup = groups.begin();
+    while(itGroup != groups.end()) {
+        itGroup->second->SetGroupName(itGroup->first);
+        itGroup->second->ReportData(msIntervalTime);
+        delete itGroup->second;
+        itGroup++;
+    }
+
+    // Every tree above added its interval to the view when it was cleared
+    PerfSystemView::AddInterval(m_ProcessName, m_pViewRoot);
+    if(PerfConfig::ShowProcessView()) {
+        LOG(eWarning, "Printing process view of all threads, Interval Elapsed wallClock: %lu ms\n", msIntervalTime);
+        m_pViewRoot->ReportData(0, false, msIntervalTime);
+    }
+    else if(PerfSystemView::IsEnabled()) {
+        m_pViewRoot->ResetInterval(true);
+    }
+
+    if(m_pHistory != NULL) {
+        HistoryConfig history;
+        PerfConfig::GetHistory(&history);
+        if(history.nResolution != 0) {
+            m_pHistory->ReportTrends();
+        }
+        else {
+            // Turned off in the configuration
+            delete m_pHistory;
+            m_pHistory = NULL;
+        }
+    }
+
+    // Metrics, cadences and locks that are not attached to a scope belong to this process
+    if(m_idProcess == getpid()) {
+        PerfMetric::ReportGlobals(msIntervalTime);
+        PerfCadence::ReportAll();
+        PerfLock::ReportAll();
+    }
+    PerfClock::Now(&m_clock, PerfClock::Marker);
+
+    // Spans that begin and end on different threads are kept outside the trees
+    PerfAsyncSpans* pSpans = PerfAsyncSpans::GetSpans(m_idProcess, false);
+    if(pSpans != NULL) {
+        pSpans->ReportData();
+    }
     
     return;
 }
@@ -214,6 +476,10 @@ PerfProcess* RDKPerf_FindProcess(pid_t pID)
 
     SCOPED_LOCK();
 
+    if(sp_ProcessMap == NULL) {
+        // Created with the first process
+        return NULL;
+    }
     auto it = sp_ProcessMap->find(pID);
     if(it != sp_ProcessMap->end()) {
         retVal = it->second;
@@ -225,24 +491,38 @@ void RDKPerf_InsertProcess(pid_t pID, PerfProcess* pProcess)
 {
     SCOPED_LOCK();
 
+    if(sp_ProcessMap == NULL) {
+        RDKPerf_InitializeMap();
+    }
     sp_ProcessMap->insert(std::pair<pid_t, PerfProcess*>(pID, pProcess));
+    PerfSystemView::ProcessStarted(pProcess->GetName(), pID);
     LOG(eError, "Process Map %p size %d added entry for PID %X, pProcess %p\n", sp_ProcessMap, sp_ProcessMap->size(), pID, pProcess);
+
+    if(pID == getpid() && s_pStartHook != NULL) {
+        s_pStartHook();
+    }
 }
 
 void RDKPerf_RemoveProcess(pid_t pID)
 {
     SCOPED_LOCK();
 
-    // Find thread in process map
-    auto it = sp_ProcessMap->find(pID);
-    if(it == sp_ProcessMap->end()) {
-        LOG(eError, "Could not find Process ID %X for reporting\n", (uint32_t)pID);
-    }
-    else {
-        LOG(eError, "Process Map size %d found entry for PID %X\n", sp_ProcessMap->size(), it->first);
-        delete it->second;
-        sp_ProcessMap->erase(it);
+    // Find thread in process map, there is none when nothing was recorded
+    if(sp_ProcessMap != NULL) {
+        auto it = sp_ProcessMap->find(pID);
+        if(it == sp_ProcessMap->end()) {
+            LOG(eError, "Could not find Process ID %X for reporting\n", (uint32_t)pID);
+        }
+        else {
+            LOG(eError, "Process Map size %d found entry for PID %X\n", sp_ProcessMap->size(), it->first);
+            if(PerfSystemView::IsEnabled()) {
+                it->second->CloseSystemView();
+            }
+            delete it->second;
+            sp_ProcessMap->erase(it);
+        }
     }
+    PerfAsyncSpans::RemoveSpans(pID);
 }
 
 void RDKPerf_InitializeMap()
@@ -261,12 +541,114 @@ void RDKPerf_DeleteMap()
     if(sp_ProcessMap != NULL) {
         delete sp_ProcessMap;
         sp_ProcessMap = NULL;
+        s_bMapClosed = true;
     }
     else {
         LOG(eError, "Can not delete map\n");
     }
 }
 
+bool RDKPerf_MapExists()
+{
+    return sp_ProcessMap != NULL;
+}
+
+// True once the map has been deleted at unload, scopes are no longer recorded
+bool RDKPerf_MapClosed()
+{
+    return s_bMapClosed;
+}
+
+void RDKPerf_SetStartHook(RDKPerfStartHook pHook)
+{
+    SCOPED_LOCK();
+    s_pStartHook = pHook;
+}
+
+//--------------------- Thread Tools ----------------------
+static thread_local pid_t t_idThread = 0;
+
+// The forking thread keeps its thread locals in the child
+static void ResetThreadID()
+{
+    t_idThread = 0;
+}
+
+static void RegisterForkHandler()
+{
+    pthread_atfork(NULL, NULL, ResetThreadID);
+}
+
+pid_t RDKPerf_GetThreadID()
+{
+    static pthread_once_t s_once = PTHREAD_ONCE_INIT;
+
+    if(t_idThread == 0) {
+        pthread_once(&s_once, RegisterForkHandler);
+        t_idThread = (pid_t)syscall(SYS_gettid);
+    }
+    return t_idThread;
+}
+
+class ThreadExitHook
+{
+public:
+    ThreadExitHook() : m_pID(0) {};
+    ~ThreadExitHook()
+    {
+        if(m_pID == 0 || m_pID != getpid() || RDKPerf_MapClosed()) {
+            return;
+        }
+
+        // Still running on the exiting thread, its final name is available
+        char szName[THREAD_NAMELEN] = { 0 };
+        prctl(PR_GET_NAME, szName, 0, 0, 0);
+
+        SCOPED_LOCK();
+        PerfProcess* pProcess = RDKPerf_FindProcess(m_pID);
+        if(pProcess != NULL) {
+            pProcess->ThreadExited((pthread_t)RDKPerf_GetThreadID(), szName);
+        }
+    };
+
+    void Arm() { m_pID = getpid(); };
+
+private:
+    pid_t   m_pID;
+};
+
+void RDKPerf_WatchThreadExit()
+{
+    // Destroyed when the thread exits, including the main thread on exit()
+    static thread_local ThreadExitHook t_hook;
+    t_hook.Arm();
+}
+
+void RDKPerf_SnapshotProcess(pid_t pID, time_t nNow, const HistoryConfig& config)
+{
+    SCOPED_LOCK();
+
+    PerfProcess* pProcess = RDKPerf_FindProcess(pID);
+    if(pProcess != NULL) {
+        pProcess->Snapshot(nNow, config);
+    }
+}
+
+std::vector<pid_t> RDKPerf_GetProcessIDs()
+{
+    std::vector<pid_t> processIDs;
+
+    SCOPED_LOCK();
+    if(sp_ProcessMap != NULL) {
+        auto it = sp_ProcessMap->begin();
+        while(it != sp_ProcessMap->end()) {
+            processIDs.push_back(it->first);
+            it++;
+        }
+    }
+    return processIDs;
+}
+
 size_t RDKPerf_GetMapSize()
 {
     if(sp_ProcessMap != NULL) {
@@ -30,17 +30,22 @@
 #include <list>
 #include <map>
 #include <stack>
+#include <vector>
 #include "rdk_perf_clock.h"
+#include "rdk_perf_window.h"
+#include "rdk_perf_history.h"
 
 #define PROCESS_NAMELEN 80
 
 // Forward decls
 class PerfTree;
+class PerfNode;
 
 class PerfProcess
 {
 public:
     PerfProcess(pid_t pID);
+    PerfProcess(pid_t pID, const char* szName);
     ~PerfProcess();
 
     PerfTree* GetTree(pthread_t tID);
@@ -49,13 +54,35 @@ public:
     void ShowTree(PerfTree* pTree);
     void ReportData();
     void GetProcessName();
+    char* GetName() { return m_ProcessName; };
     bool CloseInactiveThreads();
     bool RemoveTree(pthread_t tID);
+    PerfTree* FindTree(pthread_t tID);
+    void ThreadExited(pthread_t tKey, const char* szThreadName);
+    // Hands the remaining intervals to the system view before the process goes
+    void CloseSystemView();
+    // Rolling window of every scope named name, in all threads including the
+    // exited ones.  False when no such scope ran.
+    bool GetWindow(const std::string& name, uint32_t nSeconds, WindowStats* pStats);
+    // Adds a snapshot of every scope to the interval history
+    void Snapshot(time_t nNow, const HistoryConfig& config);
+    PerfHistory* GetHistory() { return m_pHistory; };
 
 private:
+    void ReportTree(PerfTree* pTree, uint32_t msIntervalTime, std::map<std::string, PerfTree*>& groups);
+    void FoldExited(PerfTree* pTree, const std::string& name);
+
     pid_t                           m_idProcess;
     char                            m_ProcessName[PROCESS_NAMELEN];
+    // Keyed by kernel thread ID for the threads of this process, by the
+    // reported pthread_t for remote and replayed processes
     std::map<pthread_t, PerfTree*>  m_mapThreads;
+    std::map<std::string, PerfTree*> m_mapExited;  // Exited threads folded by thread name
+    // Threads that exited with scopes still open, e.g. to be stopped on
+    // another thread.  Folded at report time once those scopes closed.
+    std::map<pthread_t, std::string> m_mapExiting;
+    PerfNode*                       m_pViewRoot;    // All threads merged by call path
+    PerfHistory*                    m_pHistory;     // NULL until the first snapshot
     PerfClock                       m_clock;
 };
 
@@ -64,7 +91,23 @@ void RDKPerf_InsertProcess(pid_t pID, PerfProcess* pProcess);
 void RDKPerf_RemoveProcess(pid_t pID);
 void RDKPerf_InitializeMap();
 void RDKPerf_DeleteMap();
+bool RDKPerf_MapExists();
 size_t RDKPerf_GetMapSize();
+std::vector<pid_t> RDKPerf_GetProcessIDs();
+bool RDKPerf_MapClosed();
+void RDKPerf_SnapshotProcess(pid_t pID, time_t nNow, const HistoryConfig& config);
+
+// Called once per process, when its first scope is opened.  librdkperf
+// uses it to start its report thread only in processes that record.
+typedef void (*RDKPerfStartHook)();
+void RDKPerf_SetStartHook(RDKPerfStartHook pHook);
+
+// Kernel thread ID of the calling thread, the key of its tree.  Unlike a
+// pthread_t it is not reused while the thread's tree still exists.
+pid_t RDKPerf_GetThreadID();
+// Folds the calling thread's tree into the aggregate for its thread name
+// and frees it when the thread exits
+void RDKPerf_WatchThreadExit();
 
 
 #endif // __RDK_PERF_PROCESS_H__
@@ -30,19 +30,94 @@
 #include "rdk_perf_process.h"
 #include "rdk_perf_logging.h"
 #include "rdk_perf_scopedlock.h"
+#include "rdk_perf_eventlog.h"
+#include "rdk_perf_ftrace.h"
+#include "rdk_perf_flightrec.h"
+#include "rdk_perf_breach.h"
+#include "rdk_perf_watchdog.h"
+#include "rdk_perf_control.h"
 
 #ifndef PERF_SHOW_CPU
 #pragma message "Using TimeStamp instead of PerfClock"
 #define USE_TIMESTAMP
 #endif
 
+thread_local PerfRecordChain* PerfRecord::s_pChain = NULL;
+thread_local bool        PerfRecord::s_bInternal = false;
+thread_local PerfAllocCounts PerfRecord::s_allocs = { 0, 0, 0, 0 };
+
+// Must be called with the lock held
+static void ReleaseChain(PerfRecordChain* pChain)
+{
+    if(--pChain->nRefs == 0) {
+        delete pChain;
+    }
+}
+
+// Drops the thread's reference to its chain when the thread exits
+class PerfChainOwner
+{
+public:
+    PerfChainOwner(PerfRecordChain** ppChain) : m_ppChain(ppChain) {};
+    ~PerfChainOwner()
+    {
+        SCOPED_LOCK();
+        PerfRecordChain* pChain = *m_ppChain;
+        *m_ppChain = NULL;
+        if(pChain != NULL) {
+            ReleaseChain(pChain);
+        }
+    };
+
+private:
+    PerfRecordChain**   m_ppChain;
+};
+
 PerfRecord::PerfRecord(std::string elementName)
-: m_elementName(elementName), m_nodeInTree(NULL), m_ThresholdInUS(-1)
+: m_bActive(PerfControl::IsEnabled(elementName.c_str())), m_bSampled(true), m_bConfigThreshold(false)
+, m_elementName(std::move(elementName)), m_nodeInTree(NULL), m_ThresholdInUS(-1), m_pParent(NULL), m_pChain(NULL)
+, m_nAllocs(0), m_nAllocBytes(0), m_nFrees(0), m_nFreeBytes(0)
+, m_nChildren(0), m_nOtherChildTime(0)
+{
+    if(m_bActive) {
+        Open();
+    }
+}
+
+PerfRecord::PerfRecord(const char* szName)
+: m_bActive(PerfControl::IsEnabled(szName)), m_bSampled(true), m_bConfigThreshold(false)
+, m_nodeInTree(NULL), m_ThresholdInUS(-1), m_pParent(NULL), m_pChain(NULL)
+, m_nAllocs(0), m_nAllocBytes(0), m_nFrees(0), m_nFreeBytes(0)
+, m_nChildren(0), m_nOtherChildTime(0)
+{
+    // A disabled scope does not even build its name
+    if(m_bActive) {
+        m_elementName = szName;
+        Open();
+    }
+}
+
+void PerfRecord::Open()
 {
+    m_schedStart.bValid = false;
+
+    if(RDKPerf_MapClosed()) {
+        // Library is being unloaded
+        m_bActive = false;
+        return;
+    }
+
+    if(PerfFTrace::IsEnabled()) {
+        s_bInternal = true;
+        PerfFTrace::Begin(m_elementName.c_str());
+        s_bInternal = false;
+    }
+
     pid_t           pID = getpid();
     PerfProcess*    pProcess = NULL;
 
     SCOPED_LOCK();
+    s_bInternal = true;
 
     // LOG(eWarning, "Creating node for element %s pid %X\n", m_elementName.c_str(), pID);
     
@@ -50,6 +125,7 @@ PerfRecord::PerfRecord(std::string elementName)
     pProcess = RDKPerf_FindProcess(pID);
     if(pProcess == NULL) {
         // no existing PID in map
+        PerfControl::Attach();
         pProcess = new PerfProcess(pID);
         RDKPerf_InsertProcess(pID, pProcess);
         LOG(eWarning, "Creating new process element %X for elemant %s\n", pProcess, m_elementName.c_str());
@@ -63,49 +139,282 @@ PerfRecord::PerfRecord(std::string elementName)
     // LOG(eWarning, "TimeStamp = %0.3lf\n", ((double)m_startTime) / 1000.0)
 #endif
     m_idThread = pthread_self();
+    PerfFlightRecorder::ForThread()->Record(eFlightBegin, m_elementName.c_str(), m_startTime, 0);
+    m_pWatchStack = PerfWatchdog::ForThread();
+    m_nWatchDepth = m_pWatchStack->Push(m_elementName.c_str(), m_startTime);
+    m_nWatchID    = m_pWatchStack->GetID(m_nWatchDepth);
 
     // Found PID get element tree for current thread.
-    PerfTree* pTree = pProcess->GetTree(m_idThread);
+    pthread_t tKey = (pthread_t)RDKPerf_GetThreadID();
+    PerfTree* pTree = pProcess->GetTree(tKey);
     if(pTree == NULL) {
-        pTree = pProcess->NewTree(m_idThread);
+        pTree = pProcess->NewTree(tKey);
+        RDKPerf_WatchThreadExit();
     }
     
     if(pTree) {
         pTree->AddNode(this);
     }
 
+    // The record may be closed on another thread (RDKPerfStop), it unlinks
+    // itself from the chain of the thread that opened it
+    if(s_pChain == NULL) {
+        static thread_local PerfChainOwner t_owner(&s_pChain);
+        s_pChain = new PerfRecordChain;
+        s_pChain->pCurrent.store(NULL, std::memory_order_relaxed);
+        s_pChain->nRefs = 1;
+    }
+    m_pChain = s_pChain;
+    m_pChain->nRefs++;
+    m_pParent = m_pChain->pCurrent.load(std::memory_order_relaxed);
+    // Counted so far for the enclosing record
+    FlushAllocs(m_pParent);
+    m_pChain->pCurrent.store(this, std::memory_order_release);
+
+    PerfEventLog* pLog = PerfEventLog::GetRecorder();
+    if(pLog != NULL) {
+        pLog->RecordEntry(pID, m_idThread, NULL, m_elementName.c_str(), m_startTime, m_ThresholdInUS);
+    }
+
+    if(m_nodeInTree != NULL) {
+        // Settings from the configuration file, resolved once per node
+        m_bSampled = m_nodeInTree->Sample();
+        int32_t nThresholdUS = m_nodeInTree->GetConfig()->nThresholdUS;
+        if(nThresholdUS >= 0) {
+            SetThreshold(nThresholdUS);
+            m_bConfigThreshold = true;
+        }
+    }
+
+    s_bInternal = false;
+
+#ifdef PERF_HW_COUNTERS
+    // Read last so that the bookkeeping above is not counted
+    PerfHWCounters::ForThread()->Read(&m_hwStart);
+#endif
+
     return;
 }
 
 PerfRecord::~PerfRecord()
 {
+    if(!m_bActive) {
+        return;
+    }
+
+    // The watchdog stack, the flight ring and the counters are the ones of
+    // the thread that opened the scope
+    bool bOwner = pthread_equal(m_idThread, pthread_self()) != 0;
+
+#ifdef PERF_HW_COUNTERS
+    // Read before taking the lock, waiting for it is not the scope's cost.
+    // Another thread's counters have nothing to do with m_hwStart.
+    HWCounterValues hwDelta;
+    if(bOwner) {
+        PerfHWCounters::ForThread()->Read(&hwDelta);
+        for(uint32_t nIdx = 0; nIdx < eHWCounterCount; nIdx++) {
+            hwDelta.value[nIdx] -= m_hwStart.value[nIdx];
+        }
+    }
+#endif
+
+    if(PerfFTrace::IsEnabled()) {
+        s_bInternal = true;
+        PerfFTrace::End();
+        s_bInternal = false;
+    }
+
     SCOPED_LOCK();
     uint64_t deltaTime = 0;
+    // The node may allocate its window, that is not the scope's allocation
+    s_bInternal = true;
+    if(m_bSampled && m_ThresholdInUS > 0) {
+        // A threshold report shows the last BREACH_WINDOW_MS of the scope
+        m_nodeInTree->KeepWindow();
+    }
 
 #ifdef USE_TIMESTAMP
     deltaTime = PerfRecord::TimeStamp() - m_startTime;
-    m_nodeInTree->IncrementData(deltaTime, 0, 0);
+    if(m_bSampled) m_nodeInTree->IncrementData(deltaTime, 0, 0);
 #else
     PerfClock::Now(&m_clock, PerfClock::Elapsed);
     deltaTime = m_clock.GetWallClock();
-    m_nodeInTree->IncrementData(deltaTime, m_clock.GetUserCPU(), m_clock.GetSystemCPU());
+    if(m_bSampled) m_nodeInTree->IncrementData(deltaTime, m_clock.GetUserCPU(), m_clock.GetSystemCPU());
+#endif
+
+#ifdef PERF_HW_COUNTERS
+    if(m_bSampled && bOwner) m_nodeInTree->IncrementCounters(&hwDelta);
 #endif
 
+    if(bOwner) {
+        // Counted since the last record opened, for the innermost one, which
+        // is not this one when closed out of order
+        FlushAllocs(m_pChain->pCurrent.load(std::memory_order_relaxed));
+    }
+    if(m_bSampled) m_nodeInTree->IncrementAllocs(m_nAllocs, m_nAllocBytes, m_nFrees, m_nFreeBytes);
+
+    if(bOwner) {
+        PerfFlightRecorder::ForThread()->Record(eFlightEnd, m_elementName.c_str(), m_startTime + deltaTime, deltaTime);
+        PerfWatchdog::ForThread()->Pop(m_nWatchDepth);
+    }
+    else if(m_nWatchID != 0) {
+        PerfWatchdog::CloseScope(m_pWatchStack, m_idThread, m_nWatchID);
+    }
+
+    if(m_bSampled && m_nodeInTree->IsSlowInvocation(deltaTime)) {
+        SlowInvocation invocation;
+        invocation.nStartTime       = m_startTime;
+        invocation.nDuration        = deltaTime;
+        invocation.tID              = m_idThread;
+        invocation.nChildren        = m_nChildren;
+        invocation.nOtherChildTime  = m_nOtherChildTime;
+        memcpy(invocation.children, m_children, m_nChildren * sizeof(ChildTime));
+        m_nodeInTree->AddInvocation(invocation);
+    }
+    if(m_bSampled && m_pParent != NULL) {
+        m_pParent->NoteChild(m_nodeInTree, deltaTime);
+    }
+
     m_nodeInTree->CloseNode();
-    if(m_ThresholdInUS > 0 && deltaTime > (uint64_t)m_ThresholdInUS) {
-        TimingStats* stats = m_nodeInTree->GetStats();
-        LOG(eWarning, "%s Threshold %ld exceeded, elapsed time = %0.3lf ms Avg time = %0.3lf (interval %0.3lf) ms\n", 
-                        GetName().c_str(), 
-                        m_ThresholdInUS / 1000,
-                        ((double)deltaTime) / 1000.0,
-                        ((double)stats->nTotalTime / (double)stats->nTotalCount) / 1000.0,
-                        ((double)stats->nIntervalTime / (double)stats->nIntervalCount) / 1000.0);
-        m_nodeInTree->ReportData(0, true, 0);
+
+    PerfRecord* pRecord = m_pChain->pCurrent.load(std::memory_order_relaxed);
+    if(pRecord == this) {
+        m_pChain->pCurrent.store(m_pParent, std::memory_order_release);
+    }
+    else {
+        // Closed out of order, unlink this record from the chain of open records
+        while(pRecord != NULL && pRecord->m_pParent != this) {
+            pRecord = pRecord->m_pParent;
+        }
+        if(pRecord != NULL) {
+            pRecord->m_pParent = m_pParent;
+        }
     }
+    ReleaseChain(m_pChain);
+
+    PerfEventLog* pLog = PerfEventLog::GetRecorder();
+    if(pLog != NULL) {
+        pLog->RecordExit(getpid(), m_idThread, m_elementName.c_str(), deltaTime);
+    }
+
+    if(m_bSampled && m_ThresholdInUS > 0 && deltaTime > (uint64_t)m_ThresholdInUS) {
+        if(bOwner) {
+            PerfFlightRecorder::ForThread()->Record(eFlightBreach, m_elementName.c_str(), m_startTime + deltaTime, deltaTime);
+            if(PerfFlightRecorder::IsEnabled()) {
+                PerfFlightRecorder::Trigger(m_elementName.c_str(), m_ThresholdInUS, deltaTime);
+            }
+        }
+
+        // Logged by the report thread, repeated breaches are only counted
+        if(PerfBreachQueue::Count(m_elementName, deltaTime)) {
+            PerfBreach*  pBreach = new PerfBreach;
+            TimingStats* stats   = m_nodeInTree->GetStats();
+            pBreach->name               = m_elementName;
+            pBreach->tID                = m_idThread;
+            pBreach->nThresholdUS       = m_ThresholdInUS;
+            pBreach->nElapsedUS         = deltaTime;
+            pBreach->nTotalAvg          = (double)stats->nTotalTime / (double)stats->nTotalCount;
+            WindowStats window;
+            m_nodeInTree->GetWindow(BREACH_WINDOW_MS / 1000, &window, true);
+            pBreach->nWindowAvg         = window.nAvg;
+            pBreach->nWindowCount       = window.nCount;
+            pBreach->nOtherChildTime    = m_nOtherChildTime;
+            for(uint32_t nIdx = 0; nIdx < m_nChildren; nIdx++) {
+                BreachChild child = { m_children[nIdx].pNode->GetName(), m_children[nIdx].nCount, m_children[nIdx].nTime };
+                pBreach->children.push_back(child);
+            }
+            pBreach->schedStart         = m_schedStart;
+            pBreach->schedEnd.bValid    = false;
+#ifdef PERF_SCHED_STATS
+            PerfSched::Snapshot(&pBreach->schedEnd);
+#endif
+            PerfBreachQueue::Post(pBreach);
+        }
+    }
+
+    s_bInternal = false;
 
     return;
 }
 
+void PerfRecord::SetThreshold(int32_t nUS)
+{
+    if(!m_bActive || m_bConfigThreshold) {
+        // The configuration file overrides the call site
+        return;
+    }
+    m_ThresholdInUS = (int32_t)nUS;
+    if(pthread_equal(m_idThread, pthread_self())) {
+        PerfWatchdog::ForThread()->SetThreshold(m_nWatchDepth, m_ThresholdInUS);
+        if(m_ThresholdInUS > 0) {
+            PerfWatchdog::Start();
+        }
+    }
+
+#ifdef PERF_SCHED_STATS
+    // Only scopes that can exceed a threshold pay for the snapshot
+    if(m_ThresholdInUS > 0) {
+        PerfSched::Snapshot(&m_schedStart);
+    }
+#endif
+
+    PerfEventLog* pLog = PerfEventLog::GetRecorder();
+    if(pLog != NULL) {
+        pLog->RecordThreshold(getpid(), m_idThread, m_elementName.c_str(), m_ThresholdInUS);
+    }
+}
+
+// Adds a closed leaf node under the innermost open record of the calling thread
+void PerfRecord::RecordLeaf(const char* szName, uint64_t nStartTime, uint64_t nElapsedTime)
+{
+    SCOPED_LOCK();
+
+    PerfRecord* pCurrent = Current();
+    if(pCurrent == NULL || pCurrent->m_nodeInTree == NULL) {
+        return;
+    }
+
+    PerfTree* pTree = pCurrent->m_nodeInTree->GetTree();
+    if(pTree != NULL) {
+        PerfNode* pLeaf = pTree->AddLeaf((char*)szName, pCurrent->m_idThread, nStartTime, nElapsedTime);
+        if(pLeaf != NULL) {
+            pCurrent->NoteChild(pLeaf, nElapsedTime);
+        }
+    }
+}
+
+// Must be called with the lock held, on the thread that counted
+void PerfRecord::FlushAllocs(PerfRecord* pRecord)
+{
+    if(pRecord != NULL) {
+        pRecord->m_nAllocs      += s_allocs.nAllocs;
+        pRecord->m_nAllocBytes  += s_allocs.nAllocBytes;
+        pRecord->m_nFrees       += s_allocs.nFrees;
+        pRecord->m_nFreeBytes   += s_allocs.nFreeBytes;
+    }
+    memset(&s_allocs, 0, sizeof(s_allocs));
+}
+
+// Called under the lock when a child of this record closes
+void PerfRecord::NoteChild(PerfNode* pNode, uint64_t nTime)
+{
+    for(uint32_t nIdx = 0; nIdx < m_nChildren; nIdx++) {
+        if(m_children[nIdx].pNode == pNode) {
+            m_children[nIdx].nCount++;
+            m_children[nIdx].nTime += nTime;
+            return;
+        }
+    }
+    if(m_nChildren < SLOWEST_CHILDREN) {
+        m_children[m_nChildren].pNode  = pNode;
+        m_children[m_nChildren].nCount = 1;
+        m_children[m_nChildren].nTime  = nTime;
+        m_nChildren++;
+    }
+    else {
+        m_nOtherChildTime += nTime;
+    }
+}
 
 uint64_t PerfRecord::TimeStamp() 
 {
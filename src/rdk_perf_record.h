@@ -30,8 +30,13 @@
 #include <list>
 #include <map>
 #include <stack>
+#include <atomic>
 
 #include "rdk_perf_clock.h"
+#include "rdk_perf_hwcounters.h"
+#include "rdk_perf_sched.h"
+#include "rdk_perf_node.h"
+#include "rdk_perf_scopedlock.h"
 
 #define MAX_BUF_SIZE 2048
 
@@ -39,30 +44,108 @@
 // Forward decls
 class PerfTree;
 class PerfNode;
+class PerfThreadStack;
+class PerfRecord;
+
+// Open records of one thread.  Kept alive by the thread and by each record
+// opened on it, so a record stopped on another thread, even after the
+// opener exited, unlinks itself without touching that thread's TLS.  Only
+// changed under the lock, the owner reads the innermost record without it.
+typedef struct _PerfRecordChain
+{
+    std::atomic<PerfRecord*>    pCurrent;
+    uint32_t                    nRefs;
+} PerfRecordChain;
+
+// Heap accounting of one thread since the innermost open record last changed
+typedef struct _PerfAllocCounts
+{
+    uint64_t    nAllocs;
+    uint64_t    nAllocBytes;
+    uint64_t    nFrees;
+    uint64_t    nFreeBytes;
+} PerfAllocCounts;
 
 class PerfRecord
 {
 public:
     PerfRecord(std::string elementName);
+    PerfRecord(const char* szName);     // Checks PerfControl before copying the name
     ~PerfRecord();
     
     static uint64_t TimeStamp();
+    // Innermost open record of the calling thread.  Only a NULL check is safe
+    // without the lock, another thread may stop and delete the record.
+    static inline PerfRecord* Current()
+    {
+        PerfRecordChain* pChain = s_pChain;
+        return (pChain != NULL) ? pChain->pCurrent.load(std::memory_order_acquire) : NULL;
+    };
+    // True while the calling thread runs library code: waiting for or
+    // holding the lock, or writing ftrace markers
+    static inline bool IsInternal() { return s_bInternal || RDKPERF::InLibraryLock(); }
+    static void RecordLeaf(const char* szName, uint64_t nStartTime, uint64_t nElapsedTime);
+
+    // Heap accounting of the calling thread.  Counted in TLS, the record may
+    // be stopped on another thread, and moved to the innermost open record
+    // by the owning thread whenever a record opens or closes on it.
+    static inline void NoteAlloc(size_t nBytes)
+    {
+        if(Current() != NULL && !IsInternal()) {
+            s_allocs.nAllocs++;
+            s_allocs.nAllocBytes += nBytes;
+        }
+    }
+    static inline void NoteFree(size_t nBytes)
+    {
+        if(Current() != NULL && !IsInternal()) {
+            s_allocs.nFrees++;
+            s_allocs.nFreeBytes += nBytes;
+        }
+    }
 
     std::string&    GetName()                       { return m_elementName; };
     pthread_t       GetThreadID()                   { return m_idThread; };
     uint64_t        GetStartTime()                  { return m_startTime; };
-    void            SetThreshold(int32_t nUS)       { m_ThresholdInUS = (int32_t)nUS; };
+    void            SetThreshold(int32_t nUS);
     void            SetNodeInTree(PerfNode* pNode)  { m_nodeInTree = pNode; };
+    PerfNode*       GetNodeInTree()                 { return m_nodeInTree; };
+    PerfRecord*     GetParent()                     { return m_pParent; };
+    void            NoteChild(PerfNode* pNode, uint64_t nTime);
  
     void            ReportData(uint32_t nLevel, bool bShowOnlyDelta, uint32_t msIntervalTime = 0);
 
 private:
+    void            Open();
+    static void     FlushAllocs(PerfRecord* pRecord);
+
+    bool                    m_bActive;      // False when disabled through PerfControl
+    bool                    m_bSampled;     // False when the configuration skips this call
+    bool                    m_bConfigThreshold; // Threshold set by the configuration file
     pthread_t               m_idThread;
     std::string             m_elementName;
     uint64_t                m_startTime;
     PerfNode*               m_nodeInTree;
     int32_t                 m_ThresholdInUS;
     PerfClock               m_clock;
+    PerfRecord*             m_pParent;      // Enclosing open record on this thread
+    PerfRecordChain*        m_pChain;       // Chain of the thread that opened the record
+    HWCounterValues         m_hwStart;      // Only read with PERF_HW_COUNTERS
+    SchedSnapshot           m_schedStart;   // Only taken with PERF_SCHED_STATS and a threshold
+    uint64_t                m_nAllocs;
+    uint64_t                m_nAllocBytes;
+    uint64_t                m_nFrees;
+    uint64_t                m_nFreeBytes;
+    uint32_t                m_nChildren;    // Children closed during this invocation
+    uint64_t                m_nOtherChildTime;
+    ChildTime               m_children[SLOWEST_CHILDREN];
+    PerfThreadStack*        m_pWatchStack;  // Watchdog's copy of the open scopes of the opening thread
+    uint32_t                m_nWatchDepth;  // Position in that copy
+    uint64_t                m_nWatchID;
+
+    static thread_local PerfRecordChain* s_pChain;  // NULL until the first record, and after exit
+    static thread_local PerfAllocCounts s_allocs;
+    static thread_local bool        s_bInternal;    // Allocations made by the library itself
 };
 
 #endif // __RDK_PERF_RECORD_H__
@@ -0,0 +1,115 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+#include "rdk_perf_sched.h"
+#include "rdk_perf_logging.h"
+
+// Keeps /proc/thread-self/schedstat open for the life of the thread, a
+// snapshot is then a single pread()
+class SchedStatFile
+{
+public:
+    SchedStatFile()
+    {
+        m_fd = open("/proc/thread-self/schedstat", O_RDONLY | O_CLOEXEC);
+        if(m_fd < 0) {
+            // Kernels before 3.17 have no thread-self
+            char szPath[64];
+            snprintf(szPath, sizeof(szPath), "/proc/self/task/%ld/schedstat", (long)syscall(SYS_gettid));
+            m_fd = open(szPath, O_RDONLY | O_CLOEXEC);
+        }
+    };
+    ~SchedStatFile()
+    {
+        if(m_fd >= 0) close(m_fd);
+    };
+
+    bool Read(uint64_t* pRunTimeNS, uint64_t* pRunDelayNS)
+    {
+        char szBuffer[128];
+
+        if(m_fd < 0) return false;
+
+        ssize_t nSize = pread(m_fd, szBuffer, sizeof(szBuffer) - 1, 0);
+        if(nSize <= 0) return false;
+        szBuffer[nSize] = '\0';
+
+        // "<on cpu ns> <run queue wait ns> <timeslices>"
+        char* szEnd = NULL;
+        *pRunTimeNS  = strtoull(szBuffer, &szEnd, 10);
+        *pRunDelayNS = strtoull(szEnd, NULL, 10);
+        return true;
+    };
+
+private:
+    int m_fd;
+};
+
+void PerfSched::Snapshot(SchedSnapshot* pSnapshot)
+{
+    static thread_local SchedStatFile t_schedStat;
+    struct rusage usage;
+
+    memset(pSnapshot, 0, sizeof(SchedSnapshot));
+    if(getrusage(RUSAGE_THREAD, &usage) == 0) {
+        pSnapshot->nVoluntary   = usage.ru_nvcsw;
+        pSnapshot->nInvoluntary = usage.ru_nivcsw;
+        pSnapshot->nMinorFaults = usage.ru_minflt;
+        pSnapshot->nMajorFaults = usage.ru_majflt;
+        pSnapshot->bValid       = true;
+    }
+    t_schedStat.Read(&pSnapshot->nRunTimeNS, &pSnapshot->nRunDelayNS);
+}
+
+void PerfSched::Format(char* szBuffer, size_t nSize, const SchedSnapshot* pStart,
+                       const SchedSnapshot* pEnd, uint64_t nElapsedUS)
+{
+    if(!pStart->bValid || !pEnd->bValid) {
+        snprintf(szBuffer, nSize, "no scheduler data");
+        return;
+    }
+
+    int nUsed = snprintf(szBuffer, nSize, "vol cs %llu, invol cs %llu, minor faults %llu, major faults %llu",
+                         (unsigned long long)(pEnd->nVoluntary - pStart->nVoluntary),
+                         (unsigned long long)(pEnd->nInvoluntary - pStart->nInvoluntary),
+                         (unsigned long long)(pEnd->nMinorFaults - pStart->nMinorFaults),
+                         (unsigned long long)(pEnd->nMajorFaults - pStart->nMajorFaults));
+
+    uint64_t nRunTimeUS  = (pEnd->nRunTimeNS - pStart->nRunTimeNS) / 1000;
+    uint64_t nRunDelayUS = (pEnd->nRunDelayNS - pStart->nRunDelayNS) / 1000;
+    if(pEnd->nRunTimeNS != 0 && nUsed > 0 && (size_t)nUsed < nSize) {
+        // Off CPU time is either waiting for a CPU (preemption) or blocked (I/O, locks, sleep)
+        uint64_t nOffCPU  = (nElapsedUS > nRunTimeUS) ? nElapsedUS - nRunTimeUS : 0;
+        uint64_t nBlocked = (nOffCPU > nRunDelayUS) ? nOffCPU - nRunDelayUS : 0;
+        snprintf(szBuffer + nUsed, nSize - nUsed, ", on cpu %0.3lf ms, runqueue wait %0.3lf ms, blocked %0.3lf ms",
+                 (double)nRunTimeUS / 1000.0, (double)nRunDelayUS / 1000.0, (double)nBlocked / 1000.0);
+    }
+}
@@ -0,0 +1,49 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef __RDK_PERF_SCHED_H__
+#define __RDK_PERF_SCHED_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Scheduler and fault counters of the calling thread.  Taken when a scope
+// gets a threshold and again when it exceeds it, so scopes without a
+// threshold pay nothing.
+typedef struct _SchedSnapshot
+{
+    bool                bValid;
+    uint64_t            nVoluntary;         // Context switches, blocked (I/O, locks, sleep)
+    uint64_t            nInvoluntary;       // Context switches, preempted
+    uint64_t            nMinorFaults;
+    uint64_t            nMajorFaults;       // Faults that needed I/O
+    uint64_t            nRunTimeNS;         // schedstat: time on CPU
+    uint64_t            nRunDelayNS;        // schedstat: time runnable but waiting for a CPU
+} SchedSnapshot;
+
+class PerfSched
+{
+public:
+    static void Snapshot(SchedSnapshot* pSnapshot);
+    // "vol cs ..., invol cs ..., ..." for the difference of two snapshots
+    static void Format(char* szBuffer, size_t nSize, const SchedSnapshot* pStart,
+                       const SchedSnapshot* pEnd, uint64_t nElapsedUS);
+};
+
+#endif // __RDK_PERF_SCHED_H__
@@ -0,0 +1,167 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "rdk_perf_schedule.h"
+#include "rdk_perf_logging.h"
+
+#define CRON_SEARCH_MINUTES     (48 * 60)   // Hours and minutes repeat daily
+
+PerfReportScheduler::PerfReportScheduler()
+: m_nPeriod(0), m_nNext(0)
+{
+    Default(&m_schedule);
+}
+
+void PerfReportScheduler::Default(ReportSchedule* pSchedule)
+{
+    memset(pSchedule, 0, sizeof(ReportSchedule));
+    pSchedule->type     = eScheduleBackoff;
+    pSchedule->nFirst   = 10;
+    pSchedule->nStep    = 50;
+    pSchedule->nMax     = 6000;
+}
+
+// "*", "*/n", "a", "a-b", "a-b/n" and lists of those separated by ','
+static bool ParseCronField(const char* szField, uint32_t nMax, uint64_t* pBits)
+{
+    char  szCopy[64];
+    char* szSave = NULL;
+
+    *pBits = 0;
+    strncpy(szCopy, szField, sizeof(szCopy) - 1);
+    szCopy[sizeof(szCopy) - 1] = '\0';
+
+    for(char* szPart = strtok_r(szCopy, ",", &szSave); szPart != NULL; szPart = strtok_r(NULL, ",", &szSave)) {
+        uint32_t nFirst = 0;
+        uint32_t nLast  = nMax - 1;
+        uint32_t nStep  = 1;
+        char*    szEnd  = szPart;
+
+        if(*szEnd == '*') {
+            szEnd++;
+        }
+        else {
+            nFirst = nLast = (uint32_t)strtoul(szEnd, &szEnd, 10);
+            if(*szEnd == '-') {
+                nLast = (uint32_t)strtoul(szEnd + 1, &szEnd, 10);
+            }
+        }
+        if(*szEnd == '/') {
+            nStep = (uint32_t)strtoul(szEnd + 1, &szEnd, 10);
+        }
+        if(*szEnd != '\0' || nStep == 0 || nFirst > nLast || nLast >= nMax) {
+            return false;
+        }
+        for(uint32_t nValue = nFirst; nValue <= nLast; nValue += nStep) {
+            *pBits |= (uint64_t)1 << nValue;
+        }
+    }
+    return *pBits != 0;
+}
+
+bool PerfReportScheduler::Parse(ReportSchedule* pSchedule, const char* szType, const char* szArgs[], uint32_t nArgs)
+{
+    uint32_t nValues[3] = { 0 };
+    for(uint32_t nIdx = 0; nIdx < nArgs && nIdx < 3 && strcmp(szType, "cron") != 0; nIdx++) {
+        char* szEnd = NULL;
+        nValues[nIdx] = (uint32_t)strtoul(szArgs[nIdx], &szEnd, 10);
+        if(szEnd == szArgs[nIdx] || *szEnd != '\0') {
+            return false;
+        }
+    }
+
+    if(strcmp(szType, "fixed") == 0 && nArgs == 1 && nValues[0] > 0) {
+        pSchedule->type     = eScheduleFixed;
+        pSchedule->nFirst   = nValues[0];
+        return true;
+    }
+    if(strcmp(szType, "backoff") == 0 && nArgs == 3 && nValues[0] > 0 && nValues[2] >= nValues[0]) {
+        pSchedule->type     = eScheduleBackoff;
+        pSchedule->nFirst   = nValues[0];
+        pSchedule->nStep    = nValues[1];
+        pSchedule->nMax     = nValues[2];
+        return true;
+    }
+    if(strcmp(szType, "cron") == 0 && nArgs == 2) {
+        uint64_t nHours = 0;
+        if(ParseCronField(szArgs[0], 60, &pSchedule->nMinutes) && ParseCronField(szArgs[1], 24, &nHours)) {
+            pSchedule->type     = eScheduleCron;
+            pSchedule->nHours   = (uint32_t)nHours;
+            return true;
+        }
+    }
+    return false;
+}
+
+void PerfReportScheduler::SetSchedule(const ReportSchedule& schedule, time_t nNow)
+{
+    m_schedule  = schedule;
+    m_nPeriod   = schedule.nFirst;
+    m_nNext     = (schedule.type == eScheduleCron) ? NextCron(nNow) : nNow + m_nPeriod;
+}
+
+void PerfReportScheduler::Reported(time_t nNow, uint64_t nCPUUS)
+{
+    switch(m_schedule.type) {
+    case eScheduleBackoff:
+        m_nPeriod += m_schedule.nStep;
+        if(m_nPeriod > m_schedule.nMax) {
+            m_nPeriod = m_schedule.nMax;
+        }
+        m_nNext = nNow + m_nPeriod;
+        break;
+    case eScheduleFixed:
+        m_nNext = nNow + m_nPeriod;
+        break;
+    case eScheduleCron:
+        m_nNext = NextCron(nNow);
+        break;
+    }
+
+    if(m_schedule.nCPUBudget != 0) {
+        // A report that took 20 ms of CPU with a 1% budget waits at least 2 s
+        time_t nEarliest = nNow + (time_t)((nCPUUS * 100) / ((uint64_t)m_schedule.nCPUBudget * 1000000));
+        if(m_nNext < nEarliest) {
+            LOG(eWarning, "Report used %0.3lf ms CPU, next report delayed by %d s for the CPU budget\n",
+                (double)nCPUUS / 1000.0, (int)(nEarliest - m_nNext));
+            m_nNext = nEarliest;
+        }
+    }
+}
+
+time_t PerfReportScheduler::NextCron(time_t nAfter) const
+{
+    // Start of the next minute
+    time_t nTime = nAfter - (nAfter % 60) + 60;
+    for(uint32_t nIdx = 0; nIdx < CRON_SEARCH_MINUTES; nIdx++, nTime += 60) {
+        struct tm local;
+        localtime_r(&nTime, &local);
+        if((m_schedule.nMinutes & ((uint64_t)1 << local.tm_min)) != 0 &&
+           (m_schedule.nHours & ((uint32_t)1 << local.tm_hour)) != 0) {
+            return nTime;
+        }
+    }
+    return nAfter + 3600;
+}
@@ -0,0 +1,77 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+
+#ifndef __RDK_PERF_SCHEDULE_H__
+#define __RDK_PERF_SCHEDULE_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define SCHEDULE_TRIGGER_LEN    128
+
+typedef enum _ScheduleType
+{
+    eScheduleBackoff    = 0,    // Period grows after every report
+    eScheduleFixed      = 1,
+    eScheduleCron       = 2     // At matching minutes and hours of local time
+} ScheduleType;
+
+typedef struct _ReportSchedule
+{
+    ScheduleType        type;
+    uint32_t            nFirst;         // s, period (fixed) or first period (back off)
+    uint32_t            nStep;          // s, added to the period after every report (back off)
+    uint32_t            nMax;           // s, longest period (back off)
+    uint64_t            nMinutes;       // Bit n set reports in minute n (cron)
+    uint32_t            nHours;         // Bit n set reports in hour n (cron)
+    uint32_t            nCPUBudget;     // Percent of one CPU the reporter may use, 0 no limit
+    char                szTrigger[SCHEDULE_TRIGGER_LEN];    // Touching this file requests a report
+} ReportSchedule;
+
+// Decides when the report thread reports next.  Pure bookkeeping, the
+// thread itself lives with the rest of the reporting in librdkperf.
+class PerfReportScheduler
+{
+public:
+    PerfReportScheduler();
+
+    // The schedule used without a configuration file: first report after
+    // 10 s, then 50 s more after every report up to 100 minutes
+    static void Default(ReportSchedule* pSchedule);
+    // "fixed <s>", "backoff <first s> <step s> <max s>" or "cron <minute> <hour>"
+    // with cron fields like "*", "*/15", "5", "0-30/10" or "8,20"
+    static bool Parse(ReportSchedule* pSchedule, const char* szType, const char* szArgs[], uint32_t nArgs);
+
+    void        SetSchedule(const ReportSchedule& schedule, time_t nNow);
+    const ReportSchedule& GetSchedule() const   { return m_schedule; };
+    time_t      NextReport() const              { return m_nNext; };
+    // nCPUUS is the CPU time the report took, spread over nCPUUS * 100 / budget
+    void        Reported(time_t nNow, uint64_t nCPUUS);
+
+private:
+    time_t      NextCron(time_t nAfter) const;
+
+    ReportSchedule      m_schedule;
+    uint32_t            m_nPeriod;      // Current back off period
+    time_t              m_nNext;
+};
+
+#endif // __RDK_PERF_SCHEDULE_H__
@@ -27,6 +27,13 @@
 
 #include "rdk_perf_logging.h"
 #include "rdk_perf_scopedlock.h"
+#ifdef PERF_LOCK_STATS
+#include "rdk_perf_lock.h"
+#endif
+
+namespace RDKPERF {
+thread_local uint32_t t_nLockDepth = 0;
+}
 
 #ifdef USE_LIBC_SCOPED_LOCK
 
@@ -35,15 +42,38 @@ std::recursive_mutex _lock;
 #else // USE_LIBC_SCOPED_LOCK
 namespace RDKPERF {
 
+#ifdef PERF_LOCK_STATS
+// The lock is recursive, only the outermost acquisition is measured
+static thread_local uint32_t t_nDepth = 0;
+static thread_local uint64_t t_nAcquired = 0;
+#endif
+
 ScopedMutex::ScopedMutex(const char* strFN) 
-: _strFN(strFN)
+: _depth()
+, _strFN(strFN)
 {
     if(!_bMutexInit) {
         InitMutex(&_lock);
     }
     
     if(_bMutexInit) {
+#ifdef PERF_LOCK_STATS
+        if(t_nDepth++ == 0) {
+            bool bContended = false;
+            uint64_t nStart = PerfLock::TimeStamp();
+            if(pthread_mutex_trylock(&_lock) != 0) {
+                bContended = true;
+                pthread_mutex_lock(&_lock);
+            }
+            t_nAcquired = PerfLock::TimeStamp();
+            PerfLock::Library()->NoteAcquire(t_nAcquired - nStart, bContended);
+        }
+        else {
+            pthread_mutex_lock(&_lock);
+        }
+#else
         pthread_mutex_lock(&_lock);
+#endif
     }
     else {
         LOG(eError, "Mutex was not initialized for %s\n", _strFN);
@@ -51,6 +81,11 @@ ScopedMutex::ScopedMutex(const char* strFN)
 }
 ScopedMutex::~ScopedMutex() 
 {
+#ifdef PERF_LOCK_STATS
+    if(_bMutexInit && --t_nDepth == 0) {
+        PerfLock::Library()->NoteRelease(PerfLock::TimeStamp() - t_nAcquired);
+    }
+#endif
     pthread_mutex_unlock(&_lock);
 }
 void ScopedMutex::InitMutex(pthread_mutex_t* pLock)
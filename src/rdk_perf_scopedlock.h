@@ -19,15 +19,34 @@
 #ifndef __RDK_PERF_SCOPEDLOCK_H__
 #define __RDK_PERF_SCOPEDLOCK_H__
 
+#include <stdint.h>
+
 #ifdef USE_LIBC_SCOPED_LOCK
 #include <mutex>
 #else
 #include <pthread.h>
 #endif
 
+namespace RDKPERF {
+
+// Nonzero while the calling thread waits for or holds the library's lock.
+// Everything the library does then, allocations included, is its own work
+// and is not attributed to the user's scopes (see the preload library).
+extern thread_local uint32_t t_nLockDepth;
+inline bool InLibraryLock() { return t_nLockDepth != 0; }
+
+class LockDepth
+{
+public:
+    LockDepth()     { t_nLockDepth++; };
+    ~LockDepth()    { t_nLockDepth--; };
+};
+}
+
 #ifdef USE_LIBC_SCOPED_LOCK
 extern std::recursive_mutex _lock;
-#define SCOPED_LOCK()     std::lock_guard<std::recursive_mutex> lock(_lock)
+// The depth is declared first so it is decremented after the unlock
+#define SCOPED_LOCK()     RDKPERF::LockDepth lockDepth; std::lock_guard<std::recursive_mutex> lock(_lock)
 #else
 
 namespace RDKPERF {
@@ -40,6 +59,7 @@ public:
 private:
     void InitMutex(pthread_mutex_t* pLock);
 
+    LockDepth   _depth;     // Constructed before the lock is taken, destroyed after it is released
     const char* _strFN;
     static bool _bMutexInit;
 
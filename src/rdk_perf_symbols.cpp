@@ -0,0 +1,85 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <cxxabi.h>
+
+#include "rdk_perf_symbols.h"
+#include "rdk_perf_logging.h"
+#include "rdk_perf_scopedlock.h"
+
+std::map<std::string, std::string> PerfSymbols::s_cache;
+
+std::string PerfSymbols::AddressName(void* pAddress)
+{
+    char szName[32];
+    snprintf(szName, sizeof(szName), "%c%p", PERF_SYMBOL_PREFIX, pAddress);
+    return std::string(szName);
+}
+
+// Produces "symbol [module+0xoffset]".  The module relative offset can be
+// fed to addr2line offline when the target has no dynamic symbol table.
+std::string PerfSymbols::Describe(void* pAddress)
+{
+    Dl_info     info;
+    char        szBuffer[512];
+
+    memset(&info, 0, sizeof(info));
+    if(dladdr(pAddress, &info) == 0 || info.dli_fname == NULL) {
+        snprintf(szBuffer, sizeof(szBuffer), "%p", pAddress);
+        return std::string(szBuffer);
+    }
+
+    const char* szModule = strrchr(info.dli_fname, '/');
+    szModule = (szModule != NULL) ? szModule + 1 : info.dli_fname;
+    uintptr_t nOffset = (uintptr_t)pAddress - (uintptr_t)info.dli_fbase;
+
+    if(info.dli_sname != NULL) {
+        int     status = 0;
+        char*   szDemangled = abi::__cxa_demangle(info.dli_sname, NULL, NULL, &status);
+        snprintf(szBuffer, sizeof(szBuffer), "%s [%s+0x%lx]",
+                 (status == 0 && szDemangled != NULL) ? szDemangled : info.dli_sname,
+                 szModule, (unsigned long)nOffset);
+        free(szDemangled);
+    }
+    else {
+        snprintf(szBuffer, sizeof(szBuffer), "%s+0x%lx", szModule, (unsigned long)nOffset);
+    }
+
+    return std::string(szBuffer);
+}
+
+const char* PerfSymbols::Resolve(const std::string& name)
+{
+    SCOPED_LOCK();
+
+    auto it = s_cache.find(name);
+    if(it == s_cache.end()) {
+        void* pAddress = (void*)strtoull(name.c_str() + 1, NULL, 16);
+        it = s_cache.insert(std::pair<std::string, std::string>(name, Describe(pAddress))).first;
+    }
+
+    return it->second.c_str();
+}
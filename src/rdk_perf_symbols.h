@@ -0,0 +1,44 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef __RDK_PERF_SYMBOLS_H__
+#define __RDK_PERF_SYMBOLS_H__
+
+#include <stdint.h>
+
+#include <string>
+#include <map>
+
+// Nodes created from a code address (i.e. automatic function instrumentation)
+// are named "@0x<address>".  The address is only turned into a symbol name
+// when a report is printed.
+#define PERF_SYMBOL_PREFIX '@'
+
+class PerfSymbols
+{
+public:
+    static std::string AddressName(void* pAddress);
+    static bool IsAddressName(const std::string& name) { return !name.empty() && name[0] == PERF_SYMBOL_PREFIX; };
+    static const char* Resolve(const std::string& name);
+    static std::string Describe(void* pAddress);
+
+private:
+    static std::map<std::string, std::string> s_cache;
+};
+
+#endif // __RDK_PERF_SYMBOLS_H__
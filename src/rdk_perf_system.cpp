@@ -0,0 +1,209 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "rdk_perf_system.h"
+#include "rdk_perf_node.h"
+#include "rdk_perf_logging.h"
+#include "rdk_perf_scopedlock.h"
+
+typedef struct _SystemViewData
+{
+    std::map<std::string, SystemProcess>    processes;
+    std::map<std::string, SystemScope>      scopes;
+    time_t                                  nLastReport;
+} SystemViewData;
+
+// Allocated when enabled and never freed at unload, processes can still
+// be removed from library destructors
+static SystemViewData* sp_View = NULL;
+
+void PerfSystemView::Enable(bool bEnable)
+{
+    SCOPED_LOCK();
+
+    if(bEnable && sp_View == NULL) {
+        sp_View = new SystemViewData();
+        sp_View->nLastReport = time(NULL);
+    }
+    else if(!bEnable && sp_View != NULL) {
+        delete sp_View;
+        sp_View = NULL;
+    }
+}
+
+bool PerfSystemView::IsEnabled()
+{
+    return sp_View != NULL;
+}
+
+void PerfSystemView::ProcessStarted(const char* szName, pid_t pID)
+{
+    SCOPED_LOCK();
+
+    if(sp_View == NULL) {
+        return;
+    }
+
+    SystemProcess& process = sp_View->processes[szName];
+    time_t nNow = time(NULL);
+    if(process.nStarts == 0) {
+        process.nFirstStart = nNow;
+    }
+    else if(process.bRunning && process.pID != pID) {
+        // A second instance, or the previous one died without closing
+        LOG(eWarning, "Process %s started as %X while %X was not closed\n", szName, pID, process.pID);
+        process.nUpTime += (uint64_t)(nNow - process.nLastStart);
+    }
+    else if(process.pID != pID) {
+        LOG(eWarning, "Process %s restarted as %X, instance %u\n", szName, pID, process.nStarts + 1);
+    }
+    process.pID         = pID;
+    process.bRunning    = true;
+    process.nLastStart  = nNow;
+    process.nStarts++;
+}
+
+void PerfSystemView::ProcessExited(const char* szName, pid_t pID)
+{
+    SCOPED_LOCK();
+
+    if(sp_View == NULL) {
+        return;
+    }
+
+    auto it = sp_View->processes.find(szName);
+    if(it != sp_View->processes.end() && it->second.pID == pID && it->second.bRunning) {
+        it->second.bRunning = false;
+        it->second.nUpTime += (uint64_t)(time(NULL) - it->second.nLastStart);
+    }
+}
+
+void PerfSystemView::AddNode(const std::string& process, PerfNode* pNode)
+{
+    const TimingStats* pStats = pNode->GetStats();
+
+    if(pStats->nIntervalCount != 0) {
+        SystemScope& scope = sp_View->scopes[pNode->GetName()];
+        scope.nIntervalCount   += pStats->nIntervalCount;
+        scope.nIntervalTime    += pStats->nIntervalTime;
+        scope.nIntervalMax      = std::max(scope.nIntervalMax, pStats->nIntervalMax);
+        scope.nTotalCount      += pStats->nIntervalCount;
+        scope.nTotalTime       += pStats->nIntervalTime;
+        scope.nTotalMax         = std::max(scope.nTotalMax, pStats->nIntervalMax);
+
+        SystemShare& share = scope.shares[process];
+        share.nIntervalCount   += pStats->nIntervalCount;
+        share.nIntervalTime    += pStats->nIntervalTime;
+        share.nTotalCount      += pStats->nIntervalCount;
+        share.nTotalTime       += pStats->nIntervalTime;
+    }
+
+    auto it = pNode->GetChildren().begin();
+    while(it != pNode->GetChildren().end()) {
+        AddNode(process, it->second);
+        it++;
+    }
+}
+
+void PerfSystemView::AddInterval(const char* szProcess, PerfNode* pViewRoot)
+{
+    SCOPED_LOCK();
+
+    if(sp_View == NULL || pViewRoot == NULL) {
+        return;
+    }
+
+    // The root carries no data of its own
+    std::string process(szProcess);
+    auto it = pViewRoot->GetChildren().begin();
+    while(it != pViewRoot->GetChildren().end()) {
+        AddNode(process, it->second);
+        it++;
+    }
+}
+
+static bool MoreIntervalTime(const std::pair<const std::string, SystemScope>* pA,
+                             const std::pair<const std::string, SystemScope>* pB)
+{
+    return pA->second.nIntervalTime > pB->second.nIntervalTime;
+}
+
+void PerfSystemView::ReportData()
+{
+    SCOPED_LOCK();
+
+    if(sp_View == NULL) {
+        return;
+    }
+
+    time_t nNow = time(NULL);
+    LOG(eWarning, "Printing system view of %u processes, Interval Elapsed wallClock: %lu s\n",
+        (uint32_t)sp_View->processes.size(), (unsigned long)(nNow - sp_View->nLastReport));
+    sp_View->nLastReport = nNow;
+
+    for(auto it = sp_View->processes.begin(); it != sp_View->processes.end(); it++) {
+        const SystemProcess& process = it->second;
+        uint64_t nUpTime = process.nUpTime + (process.bRunning ? (uint64_t)(nNow - process.nLastStart) : 0);
+        LOG(eWarning, "| process %s PID %X %s, started %u times, up %llu s of %llu s\n",
+            it->first.c_str(), process.pID, process.bRunning ? "running" : "exited", process.nStarts,
+            (unsigned long long)nUpTime, (unsigned long long)(nNow - process.nFirstStart));
+    }
+
+    // Most expensive scope of the interval first
+    std::vector<std::pair<const std::string, SystemScope>*> sorted;
+    for(auto it = sp_View->scopes.begin(); it != sp_View->scopes.end(); it++) {
+        sorted.push_back(&(*it));
+    }
+    std::sort(sorted.begin(), sorted.end(), MoreIntervalTime);
+
+    for(auto it = sorted.begin(); it != sorted.end(); it++) {
+        SystemScope& scope = (*it)->second;
+        LOG(eWarning, "| %s (Count, Max ms, Time ms) Total %llu, %0.3lf, %0.3lf Interval %llu, %0.3lf, %0.3lf\n",
+            (*it)->first.c_str(),
+            (unsigned long long)scope.nTotalCount, (double)scope.nTotalMax / 1000.0, (double)scope.nTotalTime / 1000.0,
+            (unsigned long long)scope.nIntervalCount, (double)scope.nIntervalMax / 1000.0, (double)scope.nIntervalTime / 1000.0);
+        if(scope.shares.size() > 1) {
+            for(auto itShare = scope.shares.begin(); itShare != scope.shares.end(); itShare++) {
+                const SystemShare& share = itShare->second;
+                LOG(eWarning, "--= %s Total %llu, %0.3lf ms (%0.1f%%) Interval %llu, %0.3lf ms (%0.1f%%)\n",
+                    itShare->first.c_str(),
+                    (unsigned long long)share.nTotalCount, (double)share.nTotalTime / 1000.0,
+                    scope.nTotalTime == 0 ? 0.0 : (double)share.nTotalTime * 100.0 / (double)scope.nTotalTime,
+                    (unsigned long long)share.nIntervalCount, (double)share.nIntervalTime / 1000.0,
+                    scope.nIntervalTime == 0 ? 0.0 : (double)share.nIntervalTime * 100.0 / (double)scope.nIntervalTime);
+            }
+        }
+
+        scope.nIntervalCount    = 0;
+        scope.nIntervalTime     = 0;
+        scope.nIntervalMax      = 0;
+        for(auto itShare = scope.shares.begin(); itShare != scope.shares.end(); itShare++) {
+            itShare->second.nIntervalCount  = 0;
+            itShare->second.nIntervalTime   = 0;
+        }
+    }
+}
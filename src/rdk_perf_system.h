@@ -0,0 +1,89 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+
+#ifndef __RDK_PERF_SYSTEM_H__
+#define __RDK_PERF_SYSTEM_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/types.h>
+
+#include <string>
+#include <map>
+
+#define SYSTEM_REPORT_INTERVAL  60      // Seconds between system reports in perfservice
+
+// Forward decls
+class PerfNode;
+
+// Time one process name spent in a scope
+typedef struct _SystemShare
+{
+    uint64_t            nIntervalCount;
+    uint64_t            nIntervalTime;
+    uint64_t            nTotalCount;
+    uint64_t            nTotalTime;
+} SystemShare;
+
+typedef struct _SystemScope
+{
+    uint64_t            nIntervalCount;
+    uint64_t            nIntervalTime;
+    uint64_t            nIntervalMax;
+    uint64_t            nTotalCount;
+    uint64_t            nTotalTime;
+    uint64_t            nTotalMax;
+    std::map<std::string, SystemShare>  shares;     // By process name
+} SystemScope;
+
+// Lifetime of every process seen with a name, a daemon that is respawned
+// under a new PID continues the same history
+typedef struct _SystemProcess
+{
+    pid_t               pID;            // Current or last PID
+    bool                bRunning;
+    uint32_t            nStarts;
+    time_t              nFirstStart;
+    time_t              nLastStart;
+    uint64_t            nUpTime;        // Seconds, of the instances that exited
+} SystemProcess;
+
+// Scopes of all processes summed by scope name, fed from the process views
+// when their intervals are cleared.  Enabled by perfservice, which sees
+// every process that records remotely.  All calls take the lock.
+class PerfSystemView
+{
+public:
+    static void Enable(bool bEnable);
+    static bool IsEnabled();
+
+    static void ProcessStarted(const char* szName, pid_t pID);
+    static void ProcessExited(const char* szName, pid_t pID);
+    // Adds the interval of every node below the root of a process view
+    static void AddInterval(const char* szProcess, PerfNode* pViewRoot);
+
+    static void ReportData();
+
+private:
+    static void AddNode(const std::string& process, PerfNode* pNode);
+};
+
+#endif // __RDK_PERF_SYSTEM_H__
@@ -21,15 +21,19 @@
 #include <string.h>
 #include <dlfcn.h>
 
+#include <vector>
+
 #include "rdk_perf_node.h"
 #include "rdk_perf_record.h"
 #include "rdk_perf_msgqueue.h"
 #include "rdk_perf_tree.h"
 #include "rdk_perf_process.h"
 #include "rdk_perf_logging.h"
+#include "rdk_perf_config.h"
 
 PerfTree::PerfTree()
-:m_idThread(0), m_rootNode(NULL), m_ActivityCount(0), m_CountAtLastReport(0)
+:m_idThread(0), m_rootNode(NULL), m_ActivityCount(0), m_CountAtLastReport(0), m_nMergedThreads(0)
+, m_nGroupGeneration(0), m_pViewRoot(NULL)
 {
     memset(m_ThreadName, 0, THREAD_NAMELEN);
     return;
@@ -54,6 +58,7 @@ PerfNode* PerfTree::AddNode(PerfRecord* pRecord)
     else {
         // New Tree
         m_rootNode = new PerfNode();    // root node special constructor
+        m_rootNode->SetTree(this);
         m_activeNode.push(m_rootNode);
         m_idThread = pthread_self();
         pthread_getname_np(m_idThread, m_ThreadName, THREAD_NAMELEN);
@@ -82,6 +87,7 @@ PerfNode* PerfTree::AddNode(char* szName, pthread_t tID, char* szThreadName, uin
     else {
         // New Tree
         m_rootNode = new PerfNode();    // root node special constructor
+        m_rootNode->SetTree(this);
         m_activeNode.push(m_rootNode);
         m_idThread = tID;
         memcpy(m_ThreadName, szThreadName, strlen(szThreadName));
@@ -99,6 +105,20 @@ PerfNode* PerfTree::AddNode(char* szName, pthread_t tID, char* szThreadName, uin
     return pNode;
 }
 
+// Adds an already completed call below the active node without opening it
+PerfNode* PerfTree::AddLeaf(char* szName, pthread_t tID, uint64_t nStartTime, uint64_t nElapsedTime)
+{
+    PerfNode* pNode = NULL;
+
+    if(m_activeNode.size() > 0) {
+        pNode = m_activeNode.top()->AddChild(szName, tID, nStartTime);
+        pNode->SetTree(this);
+        pNode->IncrementData(nElapsedTime, 0, 0);
+    }
+
+    return pNode;
+}
+
 bool PerfTree::IsInactive()
 {
     bool retVal = false;
@@ -114,32 +134,85 @@ bool PerfTree::IsInactive()
     return retVal;
 }
 
+// A scope stopped on another thread may close before the scopes opened
+// after it, those stay open and are closed later in their own order
 void PerfTree::CloseActiveNode(PerfNode* pTreeNode)
 {
-    //Get last opended node
-    PerfNode* pTop = m_activeNode.top();
-    if(pTop != NULL) {
-        // There is an active node
-        if(pTreeNode != pTop) {
-            // Error
-            LOG(eError, "Not closeing the active node(%s != %s)\n", 
-                pTop->GetName().c_str(), pTreeNode->GetName().c_str());
-        }
-        else {
-            // LOG(eTrace, "Closeing the active node %s\n", 
-            //             pTop->GetName().c_str());
-            m_activeNode.pop();
-        }
+    std::vector<PerfNode*> above;
+
+    while(m_activeNode.size() > 1 && m_activeNode.top() != pTreeNode) {
+        above.push_back(m_activeNode.top());
+        m_activeNode.pop();
+    }
+    if(m_activeNode.size() > 1) {
+        m_activeNode.pop();
+    }
+    else {
+        // Error
+        LOG(eError, "Not closeing the node %s, it is not open\n", pTreeNode->GetName().c_str());
+    }
+    while(!above.empty()) {
+        m_activeNode.push(above.back());
+        above.pop_back();
     }
 
     return;
 }
 
+void PerfTree::MergeFrom(PerfTree* pOther)
+{
+    if(m_rootNode == NULL) {
+        m_rootNode = new PerfNode();
+        m_rootNode->SetTree(this);
+        m_activeNode.push(m_rootNode);
+        memcpy(m_ThreadName, pOther->m_ThreadName, THREAD_NAMELEN);
+    }
+    if(pOther->m_rootNode != NULL) {
+        m_rootNode->MergeChildren(pOther->m_rootNode);
+    }
+    // An aggregate of exited threads counts for all of them
+    m_nMergedThreads += (pOther->m_nMergedThreads != 0) ? pOther->m_nMergedThreads : 1;
+    m_ActivityCount++;
+
+    return;
+}
+
+bool PerfTree::GetGroup(std::string* pGroup)
+{
+    if(m_nGroupGeneration != PerfConfig::Generation()) {
+        m_nGroupGeneration = PerfConfig::Generation();
+        m_group.clear();
+        PerfConfig::ResolveThreadGroup(m_ThreadName, &m_group);
+    }
+    *pGroup = m_group;
+    return !m_group.empty();
+}
+
+void PerfTree::ResetInterval()
+{
+    if(m_rootNode != NULL) {
+        m_rootNode->ResetInterval(true);
+    }
+    m_CountAtLastReport = m_ActivityCount;
+
+    return;
+}
+
 void PerfTree::ReportData(uint32_t msIntervalTime)
 {
     // Get the root node and walk down the tree
-    LOG(eWarning, "Printing report on %X thread named %s, Interval Elapsed wallClock: %lu ms\n",
-        (uint32_t)m_idThread, m_ThreadName, msIntervalTime);
+    if(!m_groupName.empty()) {
+        LOG(eWarning, "Printing report on %u threads in group %s, Interval Elapsed wallClock: %lu ms\n",
+            m_nMergedThreads, m_groupName.c_str(), msIntervalTime);
+    }
+    else if(m_nMergedThreads != 0) {
+        LOG(eWarning, "Printing report on %u exited threads named %s, Interval Elapsed wallClock: %lu ms\n",
+            m_nMergedThreads, m_ThreadName, msIntervalTime);
+    }
+    else {
+        LOG(eWarning, "Printing report on %X thread named %s, Interval Elapsed wallClock: %lu ms\n",
+            (uint32_t)m_idThread, m_ThreadName, msIntervalTime);
+    }
     m_rootNode->ReportData(0, false, msIntervalTime);
     
     // Update the activity monitor
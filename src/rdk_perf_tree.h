@@ -46,13 +46,26 @@ public:
 
     PerfNode* AddNode(PerfRecord* pRecord);
     PerfNode* AddNode(char* szName, pthread_t tID, char* szThreadName, uint64_t nStartTime);
+    PerfNode* AddLeaf(char* szName, pthread_t tID, uint64_t nStartTime, uint64_t nElapsedTime);
     void CloseActiveNode(PerfNode* pTreeNode);
     void ReportData(uint32_t msIntervalTime=0);
+    // Folds the tree of an exited thread, or of a thread in a group, into this one
+    void MergeFrom(PerfTree* pOther);
+    void SetGroupName(const std::string& group) { m_groupName = group; };
+    // Thread group from the configuration, resolved again when it changes
+    bool GetGroup(std::string* pGroup);
+    // Interval statistics are cleared as if the tree had been reported
+    void ResetInterval();
+    // Root of the process view the nodes of this tree add their intervals to
+    void SetViewRoot(PerfNode* pViewRoot) { m_pViewRoot = pViewRoot; };
+    PerfNode* GetViewRoot() { return m_pViewRoot; };
+    PerfNode* GetRoot() { return m_rootNode; };
 
     bool IsInactive();
     char * GetName() { return m_ThreadName; };
     std::stack<PerfNode*>* GetStack() { return &m_activeNode; }
     pthread_t GetThreadID() { return m_idThread; };
+    uint32_t GetMergedThreads() { return m_nMergedThreads; };
 
 private:
     pthread_t               m_idThread;
@@ -60,6 +73,11 @@ private:
     char                    m_ThreadName[THREAD_NAMELEN];
     uint64_t                m_ActivityCount;
     uint64_t                m_CountAtLastReport;
+    uint32_t                m_nMergedThreads;   // Non zero for exited threads and groups
+    std::string             m_groupName;        // Set on the trees of a thread group
+    uint32_t                m_nGroupGeneration; // 0 until resolved
+    std::string             m_group;            // Empty when in no group
+    PerfNode*               m_pViewRoot;        // NULL for trees outside the process view
     std::stack<PerfNode*>   m_activeNode;
 };
 
@@ -0,0 +1,224 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/prctl.h>
+
+#include <set>
+#include <vector>
+
+#include "rdk_perf_watchdog.h"
+#include "rdk_perf_record.h"
+#include "rdk_perf_logging.h"
+
+#define WATCHDOG_READ_RETRIES   16
+
+// Open scopes of one thread, copied for a scan
+typedef struct _ThreadScopes
+{
+    PerfThreadStack*    pStack;
+    pthread_t           idThread;
+    char                szThreadName[WATCHDOG_THREAD_NAME];
+    uint32_t            nDepth;
+    OpenScope           scopes[WATCHDOG_DEPTH];
+} ThreadScopes;
+
+// Stacks of the live threads.  A separate lock from the global one so that
+// scanning never blocks threads opening or closing scopes.
+static pthread_mutex_t              s_stacksLock = PTHREAD_MUTEX_INITIALIZER;
+static std::set<PerfThreadStack*>   s_stacks;
+static std::atomic<bool>            s_bStarted(false);
+
+PerfThreadStack::PerfThreadStack()
+: m_idThread(pthread_self())
+, m_nSequence(0)
+, m_nDepth(0)
+, m_nClosedID(WATCHDOG_NONE_CLOSED)
+, m_nNextID(0)
+{
+    memset(m_szThreadName, 0, sizeof(m_szThreadName));
+    prctl(PR_GET_NAME, m_szThreadName, 0, 0, 0);
+
+    pthread_mutex_lock(&s_stacksLock);
+    s_stacks.insert(this);
+    pthread_mutex_unlock(&s_stacksLock);
+
+    if(getenv("RDKPERF_WATCHDOG_MS") != NULL) {
+        PerfWatchdog::Start();
+    }
+    return;
+}
+
+PerfThreadStack::~PerfThreadStack()
+{
+    pthread_mutex_lock(&s_stacksLock);
+    s_stacks.erase(this);
+    pthread_mutex_unlock(&s_stacksLock);
+    return;
+}
+
+uint32_t PerfThreadStack::Read(OpenScope* pScopes)
+{
+    for(uint32_t nTry = 0; nTry < WATCHDOG_READ_RETRIES; nTry++) {
+        uint32_t nSequence = m_nSequence.load(std::memory_order_acquire);
+        if(nSequence & 1) {
+            continue;
+        }
+
+        uint32_t nDepth = m_nDepth.load(std::memory_order_relaxed);
+        if(nDepth > WATCHDOG_DEPTH) {
+            nDepth = WATCHDOG_DEPTH;
+        }
+        memcpy(pScopes, m_scopes, nDepth * sizeof(OpenScope));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(m_nSequence.load(std::memory_order_relaxed) == nSequence) {
+            // Leave out scopes already closed by another thread
+            uint64_t nClosed = m_nClosedID.load(std::memory_order_relaxed);
+            for(uint32_t nIdx = 0; nIdx < nDepth; nIdx++) {
+                if(pScopes[nIdx].nID >= nClosed) {
+                    return nIdx;
+                }
+            }
+            return nDepth;
+        }
+    }
+    return 0;
+}
+
+PerfThreadStack* PerfWatchdog::ForThread()
+{
+    static thread_local PerfThreadStack t_stack;
+    return &t_stack;
+}
+
+void PerfWatchdog::CloseScope(PerfThreadStack* pStack, pthread_t idThread, uint64_t nID)
+{
+    // The opening thread may have exited, only mark stacks that are still live
+    pthread_mutex_lock(&s_stacksLock);
+    if(s_stacks.find(pStack) != s_stacks.end() && pthread_equal(pStack->GetThreadID(), idThread)) {
+        pStack->MarkClosed(nID);
+    }
+    pthread_mutex_unlock(&s_stacksLock);
+}
+
+void PerfWatchdog::Start()
+{
+    if(s_bStarted.load()) {
+        return;
+    }
+
+    pthread_mutex_lock(&s_stacksLock);
+    if(!s_bStarted.load()) {
+        pthread_t tID;
+        if(pthread_create(&tID, NULL, WatchdogThread, NULL) == 0) {
+            pthread_detach(tID);
+            s_bStarted.store(true);
+        }
+        else {
+            LOG(eError, "Could not start the watchdog thread\n");
+        }
+    }
+    pthread_mutex_unlock(&s_stacksLock);
+}
+
+void* PerfWatchdog::WatchdogThread(void* pArg)
+{
+    pthread_setname_np(pthread_self(), "rdkperf_wdog");
+    while(true) {
+        usleep(WATCHDOG_PERIOD_MS * 1000);
+        Scan();
+    }
+
+    return NULL;
+}
+
+void PerfWatchdog::Scan()
+{
+    // Scopes already reported, by thread stack and scope ID
+    static std::set<std::pair<PerfThreadStack*, uint64_t> > s_reported;
+    static uint64_t s_nLimitUS = (getenv("RDKPERF_WATCHDOG_MS") != NULL) ?
+                                 strtoull(getenv("RDKPERF_WATCHDOG_MS"), NULL, 10) * 1000 : 0;
+
+    std::set<std::pair<PerfThreadStack*, uint64_t> > stillOpen;
+    std::vector<ThreadScopes> threads;
+    char        szPath[MAX_BUF_SIZE];
+    uint64_t    nNow = PerfRecord::TimeStamp();
+
+    // Only copy under the lock, thread names and logging can block
+    pthread_mutex_lock(&s_stacksLock);
+    threads.resize(s_stacks.size());
+    size_t nThreads = 0;
+    for(auto it = s_stacks.begin(); it != s_stacks.end(); it++) {
+        ThreadScopes& thread = threads[nThreads];
+        thread.nDepth = (*it)->Read(thread.scopes);
+        if(thread.nDepth != 0) {
+            thread.pStack   = *it;
+            thread.idThread = (*it)->GetThreadID();
+            memcpy(thread.szThreadName, (*it)->GetThreadName(), WATCHDOG_THREAD_NAME);
+            nThreads++;
+        }
+    }
+    pthread_mutex_unlock(&s_stacksLock);
+    threads.resize(nThreads);
+
+    for(auto it = threads.begin(); it != threads.end(); it++) {
+        const OpenScope* scopes = it->scopes;
+
+        // The innermost stalled scope is the interesting one, report it with the path to it
+        for(int32_t nIdx = (int32_t)it->nDepth - 1; nIdx >= 0; nIdx--) {
+            const OpenScope& scope = scopes[nIdx];
+            uint64_t nOpenUS = (nNow > scope.nStartTime) ? nNow - scope.nStartTime : 0;
+            bool bThreshold = scope.nThresholdUS > 0 && nOpenUS > (uint64_t)scope.nThresholdUS;
+            bool bLimit     = s_nLimitUS != 0 && nOpenUS > s_nLimitUS;
+            if(!bThreshold && !bLimit) {
+                continue;
+            }
+
+            std::pair<PerfThreadStack*, uint64_t> key(it->pStack, scope.nID);
+            stillOpen.insert(key);
+            if(s_reported.find(key) != s_reported.end()) {
+                break;
+            }
+
+            size_t nUsed = 0;
+            szPath[0] = '\0';
+            for(int32_t nPath = 0; nPath <= nIdx && nUsed < sizeof(szPath); nPath++) {
+                nUsed += snprintf(szPath + nUsed, sizeof(szPath) - nUsed, "%s%s %0.3lf ms",
+                                  nPath == 0 ? "" : " > ", scopes[nPath].szName,
+                                  (double)(nNow - scopes[nPath].nStartTime) / 1000.0);
+            }
+            LOG(eWarning, "Stall on thread %X %s: %s open for %0.3lf ms (%s %0.3lf ms), open path: %s\n",
+                (uint32_t)it->idThread, it->szThreadName, scope.szName, (double)nOpenUS / 1000.0,
+                bThreshold ? "threshold" : "watchdog limit",
+                (double)(bThreshold ? (uint64_t)scope.nThresholdUS : s_nLimitUS) / 1000.0, szPath);
+            break;
+        }
+    }
+
+    // Forget scopes that closed, a stack address may be reused by a new thread
+    s_reported.swap(stillOpen);
+}
@@ -0,0 +1,166 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef __RDK_PERF_WATCHDOG_H__
+#define __RDK_PERF_WATCHDOG_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <atomic>
+
+#define WATCHDOG_DEPTH          32      // Open scopes visible per thread
+#define WATCHDOG_NAME           40
+#define WATCHDOG_THREAD_NAME    16      // Including the terminator, as for prctl(PR_GET_NAME)
+#define WATCHDOG_PERIOD_MS      1000
+#define WATCHDOG_NONE_CLOSED    UINT64_MAX
+
+typedef struct _OpenScope
+{
+    uint64_t            nID;            // Unique per thread
+    uint64_t            nStartTime;     // Wall clock in us
+    int32_t             nThresholdUS;
+    char                szName[WATCHDOG_NAME];
+} OpenScope;
+
+// Copy of the open scopes of one thread that the watchdog can read without
+// taking the global lock.  Only the owning thread writes, readers retry
+// when the sequence number changed while they copied.  A scope closed by
+// another thread is only marked, the owner drops it on its next push or pop.
+class PerfThreadStack
+{
+public:
+    PerfThreadStack();
+    ~PerfThreadStack();
+
+    inline uint32_t Push(const char* szName, uint64_t nStartTime)
+    {
+        DropClosed();
+        uint32_t nDepth = m_nDepth.load(std::memory_order_relaxed);
+        if(nDepth < WATCHDOG_DEPTH) {
+            BeginWrite();
+            OpenScope& scope = m_scopes[nDepth];
+            scope.nID           = ++m_nNextID;
+            scope.nStartTime    = nStartTime;
+            scope.nThresholdUS  = -1;
+            strncpy(scope.szName, szName, WATCHDOG_NAME - 1);
+            scope.szName[WATCHDOG_NAME - 1] = '\0';
+            m_nDepth.store(nDepth + 1, std::memory_order_relaxed);
+            EndWrite();
+        }
+        else {
+            m_nDepth.store(nDepth + 1, std::memory_order_relaxed);
+        }
+        return nDepth;
+    };
+    inline void SetThreshold(uint32_t nDepth, int32_t nThresholdUS)
+    {
+        if(nDepth < WATCHDOG_DEPTH) {
+            BeginWrite();
+            m_scopes[nDepth].nThresholdUS = nThresholdUS;
+            EndWrite();
+        }
+    };
+    // Scopes closed out of order also close the scopes opened after them
+    inline void Pop(uint32_t nDepth)
+    {
+        DropClosed();
+        Truncate(nDepth);
+    };
+    // 0 for scopes too deep to be visible
+    inline uint64_t GetID(uint32_t nDepth)
+    {
+        return (nDepth < WATCHDOG_DEPTH) ? m_scopes[nDepth].nID : 0;
+    };
+    // Called by the thread that closed one of this thread's scopes
+    inline void MarkClosed(uint64_t nID)
+    {
+        uint64_t nClosed = m_nClosedID.load(std::memory_order_relaxed);
+        while(nID < nClosed && !m_nClosedID.compare_exchange_weak(nClosed, nID, std::memory_order_relaxed)) {
+        }
+    };
+
+    // Returns the number of scopes copied, 0 when the thread was too busy
+    uint32_t Read(OpenScope* pScopes);
+    pthread_t GetThreadID() { return m_idThread; };
+    // Name of the thread when it opened its first scope, read by the owner
+    // itself, so it stays valid after the thread exits
+    const char* GetThreadName() { return m_szThreadName; };
+
+private:
+    inline void Truncate(uint32_t nDepth)
+    {
+        if(nDepth < m_nDepth.load(std::memory_order_relaxed)) {
+            BeginWrite();
+            m_nDepth.store(nDepth, std::memory_order_relaxed);
+            EndWrite();
+        }
+    };
+    // IDs grow with the depth, the oldest marked scope closes all after it
+    inline void DropClosed()
+    {
+        if(m_nClosedID.load(std::memory_order_relaxed) == WATCHDOG_NONE_CLOSED) {
+            return;
+        }
+        uint64_t nClosed = m_nClosedID.exchange(WATCHDOG_NONE_CLOSED, std::memory_order_relaxed);
+        uint32_t nDepth  = m_nDepth.load(std::memory_order_relaxed);
+        for(uint32_t nIdx = 0; nIdx < nDepth && nIdx < WATCHDOG_DEPTH; nIdx++) {
+            if(m_scopes[nIdx].nID >= nClosed) {
+                Truncate(nIdx);
+                break;
+            }
+        }
+    };
+    inline void BeginWrite()
+    {
+        m_nSequence.store(m_nSequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    };
+    inline void EndWrite()
+    {
+        m_nSequence.store(m_nSequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    };
+
+    pthread_t               m_idThread;
+    char                    m_szThreadName[WATCHDOG_THREAD_NAME];
+    std::atomic<uint32_t>   m_nSequence;    // Odd while the owner writes
+    std::atomic<uint32_t>   m_nDepth;
+    std::atomic<uint64_t>   m_nClosedID;    // Oldest scope closed by another thread
+    uint64_t                m_nNextID;
+    OpenScope               m_scopes[WATCHDOG_DEPTH];
+};
+
+// Scans the open scopes of all threads every second and reports scopes that
+// are open longer than their threshold, or than RDKPERF_WATCHDOG_MS for all
+// scopes.  Started with the first threshold or when RDKPERF_WATCHDOG_MS is set.
+class PerfWatchdog
+{
+public:
+    static PerfThreadStack* ForThread();
+    // Marks a scope closed on another thread than the one that opened it
+    static void CloseScope(PerfThreadStack* pStack, pthread_t idThread, uint64_t nID);
+    static void Start();
+    static void Scan();
+
+private:
+    static void* WatchdogThread(void* pArg);
+};
+
+#endif // __RDK_PERF_WATCHDOG_H__
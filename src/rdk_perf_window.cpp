@@ -0,0 +1,165 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+
+#include "rdk_perf_window.h"
+
+static inline uint32_t HistBucket(uint64_t nValue)
+{
+    if(nValue == 0) return 0;
+    uint32_t nBucket = 64 - __builtin_clzll(nValue);
+    return std::min(nBucket, (uint32_t)(WINDOW_HIST_BUCKETS - 1));
+}
+
+static inline uint64_t HistUpperBound(uint32_t nBucket)
+{
+    return (1ULL << nBucket) - 1;
+}
+
+PerfWindow::PerfWindow()
+{
+    memset((void*)m_seconds, 0, sizeof(m_seconds));
+    memset((void*)m_tens, 0, sizeof(m_tens));
+    return;
+}
+
+uint32_t PerfWindow::Now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return (uint32_t)ts.tv_sec;
+}
+
+void PerfWindow::AddToBucket(WindowBucket* pBucket, uint32_t nStamp, uint64_t nElapsedUS)
+{
+    if(pBucket->nStamp != nStamp) {
+        // Left over from an earlier lap of the ring
+        memset((void*)pBucket, 0, sizeof(WindowBucket));
+        pBucket->nStamp = nStamp;
+    }
+    pBucket->nTime += nElapsedUS;
+    pBucket->nCount++;
+    pBucket->nMax = std::max(pBucket->nMax, (uint32_t)std::min(nElapsedUS, (uint64_t)UINT32_MAX));
+    pBucket->hist[HistBucket(nElapsedUS)]++;
+}
+
+void PerfWindow::Add(uint64_t nElapsedUS, uint32_t nNow)
+{
+    AddToBucket(&m_seconds[nNow % (WINDOW_SECONDS + 1)], nNow, nElapsedUS);
+    AddToBucket(&m_tens[(nNow / 10) % (WINDOW_TENS + 1)], nNow / 10, nElapsedUS);
+    return;
+}
+
+void PerfWindow::MergeBucket(WindowBucket* pBucket, const WindowBucket* pOther)
+{
+    if(pOther->nCount == 0 || pOther->nStamp < pBucket->nStamp) {
+        return;
+    }
+    if(pOther->nStamp > pBucket->nStamp) {
+        *pBucket = *pOther;
+        return;
+    }
+    pBucket->nTime  += pOther->nTime;
+    pBucket->nCount += pOther->nCount;
+    pBucket->nMax    = std::max(pBucket->nMax, pOther->nMax);
+    for(uint32_t nIdx = 0; nIdx < WINDOW_HIST_BUCKETS; nIdx++) {
+        pBucket->hist[nIdx] += pOther->hist[nIdx];
+    }
+}
+
+void PerfWindow::Merge(const PerfWindow& other)
+{
+    for(uint32_t nIdx = 0; nIdx <= WINDOW_SECONDS; nIdx++) {
+        MergeBucket(&m_seconds[nIdx], &other.m_seconds[nIdx]);
+    }
+    for(uint32_t nIdx = 0; nIdx <= WINDOW_TENS; nIdx++) {
+        MergeBucket(&m_tens[nIdx], &other.m_tens[nIdx]);
+    }
+    return;
+}
+
+void PerfWindow::Get(uint32_t nSeconds, uint32_t nNow, WindowStats* pStats, bool bCurrent) const
+{
+    uint64_t hist[WINDOW_HIST_BUCKETS] = { 0 };
+    const WindowBucket* pRing;
+    uint32_t nRingSize;
+    uint32_t nBuckets;
+    uint32_t nCurrent;
+
+    memset((void*)pStats, 0, sizeof(WindowStats));
+    nSeconds = std::max(nSeconds, (uint32_t)1);
+    if(nSeconds <= WINDOW_SECONDS) {
+        pRing     = m_seconds;
+        nRingSize = WINDOW_SECONDS + 1;
+        nBuckets  = nSeconds;
+        nCurrent  = nNow;
+        pStats->nSeconds = nSeconds;
+    }
+    else {
+        pRing     = m_tens;
+        nRingSize = WINDOW_TENS + 1;
+        nBuckets  = std::min((nSeconds + 9) / 10, (uint32_t)WINDOW_TENS);
+        nCurrent  = nNow / 10;
+        pStats->nSeconds = nBuckets * 10;
+    }
+
+    // The complete buckets before the one in progress, and that one when asked
+    for(uint32_t nBack = bCurrent ? 0 : 1; nBack <= nBuckets && nBack <= nCurrent; nBack++) {
+        uint32_t nStamp = nCurrent - nBack;
+        const WindowBucket* pBucket = &pRing[nStamp % nRingSize];
+        if(pBucket->nStamp != nStamp || pBucket->nCount == 0) {
+            continue;
+        }
+        pStats->nCount += pBucket->nCount;
+        pStats->nTime  += pBucket->nTime;
+        pStats->nMax    = std::max(pStats->nMax, (uint64_t)pBucket->nMax);
+        for(uint32_t nIdx = 0; nIdx < WINDOW_HIST_BUCKETS; nIdx++) {
+            hist[nIdx] += pBucket->hist[nIdx];
+        }
+    }
+
+    if(pStats->nCount == 0) {
+        return;
+    }
+    pStats->nAvg  = (double)pStats->nTime / (double)pStats->nCount;
+    pStats->nRate = (double)pStats->nCount / (double)pStats->nSeconds;
+
+    const double percentiles[] = { 50.0, 90.0, 99.0 };
+    uint64_t* pResults[] = { &pStats->nP50, &pStats->nP90, &pStats->nP99 };
+    for(uint32_t nPct = 0; nPct < 3; nPct++) {
+        uint64_t nTarget = (uint64_t)((percentiles[nPct] / 100.0) * (double)pStats->nCount + 0.5);
+        uint64_t nSeen   = 0;
+        uint32_t nIdx    = 0;
+        if(nTarget == 0) nTarget = 1;
+        while(nIdx < WINDOW_HIST_BUCKETS - 1) {
+            nSeen += hist[nIdx];
+            if(nSeen >= nTarget) break;
+            nIdx++;
+        }
+        *pResults[nPct] = std::min(HistUpperBound(nIdx), pStats->nMax);
+    }
+
+    return;
+}
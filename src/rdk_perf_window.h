@@ -0,0 +1,85 @@
+/**
+* Copyright 2026 Comcast Cable Communications Management, LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+
+#ifndef __RDK_PERF_WINDOW_H__
+#define __RDK_PERF_WINDOW_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define WINDOW_HIST_BUCKETS 24      // Powers of two, the last one holds 4 s and above
+#define WINDOW_SECONDS      10      // 1 s buckets, windows of 1 to 10 s
+#define WINDOW_TENS         6       // 10 s buckets, windows of 20 to 60 s
+#define WINDOW_MAX_SECONDS  (WINDOW_TENS * 10)
+
+// Calls of one second, or of ten seconds, of a monotonic clock
+typedef struct _WindowBucket
+{
+    uint64_t            nTime;
+    uint32_t            nStamp;     // Second, or tenth second, the bucket holds
+    uint32_t            nCount;
+    uint32_t            nMax;
+    uint32_t            hist[WINDOW_HIST_BUCKETS];
+} WindowBucket;
+
+typedef struct _WindowStats
+{
+    uint32_t            nSeconds;   // Length of the window, rounded up to 10 s above 10 s
+    uint64_t            nCount;
+    uint64_t            nTime;
+    uint64_t            nMax;
+    double              nAvg;
+    double              nRate;      // Calls per second
+    uint64_t            nP50;       // Upper bound of the histogram bucket, at most nMax
+    uint64_t            nP90;
+    uint64_t            nP99;
+} WindowStats;
+
+// Rolling windows of the last 1 to 60 seconds.  Calls are added to a ring
+// of 1 s buckets and a ring of 10 s buckets, each stamped with the second it
+// holds, so a stale bucket is recognized by its stamp and nothing has to be
+// cleared or reset by a reader.  A window only covers complete seconds, the
+// one in progress is left out so that the same query gives the same answer
+// for a whole second.  Must be used with the lock held.
+class PerfWindow
+{
+public:
+    PerfWindow();
+
+    // Seconds of CLOCK_MONOTONIC_COARSE
+    static uint32_t Now();
+
+    void Add(uint64_t nElapsedUS, uint32_t nNow);
+    // Adds the buckets of another window, used when trees are merged
+    void Merge(const PerfWindow& other);
+    // bCurrent adds the second in progress, for a caller that needs the
+    // calls it just made, e.g. a threshold breach
+    void Get(uint32_t nSeconds, uint32_t nNow, WindowStats* pStats, bool bCurrent = false) const;
+
+private:
+    static void AddToBucket(WindowBucket* pBucket, uint32_t nStamp, uint64_t nElapsedUS);
+    static void MergeBucket(WindowBucket* pBucket, const WindowBucket* pOther);
+
+    // One more bucket than the window, the one in progress
+    WindowBucket        m_seconds[WINDOW_SECONDS + 1];
+    WindowBucket        m_tens[WINDOW_TENS + 1];
+};
+
+#endif // __RDK_PERF_WINDOW_H__
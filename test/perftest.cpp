@@ -32,6 +32,7 @@
 // Uint Tests prototype
 void unit_tests();
 void unit_tests_c();
+int autoinstr_child(int argc, char* argv[]);
 
 uint32_t Func3(uint32_t nCount)
 {
@@ -116,6 +117,10 @@ void test_inline()
 
 int main(int argc, char *argv[])
 {    
+    if(argc > 1 && strcmp(argv[1], "--autoinstr") == 0) {
+        return autoinstr_child(argc, argv);
+    }
+
     LOG(eWarning, "Enter test app %s\n", __DATE__);
 
     pid_t child_pid;
@@ -23,11 +23,40 @@
 #include <stdint.h>
 #include <errno.h>
 #include <sys/time.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <dirent.h>
+#include <sched.h>
+#include <dlfcn.h>
+
+#include <set>
+#include <vector>
+#include <atomic>
 
 #include "rdk_perf.h"
 #include "rdk_perf_logging.h"
+#include "rdk_perf_eventlog.h"
+#include "rdk_perf_process.h"
+#include "rdk_perf_async.h"
+#include "rdk_perf_ftrace.h"
+#include "rdk_perf_flightrec.h"
+#include "rdk_perf_breach.h"
+#include "rdk_perf_config.h"
+#include "rdk_perf_scopedlock.h"
+#include "rdk_perf_system.h"
+#include "rdk_perf_tree.h"
+#include "rdk_perf_node.h"
+#include "rdk_perf_record.h"
+#include "rdk_perf_window.h"
+#include "rdk_perf_history.h"
+#include "rdk_perf_watchdog.h"
+#include "rdk_perf_hwcounters.h"
+#include "rdk_perf_control.h"
+#include "rdk_perf_symbols.h"
+#include "rdk_perf_sched.h"
 
 
 void timer_sleep(uint32_t timeMS)
@@ -106,10 +135,1222 @@ void record_with_threshold(uint32_t timeMS)
     return;    
 }
 
+void record_and_replay(uint32_t nIterations)
+{
+    const char*     szFileName  = "/tmp/rdkperf_unit_test.evt";
+    const pid_t     pID         = 0x7FFF0001;  // Not a live process
+    const pthread_t tID         = (pthread_t)1;
+    uint64_t        nTimeStamp  = PerfRecord::TimeStamp();
+
+    PerfEventLog* pLog = new PerfEventLog(szFileName);
+    for(uint32_t nIdx = 0; nIdx < nIterations; nIdx++) {
+        pLog->RecordEntry(pID, tID, "replay_thread", "outer", nTimeStamp, -1);
+        pLog->RecordEntry(pID, tID, "replay_thread", "inner", nTimeStamp + 10, 5000);
+        pLog->RecordExit(pID, tID, "inner", 100 + nIdx);
+        pLog->RecordExit(pID, tID, "outer", 250 + nIdx);
+        nTimeStamp += 1000;
+    }
+    delete pLog;
+
+    std::set<pid_t> processes;
+    uint64_t nEvents = PerfEventLog::Replay(szFileName, &processes);
+    LOG(eWarning, "UNIT_TEST (expected %u events, 1 process): %s replayed %llu events, %u processes\n",
+        nIterations * 4, __FUNCTION__, nEvents, (uint32_t)processes.size());
+
+    PerfProcess* pProcess = RDKPerf_FindProcess(pID);
+    if(pProcess != NULL) {
+        pProcess->ReportData();
+        RDKPerf_RemoveProcess(pID);
+    }
+    unlink(szFileName);
+
+    return;
+}
+
+static void* async_end_thread(void* pContext)
+{
+    PerfAsyncSpans* pSpans = (PerfAsyncSpans*)pContext;
+
+    for(uint64_t nID = 0; nID < 100; nID++) {
+        usleep(100);
+        pSpans->End(nID, PerfRecord::TimeStamp());
+    }
+
+    return NULL;
+}
+
+void async_spans(uint32_t nSpans)
+{
+    const pid_t     pID     = 0x7FFF0002;  // Not a live process
+    pthread_t       tID;
+
+    PerfAsyncSpans* pSpans = PerfAsyncSpans::GetSpans(pID, true);
+    for(uint64_t nID = 0; nID < nSpans; nID++) {
+        pSpans->Begin("buffer_latency", nID, pthread_self(), PerfRecord::TimeStamp());
+    }
+
+    // End every span on a different thread than the one that began it
+    pthread_create(&tID, NULL, async_end_thread, pSpans);
+    pthread_join(tID, NULL);
+
+    LOG(eWarning, "UNIT_TEST (expected %u open): %s %u spans open after the end thread\n",
+        nSpans > 100 ? nSpans - 100 : 0, __FUNCTION__, (uint32_t)pSpans->GetOpenCount());
+    pSpans->ReportData();
+    PerfAsyncSpans::RemoveSpans(pID);
+
+    // Public API, reported with the process
+    RDKPerfAsyncBegin(__FUNCTION__, 1);
+    usleep(1000);
+    RDKPerfAsyncEnd(1);
+
+    return;
+}
+
+void record_with_metrics(uint32_t nIterations)
+{
+    RDKPerfMetricHandle hDepth = RDKPerfGetMetric("queue_depth", RDKPerfGauge);
+
+    for(uint32_t nIdx = 0; nIdx < nIterations; nIdx++) {
+        RDKPerf perf (__FUNCTION__);
+
+        perf.GetMetric("bytes", eMetricCounter)->Add(1024);
+        perf.GetMetric("frame_size", eMetricDistribution)->Record(100 + nIdx);
+        RDKPerfMetricSet(hDepth, nIdx % 8);
+    }
+
+    LOG(eWarning, "UNIT_TEST (expected bytes Total %u, queue_depth Min 0 Max 7): %s see process report\n",
+        nIterations * 1024, __FUNCTION__);
+    RDKPerf_ReportProcess(getpid());
+
+    return;
+}
+
+void cadence_with_drops(uint32_t nFrames)
+{
+    // 200 Hz, every 10th frame is skipped
+    RDKPerfCadence cadence(__FUNCTION__, 5000);
+
+    for(uint32_t nIdx = 0; nIdx < nFrames; nIdx++) {
+        usleep(5000);
+        if(nIdx % 10 != 9) {
+            cadence.Tick();
+        }
+    }
+
+    LOG(eWarning, "UNIT_TEST (expected missed %u): %s see process report\n",
+        nFrames / 10 - 1, __FUNCTION__);
+    RDKPerf_ReportProcess(getpid());
+
+    return;
+}
+
+typedef struct _LockTestData
+{
+    RDKPerfMutex*   pMutex;
+    RDKPerfCondVar* pReady;
+    uint32_t        nIterations;
+    uint32_t        nProduced;
+} LockTestData;
+
+static void* lock_producer_thread(void* pData)
+{
+    LockTestData* pTest = (LockTestData*)pData;
+
+    for(uint32_t nIdx = 0; nIdx < pTest->nIterations; nIdx++) {
+        RDKPerf perf ("lock_producer");
+        std::lock_guard<RDKPerfMutex> lock(*pTest->pMutex);
+        pTest->nProduced++;
+        usleep(500);    // Hold the lock so the consumer has to wait
+        pTest->pReady->notify_one();
+    }
+
+    return NULL;
+}
+
+void locks_with_contention(uint32_t nIterations)
+{
+    RDKPerfMutex    mutex("unit_test_queue");
+    RDKPerfCondVar  ready("unit_test_ready");
+    LockTestData    test = { &mutex, &ready, nIterations, 0 };
+    pthread_t       tID[2];
+
+    // Two producers holding the lock contend with each other
+    pthread_create(&tID[0], NULL, lock_producer_thread, &test);
+    pthread_create(&tID[1], NULL, lock_producer_thread, &test);
+    {
+        RDKPerf perf (__FUNCTION__);
+        std::unique_lock<RDKPerfMutex> lock(mutex);
+        ready.wait(lock, [&test] { return test.nProduced == 2 * test.nIterations; });
+    }
+    pthread_join(tID[0], NULL);
+    pthread_join(tID[1], NULL);
+
+    LOG(eWarning, "UNIT_TEST (expected Acquired >= %u, Contended > 0, waited in lock_producer): %s see process report\n",
+        2 * nIterations + 1, __FUNCTION__);
+    RDKPerf_ReportProcess(getpid());
+
+    return;
+}
+
+void ftrace_markers(uint32_t nIterations)
+{
+    RDKPerfSetFTrace(1);
+    for(uint32_t nIdx = 0; nIdx < nIterations; nIdx++) {
+        RDKPerf perf (__FUNCTION__);
+        usleep(100);
+    }
+
+    LOG(eWarning, "UNIT_TEST (expected enabled when trace_marker is writable): %s ftrace %s\n",
+        __FUNCTION__, PerfFTrace::IsEnabled() ? "enabled" : "disabled");
+    RDKPerfSetFTrace(0);
+
+    return;
+}
+
+void slowest_invocations(uint32_t nIterations)
+{
+    for(uint32_t nIdx = 0; nIdx < nIterations; nIdx++) {
+        RDKPerf perf (__FUNCTION__);
+        {
+            RDKPerf child ("fast_child");
+            usleep(100);
+        }
+        if(nIdx % 5 == 4) {
+            // Outliers, the slow child should show up in the report
+            RDKPerf child ("slow_child");
+            usleep(5000);
+        }
+    }
+
+    LOG(eWarning, "UNIT_TEST (expected %u slow entries with slow_child 1x ~5 ms): %s see thread report\n",
+        nIterations / 5 < SLOWEST_COUNT ? nIterations / 5 : SLOWEST_COUNT, __FUNCTION__);
+    RDKPerf_ReportThread(pthread_self());
+
+    return;
+}
+
+void flight_recorder(uint32_t nEvents)
+{
+    PerfFlightRecorder::Enable(true);
+    for(uint32_t nIdx = 0; nIdx < nEvents; nIdx++) {
+        RDKPerf perf ("flight_event");
+    }
+    {
+        RDKPerf perf (__FUNCTION__, 1000);
+        usleep(5000);
+    }
+    // Written by the flight recorder thread
+    usleep(100000);
+
+    LOG(eWarning, "UNIT_TEST (expected dump with %u events ending in BREACH %s): %s see /tmp/rdkperf_flight_%d_0.txt\n",
+        FLIGHT_RECORDER_EVENTS, __FUNCTION__, __FUNCTION__, (int)getpid());
+
+    // A breach on every call reuses the same few files
+    for(uint32_t nIdx = 0; nIdx < FLIGHT_DUMP_FILES + 2; nIdx++) {
+        {
+            RDKPerf perf (__FUNCTION__, 1000);
+            usleep(5000);
+        }
+        usleep((FLIGHT_DUMP_INTERVAL_MS + 10) * 1000);
+    }
+    char szPath[64];
+    uint32_t nFiles = 0;
+    for(uint32_t nIdx = 0; nIdx < FLIGHT_DUMP_FILES + 2; nIdx++) {
+        snprintf(szPath, sizeof(szPath), "/tmp/rdkperf_flight_%d_%u.txt", (int)getpid(), nIdx);
+        if(access(szPath, F_OK) == 0) {
+            nFiles++;
+        }
+    }
+    LOG(eWarning, "UNIT_TEST (expected %u files after %u dumps): %s %u files\n",
+        FLIGHT_DUMP_FILES, FLIGHT_DUMP_FILES + 3, __FUNCTION__, nFiles);
+    PerfFlightRecorder::Enable(false);
+
+    return;
+}
+
+void breaches_rate_limited(uint32_t nIterations)
+{
+    for(uint32_t nIdx = 0; nIdx < nIterations; nIdx++) {
+        // Every call breaches, only the first one is reported in detail
+        RDKPerf perf (__FUNCTION__, 100);
+        usleep(200);
+    }
+    PerfBreachQueue::Flush();
+
+    LOG(eWarning, "UNIT_TEST (expected 1 detailed report, breached %u times): %s see above\n",
+        nIterations, __FUNCTION__);
+
+    return;
+}
+
+void stall_watchdog(uint32_t timeMS)
+{
+    RDKPerf outer (__FUNCTION__);
+    {
+        // Still open when the watchdog scans
+        RDKPerf stalled ("stalled_call", (timeMS / 4) * 1000);
+        usleep(timeMS * 1000);
+    }
+
+    LOG(eWarning, "UNIT_TEST (expected one Stall report for stalled_call, path %s > stalled_call): %s see above\n",
+        __FUNCTION__, __FUNCTION__);
+
+    return;
+}
+
+void runtime_control(uint32_t nIterations)
+{
+    RDKPerf outer (__FUNCTION__);
+
+    RDKPerfSetNameEnabled("control_off*", 0);
+    for(uint32_t nIdx = 0; nIdx < nIterations; nIdx++) {
+        RDKPerf on ("control_on");
+        RDKPerf off ("control_off_by_prefix");
+    }
+    RDKPerfSetNameEnabled("control_off*", 1);
+
+    // Cost of a scope while everything is disabled
+    RDKPerfSetEnabled(0);
+    uint64_t nStartTime = PerfRecord::TimeStamp();
+    for(uint32_t nIdx = 0; nIdx < nIterations; nIdx++) {
+        RDKPerf off ("control_off_global");
+    }
+    uint64_t nElapsed = PerfRecord::TimeStamp() - nStartTime;
+    RDKPerfSetEnabled(1);
+
+    LOG(eWarning, "UNIT_TEST (expected control_on %u calls, no control_off nodes): %s disabled scope %0.1lf ns\n",
+        nIterations, __FUNCTION__, ((double)nElapsed * 1000.0) / (double)nIterations);
+    RDKPerf_ReportThread(pthread_self());
+
+    return;
+}
+
+void control_dead_writer()
+{
+    const char* szName = getenv(RDK_PERF_CONTROL_ENV);
+    if(szName == NULL || szName[0] == '\0') {
+        szName = RDK_PERF_CONTROL_NAME;
+    }
+    int fd = PerfControl::IsShared() ? shm_open(szName, O_RDWR, 0) : -1;
+    PerfControlBlock* pBlock = (fd >= 0) ? (PerfControlBlock*)mmap(NULL, sizeof(PerfControlBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : NULL;
+    if(fd >= 0) {
+        close(fd);
+    }
+    if(pBlock == NULL || pBlock == MAP_FAILED) {
+        LOG(eWarning, "UNIT_TEST (skipped, no shared control block): %s\n", __FUNCTION__);
+        return;
+    }
+
+    // A writer that was killed in the middle of a change
+    pid_t idChild = fork();
+    if(idChild == 0) {
+        _exit(0);
+    }
+    waitpid(idChild, NULL, 0);
+    pBlock->nWriter.store((int32_t)idChild);
+    pBlock->nSequence.fetch_add(1);
+
+    int nResult = RDKPerfSetNameEnabled("control_dead_writer", 0);
+    RDKPerfSetNameEnabled("control_dead_writer", 1);
+    LOG(eWarning, "UNIT_TEST (expected result 0, unlocked, sequence even): %s result %d, %s, sequence %s\n",
+        __FUNCTION__, nResult, pBlock->nWriter.load() == 0 ? "unlocked" : "locked",
+        (pBlock->nSequence.load() & 1) == 0 ? "even" : "odd");
+    munmap(pBlock, sizeof(PerfControlBlock));
+
+    return;
+}
+
+static void write_config(const char* szFileName, const char* szContents)
+{
+    // Written next to the file and renamed, like an editor would
+    char szTemp[256];
+    snprintf(szTemp, sizeof(szTemp), "%s.tmp", szFileName);
+    FILE* fp = fopen(szTemp, "w");
+    if(fp != NULL) {
+        fputs(szContents, fp);
+        fclose(fp);
+        rename(szTemp, szFileName);
+    }
+}
+
+void config_reload(uint32_t nIterations)
+{
+    char szFileName[64];
+    snprintf(szFileName, sizeof(szFileName), "/tmp/rdkperf_test_%d.conf", (int)getpid());
+
+    write_config(szFileName, "# unit test\nsample config_sampled 10\ndisable config_disabled\n");
+    PerfConfig::Load(szFileName);
+    PerfConfig::Watch(szFileName);
+    bool bSecond = PerfConfig::Watch("/tmp/rdkperf_test_other.conf");
+    {
+        RDKPerf outer (__FUNCTION__);
+        for(uint32_t nIdx = 0; nIdx < nIterations; nIdx++) {
+            RDKPerf sampled ("config_sampled");
+            RDKPerf disabled ("config_disabled");
+        }
+    }
+
+    // Picked up by the watch thread
+    write_config(szFileName, "threshold config_threshold 1000\n");
+    usleep(100000);
+    {
+        RDKPerf perf ("config_threshold", 1000000);
+        usleep(5000);
+    }
+    PerfBreachQueue::Flush();
+
+    write_config(szFileName, "\n");
+    usleep(100000);
+    unlink(szFileName);
+
+    LOG(eWarning, "UNIT_TEST (expected config_sampled %u calls sampled 1 in 10, no config_disabled node, config_threshold breach of 1 ms, second watch refused): %s second watch %s, see above\n",
+        nIterations / 10, __FUNCTION__, bSecond ? "accepted" : "refused");
+    RDKPerf_ReportThread(pthread_self());
+
+    return;
+}
+
+void report_schedules()
+{
+    PerfReportScheduler scheduler;
+    ReportSchedule      schedule;
+
+    PerfReportScheduler::Default(&schedule);
+    scheduler.SetSchedule(schedule, 1000);
+    time_t nFirst = scheduler.NextReport();
+    scheduler.Reported(nFirst, 0);
+    time_t nSecond = scheduler.NextReport();
+    scheduler.Reported(nSecond, 0);
+    LOG(eWarning, "UNIT_TEST (expected back off 10, 60, 110): %s back off %d, %d, %d\n", __FUNCTION__,
+        (int)(nFirst - 1000), (int)(nSecond - nFirst), (int)(scheduler.NextReport() - nSecond));
+
+    const char* szFixed[] = { "30" };
+    PerfReportScheduler::Parse(&schedule, "fixed", szFixed, 1);
+    schedule.nCPUBudget = 1;
+    scheduler.SetSchedule(schedule, 1000);
+    scheduler.Reported(1030, 500000);
+    LOG(eWarning, "UNIT_TEST (expected next report in 50 s for 500 ms CPU at 1%%): %s fixed with budget %d s\n",
+        __FUNCTION__, (int)(scheduler.NextReport() - 1030));
+
+    const char* szCron[] = { "*/15", "*" };
+    bool bParsed = PerfReportScheduler::Parse(&schedule, "cron", szCron, 2);
+    scheduler.SetSchedule(schedule, time(NULL));
+    struct tm local;
+    time_t nNext = scheduler.NextReport();
+    localtime_r(&nNext, &local);
+    LOG(eWarning, "UNIT_TEST (expected parsed, minute 0, 15, 30 or 45): %s cron parsed %d, next at minute %d\n",
+        __FUNCTION__, bParsed, local.tm_min);
+
+    RDKPerfReportNow();
+    usleep(200000);
+    LOG(eWarning, "UNIT_TEST (expected a process report from the report thread above): %s\n", __FUNCTION__);
+
+    return;
+}
+
+void lazy_start()
+{
+    // The report thread was started by the first scope of this process, once
+    uint32_t nReportThreads = 0;
+    DIR* pDir = opendir("/proc/self/task");
+    struct dirent* pEntry;
+    while(pDir != NULL && (pEntry = readdir(pDir)) != NULL) {
+        char szPath[sizeof(pEntry->d_name) + 32];
+        char szName[32] = { 0 };
+        snprintf(szPath, sizeof(szPath), "/proc/self/task/%s/comm", pEntry->d_name);
+        FILE* fp = fopen(szPath, "r");
+        if(fp != NULL) {
+            if(fgets(szName, sizeof(szName), fp) != NULL && strncmp(szName, "rdkperf_report", 14) == 0) {
+                nReportThreads++;
+            }
+            fclose(fp);
+        }
+    }
+    if(pDir != NULL) closedir(pDir);
+
+#ifdef PERF_REMOTE
+    LOG(eWarning, "UNIT_TEST (expected 0 report threads in remote mode): %s %u report threads\n", __FUNCTION__, nReportThreads);
+#else
+    LOG(eWarning, "UNIT_TEST (expected 1 report thread): %s %u report threads\n", __FUNCTION__, nReportThreads);
+#endif
+
+    return;
+}
+
+static void* exiting_worker_thread(void* pData)
+{
+    pthread_setname_np(pthread_self(), "ut_worker");
+    {
+        RDKPerf perf ("worker_job");
+        usleep(100);
+    }
+    return NULL;
+}
+
+void thread_exit_cleanup(uint32_t nThreads)
+{
+    // A pool that churns threads, each one gone before the next report
+    uint32_t nLeft = 0;
+    for(uint32_t nIdx = 0; nIdx < nThreads; nIdx++) {
+        pthread_t tID;
+        pthread_create(&tID, NULL, exiting_worker_thread, NULL);
+        pthread_join(tID, NULL);
+
+        SCOPED_LOCK();
+        PerfProcess* pProcess = RDKPerf_FindProcess(getpid());
+        if(pProcess != NULL && pProcess->FindTree(tID) != NULL) {
+            nLeft++;
+        }
+    }
+
+    LOG(eWarning, "UNIT_TEST (expected 0 trees left, worker_job count %u under %u exited threads named ut_worker): %s %u trees left\n",
+        nThreads, nThreads, __FUNCTION__, nLeft);
+    RDKPerf_ReportProcess(getpid());
+
+    return;
+}
+
+typedef struct _GroupedThread
+{
+    pthread_barrier_t*  pBarrier;
+    const char*         szName;
+} GroupedThread;
+
+static void* grouped_thread(void* pData)
+{
+    GroupedThread* pThread = (GroupedThread*)pData;
+
+    // Named before the first scope, the tree takes the name when it is created
+    pthread_setname_np(pthread_self(), pThread->szName);
+    {
+        RDKPerf perf ("group_job");
+        usleep(100);
+    }
+    // Stay alive until the process report is done
+    pthread_barrier_wait(pThread->pBarrier);
+    pthread_barrier_wait(pThread->pBarrier);
+    return NULL;
+}
+
+void thread_groups()
+{
+    const char*         szNames[] = { "ut_pool1", "ut_pool2", "ut_pool3", "ut_rx7", "ut_rx12" };
+    const uint32_t      nThreads = sizeof(szNames) / sizeof(szNames[0]);
+    pthread_t           tID[nThreads];
+    GroupedThread       threads[nThreads];
+    pthread_barrier_t   barrier;
+    char                szFileName[64];
+
+    snprintf(szFileName, sizeof(szFileName), "/tmp/rdkperf_group_%d.conf", (int)getpid());
+    write_config(szFileName, "thread_group ut_pool ut_pool*\nthread_group ut_rx ~^ut_rx[0-9]+$\n");
+    PerfConfig::Load(szFileName);
+
+    pthread_barrier_init(&barrier, NULL, nThreads + 1);
+    for(uint32_t nIdx = 0; nIdx < nThreads; nIdx++) {
+        threads[nIdx].pBarrier  = &barrier;
+        threads[nIdx].szName    = szNames[nIdx];
+        pthread_create(&tID[nIdx], NULL, grouped_thread, &threads[nIdx]);
+    }
+    pthread_barrier_wait(&barrier);
+
+    LOG(eWarning, "UNIT_TEST (expected 3 threads in group ut_pool and 2 in group ut_rx, group_job counts 3 and 2): %s see process report\n",
+        __FUNCTION__);
+    RDKPerf_ReportProcess(getpid());
+
+    pthread_barrier_wait(&barrier);
+    for(uint32_t nIdx = 0; nIdx < nThreads; nIdx++) {
+        pthread_join(tID[nIdx], NULL);
+    }
+    pthread_barrier_destroy(&barrier);
+
+    write_config(szFileName, "\n");
+    PerfConfig::Load(szFileName);
+    unlink(szFileName);
+
+    return;
+}
+
+typedef struct _ViewThread
+{
+    pthread_barrier_t*  pBarrier;
+    uint32_t            nWorkUS;
+} ViewThread;
+
+static void* view_worker_thread(void* pData)
+{
+    ViewThread* pThread = (ViewThread*)pData;
+
+    pthread_setname_np(pthread_self(), "ut_view");
+    for(uint32_t nIdx = 0; nIdx < 10; nIdx++) {
+        RDKPerf perf ("view_job");
+        usleep(pThread->nWorkUS);
+    }
+    // Stay alive until the process report is done
+    pthread_barrier_wait(pThread->pBarrier);
+    pthread_barrier_wait(pThread->pBarrier);
+    return NULL;
+}
+
+void process_view()
+{
+    const uint32_t      nThreads = 3;
+    pthread_t           tID[nThreads];
+    ViewThread          threads[nThreads];
+    pthread_barrier_t   barrier;
+    char                szFileName[64];
+
+    snprintf(szFileName, sizeof(szFileName), "/tmp/rdkperf_view_%d.conf", (int)getpid());
+    write_config(szFileName, "process_view on\n");
+    PerfConfig::Load(szFileName);
+
+    // The same job, one thread doing twice the work of the others
+    pthread_barrier_init(&barrier, NULL, nThreads + 1);
+    for(uint32_t nIdx = 0; nIdx < nThreads; nIdx++) {
+        threads[nIdx].pBarrier  = &barrier;
+        threads[nIdx].nWorkUS   = (nIdx == 0) ? 4000 : 2000;
+        pthread_create(&tID[nIdx], NULL, view_worker_thread, &threads[nIdx]);
+    }
+    pthread_barrier_wait(&barrier);
+
+    LOG(eWarning, "UNIT_TEST (expected view_job count 30 in the process view, 3 threads, imbalance about 1.5): %s see process report\n",
+        __FUNCTION__);
+    RDKPerf_ReportProcess(getpid());
+
+    pthread_barrier_wait(&barrier);
+    for(uint32_t nIdx = 0; nIdx < nThreads; nIdx++) {
+        pthread_join(tID[nIdx], NULL);
+    }
+    pthread_barrier_destroy(&barrier);
+
+    write_config(szFileName, "\n");
+    PerfConfig::Load(szFileName);
+    unlink(szFileName);
+
+    return;
+}
+
+static void system_view_process(pid_t pID, const char* szName, uint64_t nElapsedUS)
+{
+    // Stands in for a process reporting to perfservice
+    SCOPED_LOCK();
+    PerfProcess* pProcess = new PerfProcess(pID, szName);
+    RDKPerf_InsertProcess(pID, pProcess);
+
+    PerfTree* pTree = pProcess->NewTree(1);
+    PerfNode* pNode = pTree->AddNode((char*)"ipc_call", 1, (char*)"ut_ipc", PerfRecord::TimeStamp());
+    pNode->IncrementData(nElapsedUS, 0, 0);
+    pNode->CloseNode();
+}
+
+void system_view()
+{
+    PerfSystemView::Enable(true);
+
+    // A daemon that is respawned under a new PID, and its client
+    system_view_process(0x7FFF0010, "ut_daemon", 1000);
+    RDKPerf_RemoveProcess(0x7FFF0010);
+    system_view_process(0x7FFF0011, "ut_daemon", 2000);
+    system_view_process(0x7FFF0012, "ut_browser", 3000);
+    RDKPerf_RemoveProcess(0x7FFF0011);
+    RDKPerf_RemoveProcess(0x7FFF0012);
+
+    LOG(eWarning, "UNIT_TEST (expected ut_daemon started 2 times, ipc_call count 3 and 6 ms, 3 ms each in ut_daemon and ut_browser (50%%)): %s\n",
+        __FUNCTION__);
+    PerfSystemView::ReportData();
+
+    PerfSystemView::Enable(false);
+
+    return;
+}
+
+void rolling_windows(uint32_t nCalls)
+{
+    // Synthetic clock: 10 calls of 1 ms in each of the seconds 100 to 159,
+    // one slow call of 50 ms in second 158
+    PerfWindow window;
+    for(uint32_t nSecond = 100; nSecond < 160; nSecond++) {
+        for(uint32_t nIdx = 0; nIdx < 10; nIdx++) {
+            window.Add(1000, nSecond);
+        }
+    }
+    window.Add(50000, 158);
+
+    const uint32_t windows[] = { 1, 10, 60 };
+    for(uint32_t nIdx = 0; nIdx < 3; nIdx++) {
+        WindowStats stats;
+        window.Get(windows[nIdx], 160, &stats);
+        LOG(eWarning, "UNIT_TEST (expected %u s: count %u, max %s): %s window %u s count %llu, avg %0.3lf ms, max %0.3lf ms, p50 %0.3lf ms, p99 %0.3lf ms, %0.1lf calls/s\n",
+            windows[nIdx], windows[nIdx] * 10 + (windows[nIdx] > 1 ? 1 : 0), windows[nIdx] > 1 ? "50 ms" : "1 ms",
+            __FUNCTION__, stats.nSeconds, (unsigned long long)stats.nCount, stats.nAvg / 1000.0,
+            (double)stats.nMax / 1000.0, (double)stats.nP50 / 1000.0, (double)stats.nP99 / 1000.0, stats.nRate);
+    }
+
+    // The second in progress is left out, a quiet minute empties the windows
+    WindowStats stats;
+    window.Get(10, 221, &stats);
+    LOG(eWarning, "UNIT_TEST (expected count 0 after a quiet minute): %s count %llu\n",
+        __FUNCTION__, (unsigned long long)stats.nCount);
+
+    // Real scopes, read twice through the C API.  Only names that were
+    // asked for keep windows.
+    RDKPerfWindowStats window10;
+    int nFirst = RDKPerfGetWindowStats("rolling_windows_call", 10, &window10);
+    LOG(eWarning, "UNIT_TEST (expected -1 before the first call): %s result %d\n", __FUNCTION__, nFirst);
+    for(uint32_t nIdx = 0; nIdx < nCalls; nIdx++) {
+        RDKPerf perf ("rolling_windows_call");
+        usleep(1000);
+    }
+    usleep(1100 * 1000);
+    for(uint32_t nRead = 0; nRead < 2; nRead++) {
+        int nResult = RDKPerfGetWindowStats("rolling_windows_call", 10, &window10);
+        LOG(eWarning, "UNIT_TEST (expected %u calls on both reads, -1 for remote instrumentation): %s result %d, last %u s count %llu, max %0.3lf ms, p99 %0.3lf ms\n",
+            nCalls, __FUNCTION__, nResult, window10.nSeconds, (unsigned long long)window10.nCount,
+            (double)window10.nMaxUS / 1000.0, (double)window10.nP99US / 1000.0);
+    }
+
+    return;
+}
+
+void interval_history(uint32_t nCalls)
+{
+    // 20 minutes at 10 s resolution, decrypt slows down from 4 to 6 ms
+    // avg and from 9 to 15 ms p99, parse stays the same
+    HistoryConfig config = { 10, 3600, 256 * 1024 };
+    PerfHistory   history;
+    HistoryInputs inputs;
+    uint64_t      nCount = 0, nTime = 0;
+    for(uint32_t nSnapshot = 0; nSnapshot <= 120; nSnapshot++) {
+        nCount += 100;
+        nTime  += 100 * (4000 + nSnapshot * 2000 / 120);
+        inputs["decrypt"].nTotalCount = nCount;
+        inputs["decrypt"].nTotalTime  = nTime;
+        inputs["decrypt"].nMax        = 20000;
+        inputs["decrypt"].nP99        = 9000 + nSnapshot * 6000 / 120;
+        inputs["parse"].nTotalCount   = nCount;
+        inputs["parse"].nTotalTime    = nCount * 500;
+        inputs["parse"].nMax          = 900;
+        inputs["parse"].nP99          = 800;
+        history.Snapshot(1000 + nSnapshot * 10, config, inputs);
+    }
+    LOG(eWarning, "UNIT_TEST (expected a trend for decrypt, p99 about 9 -> 15 ms, none for parse, about 3 KB instead of %u bytes raw): %s see below\n",
+        120 * 2 * (uint32_t)sizeof(HistorySample), __FUNCTION__);
+    history.ReportTrends();
+
+    std::vector<HistorySample> samples;
+    history.Get("decrypt", 60, &samples);
+    LOG(eWarning, "UNIT_TEST (expected 6 samples of 10 s, last count 100, p99 15.000 ms): %s %u samples, last %u s count %llu, p99 %0.3lf ms\n",
+        __FUNCTION__, (uint32_t)samples.size(), samples.empty() ? 0 : samples.back().nSeconds,
+        samples.empty() ? 0ULL : (unsigned long long)samples.back().nCount,
+        samples.empty() ? 0.0 : (double)samples.back().nP99 / 1000.0);
+
+    // A cap of 32 KB for 50 scopes and an hour of 1 s snapshots: the oldest
+    // chunks go and the history gets shorter
+    HistoryConfig small = { 1, 3600, 32 * 1024 };
+    PerfHistory   capped;
+    HistoryInputs many;
+    for(uint32_t nSnapshot = 0; nSnapshot <= 3600; nSnapshot++) {
+        for(uint32_t nScope = 0; nScope < 50; nScope++) {
+            char szName[32];
+            snprintf(szName, sizeof(szName), "scope_%02u", nScope);
+            HistoryInput& input = many[szName];
+            input.nTotalCount  += 1 + (nSnapshot + nScope) % 7;
+            input.nTotalTime   += 1000 * (1 + (nSnapshot * nScope) % 13);
+            input.nMax          = 13000;
+            input.nP99          = 12000;
+        }
+        capped.Snapshot(nSnapshot, small, many);
+    }
+    samples.clear();
+    capped.Get("scope_00", 3600, &samples);
+    LOG(eWarning, "UNIT_TEST (expected at most 32768 bytes, fewer than 3600 samples): %s %u bytes, %u samples of scope_00\n",
+        __FUNCTION__, (uint32_t)capped.GetBytes(), (uint32_t)samples.size());
+
+    // Real scopes between two snapshots of this process
+    HistoryConfig live = { 1, 60, 64 * 1024 };
+    time_t nNow = time(NULL);
+    {
+        RDKPerf perf ("interval_history_call");
+    }
+    RDKPerf_SnapshotProcess(getpid(), nNow, live);
+    for(uint32_t nIdx = 0; nIdx < nCalls; nIdx++) {
+        RDKPerf perf ("interval_history_call");
+    }
+    RDKPerf_SnapshotProcess(getpid(), nNow + 1, live);
+
+    RDKPerfHistorySample last[4];
+    int nSamples = RDKPerfGetHistory("interval_history_call", 60, last, 4);
+    LOG(eWarning, "UNIT_TEST (expected 1 sample of 1 s with %u calls, -1 for remote instrumentation): %s %d samples, count %llu\n",
+        nCalls, __FUNCTION__, nSamples, nSamples > 0 ? (unsigned long long)last[nSamples - 1].nCount : 0ULL);
+
+    return;
+}
+
+static uint32_t s_nStopperStackKept = 0;
+
+static void* cross_thread_stopper(void* pArg)
+{
+    // Closing the other thread's scope must not touch this thread's open scopes
+    OpenScope scopes[WATCHDOG_DEPTH];
+    RDKPerf perf ("cross_thread_stopper");
+    uint32_t nBefore = PerfWatchdog::ForThread()->Read(scopes);
+    RDKPerfStop((RDKPerfHandle)pArg);
+    if(PerfWatchdog::ForThread()->Read(scopes) == nBefore) {
+        s_nStopperStackKept++;
+    }
+    return NULL;
+}
+
+void cross_thread_stop(uint32_t nIterations)
+{
+    OpenScope scopes[WATCHDOG_DEPTH];
+    uint32_t nDepthBefore = PerfWatchdog::ForThread()->Read(scopes);
+    s_nStopperStackKept = 0;
+    for(uint32_t nIdx = 0; nIdx < nIterations; nIdx++) {
+        // Opened here, closed by another thread while a child is still open
+        RDKPerfHandle hOuter = RDKPerfStart("cross_thread_outer");
+        RDKPerfHandle hInner = RDKPerfStart("cross_thread_inner");
+        pthread_t tStopper;
+        pthread_create(&tStopper, NULL, cross_thread_stopper, hOuter);
+        pthread_join(tStopper, NULL);
+        RDKPerfStop(hInner);
+
+        // Must not see the freed records
+        RDKPerf perf ("cross_thread_after");
+        RDKPerfStop(RDKPerfStart("cross_thread_child"));
+    }
+
+    // The closed outer scopes are gone from the watchdog's view of this thread
+    RDKPerfStop(RDKPerfStart("cross_thread_last"));
+    uint32_t nDepthAfter = PerfWatchdog::ForThread()->Read(scopes);
+    size_t   nTreeDepth  = 0;
+    {
+        SCOPED_LOCK();
+        PerfProcess* pProcess = RDKPerf_FindProcess(getpid());
+        PerfTree*    pTree    = (pProcess != NULL) ? pProcess->GetTree((pthread_t)RDKPerf_GetThreadID()) : NULL;
+        nTreeDepth = (pTree != NULL) ? pTree->GetStack()->size() : 0;
+    }
+
+    LOG(eWarning, "UNIT_TEST (expected %u iterations, no open scope left, %u stopper stacks kept, watchdog depth %u, tree depth 1): %s %u iterations, innermost open scope %s, %u stopper stacks kept, watchdog depth %u, tree depth %u\n",
+        nIterations, nIterations, nDepthBefore, __FUNCTION__, nIterations,
+        PerfRecord::Current() == NULL ? "none" : PerfRecord::Current()->GetName().c_str(),
+        s_nStopperStackKept, nDepthAfter, (uint32_t)nTreeDepth);
+
+    return;
+}
+
+void replay_out_of_order(uint32_t nIterations)
+{
+    const char*     szFileName  = "/tmp/rdkperf_unit_test_order.evt";
+    const pid_t     pID         = 0x7FFF0003;  // Not a live process
+    const pthread_t tID         = (pthread_t)1;
+    uint64_t        nTimeStamp  = PerfRecord::TimeStamp();
+
+    // The outer scope is closed first, as when it is stopped on another thread
+    PerfEventLog* pLog = new PerfEventLog(szFileName);
+    for(uint32_t nIdx = 0; nIdx < nIterations; nIdx++) {
+        pLog->RecordEntry(pID, tID, "replay_thread", "order_outer", nTimeStamp, -1);
+        pLog->RecordEntry(pID, tID, "replay_thread", "order_inner", nTimeStamp + 10, -1);
+        pLog->RecordExit(pID, tID, "order_outer", 250);
+        pLog->RecordExit(pID, tID, "order_inner", 100);
+        nTimeStamp += 1000;
+    }
+    pLog->RecordExit(pID, tID, "order_stray", 100);
+    delete pLog;
+
+    PerfEventLog::Replay(szFileName);
+
+    uint64_t nOuter = 0;
+    uint64_t nInner = 0;
+    size_t   nOpen  = 0;
+    PerfProcess* pProcess = RDKPerf_FindProcess(pID);
+    PerfTree*    pTree    = (pProcess != NULL) ? pProcess->GetTree(tID) : NULL;
+    if(pTree != NULL) {
+        const std::map<std::string, PerfNode*>& children = pTree->GetRoot()->GetChildren();
+        auto it = children.find("order_outer");
+        if(it != children.end()) {
+            nOuter = it->second->GetStats()->nTotalCount;
+            auto itInner = it->second->GetChildren().find("order_inner");
+            if(itInner != it->second->GetChildren().end()) {
+                nInner = itInner->second->GetStats()->nTotalCount;
+            }
+        }
+        nOpen = pTree->GetStack()->size();
+    }
+    LOG(eWarning, "UNIT_TEST (expected %u outer, %u inner, 1 open): %s %llu outer, %llu inner, %u open\n",
+        nIterations, nIterations, __FUNCTION__, (unsigned long long)nOuter, (unsigned long long)nInner, (uint32_t)nOpen);
+
+    if(pProcess != NULL) {
+        RDKPerf_RemoveProcess(pID);
+    }
+    unlink(szFileName);
+
+    return;
+}
+
+static pid_t s_idExitedThread = 0;
+
+static void* exit_open_starter(void* pArg)
+{
+    pthread_setname_np(pthread_self(), "ut_exit_open");
+    s_idExitedThread = RDKPerf_GetThreadID();
+    *(RDKPerfHandle*)pArg = RDKPerfStart("exit_open_scope");
+    return NULL;
+}
+
+void exit_with_open_scope()
+{
+    // Started on a thread that exits, stopped here
+    RDKPerfHandle hScope = NULL;
+    pthread_t tStarter;
+    pthread_create(&tStarter, NULL, exit_open_starter, &hScope);
+    pthread_join(tStarter, NULL);
+    RDKPerfStop(hScope);
+
+    uint64_t nCount      = 0;
+    bool     bFolded     = false;
+    PerfProcess* pProcess = RDKPerf_FindProcess(getpid());
+    PerfTree*    pTree    = (pProcess != NULL) ? pProcess->GetTree((pthread_t)s_idExitedThread) : NULL;
+    if(pTree != NULL) {
+        auto it = pTree->GetRoot()->GetChildren().find("exit_open_scope");
+        if(it != pTree->GetRoot()->GetChildren().end()) {
+            nCount = it->second->GetStats()->nTotalCount;
+        }
+        // Folded into the exited threads at report time, now that the scope closed
+        pProcess->CloseInactiveThreads();
+        bFolded = pProcess->GetTree((pthread_t)s_idExitedThread) == NULL;
+    }
+    LOG(eWarning, "UNIT_TEST (expected count 1, folded yes): %s count %llu, folded %s\n",
+        __FUNCTION__, (unsigned long long)nCount, bFolded ? "yes" : "no");
+
+    return;
+}
+
+static std::atomic<PerfFlightRing*> s_pWriterRing(NULL);
+static std::atomic<bool>            s_bWriterStop(false);
+
+static void* flight_ring_writer(void* pArg)
+{
+    char            szName[FLIGHT_RECORDER_NAME];
+    PerfFlightRing* pRing = PerfFlightRecorder::ForThread();
+    uint64_t        nEvent = 0;
+
+    s_pWriterRing = pRing;
+    while(!s_bWriterStop) {
+        snprintf(szName, sizeof(szName), "event_%llu", (unsigned long long)nEvent);
+        pRing->Record(eFlightEnd, szName, nEvent, nEvent);
+        nEvent++;
+    }
+    return NULL;
+}
+
+void flight_ring_concurrent(uint32_t nFreezes)
+{
+    // Dumps are off, the rings still record
+    PerfFlightRecorder::Enable(false);
+    {
+        RDKPerf perf (__FUNCTION__);
+    }
+    FlightEvent* pEvents = new FlightEvent[FLIGHT_RECORDER_EVENTS];
+    uint32_t     nOwn    = PerfFlightRecorder::ForThread()->Freeze(pEvents);
+    bool         bOwn    = nOwn >= 2 && strcmp(pEvents[nOwn - 1].szName, __FUNCTION__) == 0;
+
+    // Another thread's ring is copied while its owner keeps writing
+    pthread_t tWriter;
+    s_bWriterStop = false;
+    pthread_create(&tWriter, NULL, flight_ring_writer, NULL);
+    while(s_pWriterRing == NULL) {
+        usleep(100);
+    }
+
+    uint32_t nTorn  = 0;
+    uint64_t nTotal = 0;
+    char     szName[FLIGHT_RECORDER_NAME];
+    for(uint32_t nIdx = 0; nIdx < nFreezes; nIdx++) {
+        uint32_t nCount = s_pWriterRing.load()->Freeze(pEvents);
+        for(uint32_t nEvent = 0; nEvent < nCount; nEvent++) {
+            const FlightEvent& event = pEvents[nEvent];
+            snprintf(szName, sizeof(szName), "event_%llu", (unsigned long long)event.nTimeStamp);
+            if(event.nDuration != event.nTimeStamp || strcmp(event.szName, szName) != 0 ||
+               (nEvent > 0 && event.nTimeStamp != pEvents[nEvent - 1].nTimeStamp + 1)) {
+                nTorn++;
+            }
+        }
+        nTotal += nCount;
+        sched_yield();
+    }
+    s_bWriterStop = true;
+    pthread_join(tWriter, NULL);
+    s_pWriterRing = NULL;
+    delete [] pEvents;
+
+    LOG(eWarning, "UNIT_TEST (expected own ring recorded yes, 0 torn): %s own ring recorded %s, %u torn in %llu events\n",
+        __FUNCTION__, bOwn ? "yes" : "no", nTorn, (unsigned long long)nTotal);
+
+    return;
+}
+
+void hw_counter_group(uint32_t nPages)
+{
+    HWCounterValues before, after;
+    PerfHWCounters* pCounters = PerfHWCounters::ForThread();
+    size_t          nPageSize = (size_t)sysconf(_SC_PAGESIZE);
+
+    // Fresh pages, each first write is a minor fault
+    pCounters->Read(&before);
+    char* pBuffer = (char*)mmap(NULL, nPages * nPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(pBuffer != MAP_FAILED) {
+        for(uint32_t nIdx = 0; nIdx < nPages; nIdx++) {
+            pBuffer[nIdx * nPageSize] = 1;
+        }
+    }
+    usleep(1000);
+    pCounters->Read(&after);
+    if(pBuffer != MAP_FAILED) {
+        munmap(pBuffer, nPages * nPageSize);
+    }
+
+    for(uint32_t nIdx = 0; nIdx < eHWCounterCount; nIdx++) {
+        if(PerfHWCounters::IsAvailable(nIdx)) {
+            LOG(eWarning, "%s: %s %llu\n", __FUNCTION__, PerfHWCounters::GetName(nIdx),
+                (unsigned long long)(after.value[nIdx] - before.value[nIdx]));
+        }
+    }
+    if(PerfHWCounters::IsAvailable(eHWPageFaults)) {
+        uint64_t nFaults = after.value[eHWPageFaults] - before.value[eHWPageFaults];
+        LOG(eWarning, "UNIT_TEST (expected page-faults >= %u): %s page-faults %llu\n",
+            nPages, __FUNCTION__, (unsigned long long)nFaults);
+    }
+    else {
+        LOG(eWarning, "UNIT_TEST (skipped, perf_event_open not available): %s\n", __FUNCTION__);
+    }
+
+    return;
+}
+
 // Unit Tests entry point
 #define DELAY_SHORT 2 * 1000 // 2s
 #define DELAY_LONG 10 * 1000 // 2s
 
+void lock_released_before_report()
+{
+    {
+        RDKPerfMutex mutex("unit_test_released");
+        std::lock_guard<RDKPerfMutex> lock(mutex);
+    }
+
+    LOG(eWarning, "UNIT_TEST (expected Lock unit_test_released Total 1 in the first report only): %s see process reports\n",
+        __FUNCTION__);
+    RDKPerf_ReportProcess(getpid());
+    RDKPerf_ReportProcess(getpid());
+
+    return;
+}
+
+typedef void (*CygHook)(void* pFunction, void* pCaller);
+
+// Only their addresses are used, exported with -rdynamic so the filters see the names
+extern "C" void autoinstr_allowed_function() {}
+extern "C" void autoinstr_denied_function() {}
+
+static uint64_t autoinstr_node_count(PerfTree* pTree, void* pFunction)
+{
+    if(pTree == NULL) {
+        return 0;
+    }
+    auto it = pTree->GetRoot()->GetChildren().find(PerfSymbols::AddressName(pFunction));
+    return (it != pTree->GetRoot()->GetChildren().end()) ? it->second->GetStats()->nTotalCount : 0;
+}
+
+// Entered by "perftest --autoinstr <fd> <calls>", a fresh process because the
+// library reads its environment once per process
+int autoinstr_child(int argc, char* argv[])
+{
+    int      fd     = (argc > 2) ? atoi(argv[2]) : -1;
+    uint32_t nCalls = (argc > 3) ? (uint32_t)atoi(argv[3]) : 0;
+    uint64_t result[3] = { 0, 0, 0 };
+
+    void* pLibrary = dlopen("librdkperf-autoinstr.so", RTLD_NOW);
+    CygHook pEnter = (pLibrary != NULL) ? (CygHook)dlsym(pLibrary, "__cyg_profile_func_enter") : NULL;
+    CygHook pExit  = (pLibrary != NULL) ? (CygHook)dlsym(pLibrary, "__cyg_profile_func_exit") : NULL;
+    if(pEnter != NULL && pExit != NULL) {
+        for(uint32_t nCall = 0; nCall < nCalls; nCall++) {
+            pEnter((void*)autoinstr_allowed_function, NULL);
+            pExit((void*)autoinstr_allowed_function, NULL);
+            pEnter((void*)autoinstr_denied_function, NULL);
+            pExit((void*)autoinstr_denied_function, NULL);
+        }
+        SCOPED_LOCK();
+        PerfProcess* pProcess = RDKPerf_FindProcess(getpid());
+        PerfTree*    pTree    = (pProcess != NULL) ? pProcess->GetTree((pthread_t)RDKPerf_GetThreadID()) : NULL;
+        result[0] = 1;
+        result[1] = autoinstr_node_count(pTree, (void*)autoinstr_allowed_function);
+        result[2] = autoinstr_node_count(pTree, (void*)autoinstr_denied_function);
+    }
+    if(fd < 0 || write(fd, result, sizeof(result)) != sizeof(result)) {
+        return 1;
+    }
+    return 0;
+}
+
+static void autoinstr_run(const char* szEnv, uint32_t nCalls)
+{
+    int fd[2];
+    if(pipe(fd) != 0) {
+        return;
+    }
+
+    // Everything the child needs is prepared before the fork
+    char szFd[16];
+    char szCalls[16];
+    snprintf(szFd, sizeof(szFd), "%d", fd[1]);
+    snprintf(szCalls, sizeof(szCalls), "%u", nCalls);
+    char* argv[] = { (char*)"perftest", (char*)"--autoinstr", szFd, szCalls, NULL };
+    std::vector<char*> env;
+    for(char** pVar = environ; *pVar != NULL; pVar++) {
+        env.push_back(*pVar);
+    }
+    if(szEnv != NULL) {
+        env.push_back((char*)szEnv);
+    }
+    env.push_back(NULL);
+
+    pid_t idChild = fork();
+    if(idChild == 0) {
+        close(fd[0]);
+        execve("/proc/self/exe", argv, env.data());
+        _exit(1);
+    }
+    close(fd[1]);
+
+    uint64_t result[3] = { 0, 0, 0 };
+    if(idChild < 0 || read(fd[0], result, sizeof(result)) != sizeof(result) || result[0] == 0) {
+        LOG(eWarning, "UNIT_TEST (skipped, librdkperf-autoinstr.so not found): %s\n", __FUNCTION__);
+    }
+    else {
+        LOG(eWarning, "UNIT_TEST: %s %s %u calls, allowed %llu, denied %llu\n", __FUNCTION__,
+            szEnv != NULL ? szEnv : "(no filter)", nCalls,
+            (unsigned long long)result[1], (unsigned long long)result[2]);
+    }
+    close(fd[0]);
+    if(idChild > 0) {
+        waitpid(idChild, NULL, 0);
+    }
+}
+
+void autoinstr_hooks(uint32_t nCalls)
+{
+    LOG(eWarning, "UNIT_TEST (expected allowed %u, denied %u; then %u, 0; %u, 0; sampled %u, %u): %s\n",
+        nCalls, nCalls, nCalls, nCalls, (nCalls + 3) / 4, (nCalls + 3) / 4, __FUNCTION__);
+    autoinstr_run(NULL, nCalls);
+    autoinstr_run("RDKPERF_AUTOINSTR_ALLOW=autoinstr_allowed", nCalls);
+    autoinstr_run("RDKPERF_AUTOINSTR_DENY=autoinstr_denied", nCalls);
+    autoinstr_run("RDKPERF_AUTOINSTR_SAMPLE=4", nCalls);
+
+    return;
+}
+
+void leaf_records(uint32_t nLeaves)
+{
+    // Dropped, no scope is open on this thread
+    PerfRecord::RecordLeaf("leaf_orphan", PerfRecord::TimeStamp(), 500);
+    {
+        RDKPerf perf ("leaf_parent");
+        for(uint32_t nIdx = 0; nIdx < nLeaves; nIdx++) {
+            PerfRecord::RecordLeaf("leaf_call", PerfRecord::TimeStamp(), 500);
+        }
+    }
+
+    uint64_t nCount  = 0;
+    uint64_t nTime   = 0;
+    bool     bOrphan = false;
+    {
+        SCOPED_LOCK();
+        PerfProcess* pProcess = RDKPerf_FindProcess(getpid());
+        PerfTree*    pTree    = (pProcess != NULL) ? pProcess->GetTree((pthread_t)RDKPerf_GetThreadID()) : NULL;
+        if(pTree != NULL) {
+            const std::map<std::string, PerfNode*>& children = pTree->GetRoot()->GetChildren();
+            bOrphan = children.find("leaf_orphan") != children.end();
+            auto it = children.find("leaf_parent");
+            if(it != children.end()) {
+                auto itLeaf = it->second->GetChildren().find("leaf_call");
+                if(itLeaf != it->second->GetChildren().end()) {
+                    nCount = itLeaf->second->GetStats()->nTotalCount;
+                    nTime  = itLeaf->second->GetStats()->nTotalTime;
+                }
+            }
+        }
+    }
+    LOG(eWarning, "UNIT_TEST (expected %u leaves, %u us, no orphan): %s %llu leaves, %llu us, orphan %s\n",
+        nLeaves, nLeaves * 500, __FUNCTION__, (unsigned long long)nCount, (unsigned long long)nTime,
+        bOrphan ? "found" : "none");
+
+    return;
+}
+
+void sched_snapshot(uint32_t timeMS)
+{
+    SchedSnapshot start, end;
+    char          szSched[256];
+    uint64_t      nStart = PerfRecord::TimeStamp();
+    {
+        // Breaches its threshold, the way a breach report snapshots it
+        RDKPerf perf (__FUNCTION__, 1000);
+        PerfSched::Snapshot(&start);
+        usleep(timeMS * 1000);
+        PerfSched::Snapshot(&end);
+    }
+    PerfSched::Format(szSched, sizeof(szSched), &start, &end, PerfRecord::TimeStamp() - nStart);
+
+    LOG(eWarning, "UNIT_TEST (expected valid, vol cs > 0): %s %s, vol cs %llu, %s\n",
+        __FUNCTION__, (start.bValid && end.bValid) ? "valid" : "invalid",
+        (unsigned long long)(end.nVoluntary - start.nVoluntary), szSched);
+
+    return;
+}
+
+void alloc_attribution(uint32_t nAllocs)
+{
+    // Counted without a scope, dropped
+    PerfRecord::NoteAlloc(32);
+    {
+        RDKPerf outer ("alloc_outer");
+        PerfRecord::NoteAlloc(64);
+        {
+            RDKPerf inner ("alloc_inner");
+            for(uint32_t nIdx = 0; nIdx < nAllocs; nIdx++) {
+                PerfRecord::NoteAlloc(128);
+            }
+            PerfRecord::NoteFree(128);
+        }
+        PerfRecord::NoteAlloc(64);
+    }
+
+    TimingStats outer = TimingStats();
+    TimingStats inner = TimingStats();
+    {
+        SCOPED_LOCK();
+        PerfProcess* pProcess = RDKPerf_FindProcess(getpid());
+        PerfTree*    pTree    = (pProcess != NULL) ? pProcess->GetTree((pthread_t)RDKPerf_GetThreadID()) : NULL;
+        if(pTree != NULL) {
+            auto it = pTree->GetRoot()->GetChildren().find("alloc_outer");
+            if(it != pTree->GetRoot()->GetChildren().end()) {
+                outer = *it->second->GetStats();
+                auto itInner = it->second->GetChildren().find("alloc_inner");
+                if(itInner != it->second->GetChildren().end()) {
+                    inner = *itInner->second->GetStats();
+                }
+            }
+        }
+    }
+    LOG(eWarning, "UNIT_TEST (expected outer 2 allocs 128 bytes, inner %u allocs %u bytes 1 free 128 bytes): %s outer %llu allocs %llu bytes, inner %llu allocs %llu bytes %llu free %llu bytes\n",
+        nAllocs, nAllocs * 128, __FUNCTION__,
+        (unsigned long long)outer.nTotalAllocs, (unsigned long long)outer.nTotalAllocBytes,
+        (unsigned long long)inner.nTotalAllocs, (unsigned long long)inner.nTotalAllocBytes,
+        (unsigned long long)inner.nIntervalFrees, (unsigned long long)inner.nIntervalFreeBytes);
+
+    return;
+}
+
 void unit_tests()
 {
     LOG(eWarning, "---------------------- Unit Tests START --------------------\n");
@@ -121,6 +1362,68 @@ void unit_tests()
     record_with_work(DELAY_SHORT);
 
     record_with_threshold(DELAY_SHORT);
+
+    record_and_replay(100);
+
+    async_spans(100);
+
+    record_with_metrics(100);
+
+    cadence_with_drops(200);
+
+    locks_with_contention(100);
+
+    ftrace_markers(10);
+
+    slowest_invocations(20);
+
+    flight_recorder(100);
+
+    breaches_rate_limited(50);
+
+    stall_watchdog(DELAY_SHORT);
+
+    runtime_control(1000);
+
+    config_reload(100);
+
+    report_schedules();
+
+    lazy_start();
+
+    thread_exit_cleanup(20);
+
+    thread_groups();
+
+    process_view();
+
+    system_view();
+
+    rolling_windows(100);
+
+    interval_history(50);
+
+    cross_thread_stop(20);
+
+    replay_out_of_order(50);
+
+    exit_with_open_scope();
+
+    flight_ring_concurrent(1000);
+
+    hw_counter_group(64);
+
+    control_dead_writer();
+
+    lock_released_before_report();
+
+    autoinstr_hooks(10);
+
+    leaf_records(20);
+
+    sched_snapshot(20);
+
+    alloc_attribution(10);
      
     LOG(eWarning, "---------------------- Unit Tests END --------------------\n");
     return;